@@ -210,14 +210,48 @@ static const uint8_t PROGMEM
 
 // clang-format on
 
+/**************************************************************************/
+/*!
+    @brief  The ST7735B init table, for Adafruit_ST77xxPanel. Only builds
+            that use it keep it in flash.
+    @return Command list in flash memory
+*/
+/**************************************************************************/
+const uint8_t *Adafruit_ST7735::initTableB(void) { return Bcmd; }
+
+/**************************************************************************/
+/*!
+    @brief  The ST7735R init tables that all tabs share, for
+            Adafruit_ST77xxPanel. Only builds that use them keep them in
+            flash.
+    @param  last  false for the first part, true for the last (gamma and
+                  display on)
+    @return Command list in flash memory
+*/
+/**************************************************************************/
+const uint8_t *Adafruit_ST7735::initTableR(bool last) {
+  return last ? Rcmd3 : Rcmd1;
+}
+
 /**************************************************************************/
 /*!
     @brief  Initialization code common to all ST7735B displays
 */
 /**************************************************************************/
 void Adafruit_ST7735::initB(void) {
+  initSetupB();
   commonInit(Bcmd);
-  setRotation(0);
+  initDone();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start initB() without waiting for it; poll() until isReady()
+*/
+/**************************************************************************/
+void Adafruit_ST7735::initBAsync(void) {
+  initSetupB();
+  commonInitAsync(Bcmd);
 }
 
 /**************************************************************************/
@@ -227,49 +261,92 @@ void Adafruit_ST7735::initB(void) {
 */
 /**************************************************************************/
 void Adafruit_ST7735::initR(uint8_t options) {
+  const uint8_t *cmdList2 = initSetupR(options);
   commonInit(Rcmd1);
+  displayInit(cmdList2);
+  displayInit(Rcmd3);
+  initDone();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start initR() without waiting for it; poll() until isReady()
+    @param  options  Tab color from adafruit purchase
+*/
+/**************************************************************************/
+void Adafruit_ST7735::initRAsync(uint8_t options) {
+  commonInitAsync(Rcmd1, initSetupR(options), Rcmd3);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Panel geometry for ST7735B displays
+*/
+/**************************************************************************/
+void Adafruit_ST7735::initSetupB(void) {
+  _gramHeight = 162;
+  tabcolor = INITR_GREENTAB; // No tab-specific handling
+}
+
+/**************************************************************************/
+/*!
+    @brief  Panel geometry for ST7735R displays
+    @param  options  Tab color from adafruit purchase
+    @return The tab's init table, to run between Rcmd1 and Rcmd3
+*/
+/**************************************************************************/
+const uint8_t *Adafruit_ST7735::initSetupR(uint8_t options) {
+  _gramHeight = 162;
+  tabcolor = options; // initDone() finishes tab-specific setup
   if (options == INITR_GREENTAB) {
-    displayInit(Rcmd2green);
     _colstart = 2;
     _rowstart = 1;
+    return Rcmd2green;
   } else if ((options == INITR_144GREENTAB) || (options == INITR_HALLOWING)) {
     _height = ST7735_TFTHEIGHT_128;
     _width = ST7735_TFTWIDTH_128;
-    displayInit(Rcmd2green144);
     _colstart = 2;
     _rowstart = 3; // For default rotation 0
+    return Rcmd2green144;
   } else if (options == INITR_MINI160x80) {
     _height = ST7735_TFTWIDTH_80;
     _width = ST7735_TFTHEIGHT_160;
-    displayInit(Rcmd2green160x80);
     _colstart = 24;
     _rowstart = 0;
+    return Rcmd2green160x80;
   } else if (options == INITR_MINI160x80_PLUGIN) {
     _height = ST7735_TFTWIDTH_80;
     _width = ST7735_TFTHEIGHT_160;
-    displayInit(Rcmd2green160x80plugin);
     _colstart = 26;
     _rowstart = 1;
+    return Rcmd2green160x80plugin;
+  }
+  // colstart, rowstart left at default '0' values
+  return Rcmd2red;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Tab-specific setup once the init tables have run
+*/
+/**************************************************************************/
+void Adafruit_ST7735::initDone(void) {
+  if (tabcolor == INITR_MINI160x80_PLUGIN) {
     invertOnCommand = ST77XX_INVOFF;
     invertOffCommand = ST77XX_INVON;
-  } else {
-    // colstart, rowstart left at default '0' values
-    displayInit(Rcmd2red);
   }
-  displayInit(Rcmd3);
 
   // Black tab, change MADCTL color filter
-  if ((options == INITR_BLACKTAB) || (options == INITR_MINI160x80)) {
+  if ((tabcolor == INITR_BLACKTAB) || (tabcolor == INITR_MINI160x80)) {
     uint8_t data = 0xC0;
-    sendCommand(ST77XX_MADCTL, &data, 1);
+    sendMADCTL(data);
   }
 
-  if (options == INITR_HALLOWING) {
+  if (tabcolor == INITR_HALLOWING) {
     // Hallowing is simply a 1.44" green tab upside-down:
     tabcolor = INITR_144GREENTAB;
     setRotation(2);
   } else {
-    tabcolor = options;
     setRotation(0);
   }
 }
@@ -380,5 +457,63 @@ void Adafruit_ST7735::setRotation(uint8_t m) {
     break;
   }
 
-  sendCommand(ST77XX_MADCTL, &madctl, 1);
+  sendMADCTL(madctl);
+}
+
+// Typical internal oscillator, Hz. Frame period in clocks is
+// (RTNA x 2 + 40) x (LINE + FPA + BPA + 2), with LINE the GRAM rows.
+#define ST7735_FOSC 850000
+
+/**************************************************************************/
+/*!
+    @brief  Set the refresh rate in normal mode as close to a target as
+            FRMCTR1 allows: 42 to 128 Hz. Among settings equally close, the
+            shortest line time wins, leaving the most porch lines (the
+            blanking period that TE covers) for tear-free writes. Call after
+            init.
+    @param  hz  Target refresh rate
+    @return Nominal frame period in microseconds, at the typical oscillator
+            frequency; Adafruit_ST77xxVSync::measure() gives the real one
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST7735::setFrameRate(uint16_t hz) {
+  if (!hz)
+    return 0;
+  uint32_t want = ST7735_FOSC / hz, bestErr = 0xFFFFFFFF;
+  uint8_t bestRtna = 0, bestPorch = 2;
+  for (uint8_t rtna = 0; rtna < 16; rtna++) {
+    uint32_t line = rtna * 2 + 40;
+    int32_t porch = (int32_t)((want + line / 2) / line) - _gramHeight - 2;
+    porch = (porch < 2) ? 2 : (porch > 126) ? 126 : porch;
+    uint32_t clocks = line * (_gramHeight + porch + 2);
+    uint32_t err = (clocks > want) ? clocks - want : want - clocks;
+    if (err < bestErr) {
+      bestErr = err;
+      bestRtna = rtna;
+      bestPorch = porch;
+    }
+  }
+  return setFrameTiming(bestRtna, bestPorch / 2, bestPorch - bestPorch / 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the refresh timing in normal mode (FRMCTR1) directly
+    @param  rtna   Line period, 40 + 2 x rtna oscillator clocks, 0-15
+    @param  front  Front porch lines, 1-63
+    @param  back   Back porch lines, 1-63
+    @return Nominal frame period in microseconds, at the typical oscillator
+            frequency
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST7735::setFrameTiming(uint8_t rtna, uint8_t front,
+                                         uint8_t back) {
+  rtna &= 0x0F;
+  front = (front & 0x3F) ? (front & 0x3F) : 1;
+  back = (back & 0x3F) ? (back & 0x3F) : 1;
+  uint8_t data[3] = {rtna, front, back};
+  fence();
+  sendCommand(ST7735_FRMCTR1, data, 3);
+  uint32_t clocks = (rtna * 2 + 40) * (_gramHeight + front + back + 2UL);
+  return (clocks * 1000 + ST7735_FOSC / 2000) / (ST7735_FOSC / 1000);
 }
@@ -61,10 +61,22 @@ public:
   // plastic overlay) are odd enough that we need to do this 'by hand':
   void initB(void);                             // for ST7735B displays
   void initR(uint8_t options = INITR_GREENTAB); // for ST7735R
+  void initBAsync(void);
+  void initRAsync(uint8_t options = INITR_GREENTAB);
+  static const uint8_t *initTableB(void);
+  static const uint8_t *initTableR(bool last);
 
   void setRotation(uint8_t m);
+  uint32_t setFrameRate(uint16_t hz);
+  uint32_t setFrameTiming(uint8_t rtna, uint8_t front, uint8_t back);
+
+protected:
+  void initDone(void);
 
 private:
+  void initSetupB(void);
+  const uint8_t *initSetupR(uint8_t options);
+
   uint8_t tabcolor;
 };
 
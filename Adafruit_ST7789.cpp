@@ -78,6 +78,15 @@ static const uint8_t PROGMEM
 
 // clang-format on
 
+/**************************************************************************/
+/*!
+    @brief  The init table, for Adafruit_ST77xxPanel. Only builds that use
+            it keep it in flash.
+    @return Command list in flash memory
+*/
+/**************************************************************************/
+const uint8_t *Adafruit_ST7789::initTable(void) { return generic_st7789; }
+
 /**************************************************************************/
 /*!
     @brief  Initialization code common to all ST7789 displays
@@ -101,7 +110,34 @@ void Adafruit_ST7789::init(uint16_t width, uint16_t height, uint8_t mode) {
   // (Might get added similarly to other display types as needed on a
   // case-by-case basis.)
 
-  commonInit(NULL);
+  initSetup(width, height);
+  commonInit(generic_st7789);
+  initDone();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start init() without waiting for it; poll() until isReady()
+    @param  width  Display width
+    @param  height Display height
+    @param  mode   SPI data mode, as for init()
+*/
+/**************************************************************************/
+void Adafruit_ST7789::initAsync(uint16_t width, uint16_t height,
+                                uint8_t mode) {
+  spiMode = mode;
+  initSetup(width, height);
+  commonInitAsync(generic_st7789);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Work out the panel's offsets in GRAM
+    @param  width  Display width
+    @param  height Display height
+*/
+/**************************************************************************/
+void Adafruit_ST7789::initSetup(uint16_t width, uint16_t height) {
   if (width == 240 && height == 240) {
     // 1.3", 1.54" displays (right justified)
     _rowstart = (320 - height);
@@ -123,11 +159,16 @@ void Adafruit_ST7789::init(uint16_t width, uint16_t height, uint8_t mode) {
 
   windowWidth = width;
   windowHeight = height;
-
-  displayInit(generic_st7789);
-  setRotation(0);
+  _gramHeight = 320;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Set the default rotation once the init table has run
+*/
+/**************************************************************************/
+void Adafruit_ST7789::initDone(void) { setRotation(0); }
+
 /**************************************************************************/
 /*!
     @brief  Set origin of (0,0) and orientation of TFT display
@@ -170,5 +211,66 @@ void Adafruit_ST7789::setRotation(uint8_t m) {
     break;
   }
 
-  sendCommand(ST77XX_MADCTL, &madctl, 1);
+  sendMADCTL(madctl);
+}
+
+// Oscillator the frame rate formula is based on, Hz. Frame period in
+// clocks is (LINE + FPA + BPA) x (250 + RTNA x 16), with LINE the GRAM rows.
+#define ST7789_FOSC 10000000
+
+/**************************************************************************/
+/*!
+    @brief  Set the refresh rate in normal mode as close to a target as
+            PORCTRL and FRCTRL2 allow: 23 to 124 Hz. Among settings equally
+            close, the shortest line time wins, leaving the most porch lines
+            (the blanking period that TE covers) for tear-free writes. Call
+            after init.
+    @param  hz  Target refresh rate
+    @return Nominal frame period in microseconds, at the typical oscillator
+            frequency; Adafruit_ST77xxVSync::measure() gives the real one
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST7789::setFrameRate(uint16_t hz) {
+  if (!hz)
+    return 0;
+  uint32_t want = ST7789_FOSC / hz, bestErr = 0xFFFFFFFF;
+  uint8_t bestRtna = 0, bestPorch = 2;
+  for (uint8_t rtna = 0; rtna < 32; rtna++) {
+    uint32_t line = 250 + rtna * 16;
+    int32_t porch = (int32_t)((want + line / 2) / line) - _gramHeight;
+    porch = (porch < 2) ? 2 : (porch > 254) ? 254 : porch;
+    uint32_t clocks = line * (_gramHeight + porch);
+    uint32_t err = (clocks > want) ? clocks - want : want - clocks;
+    if (err < bestErr) {
+      bestErr = err;
+      bestRtna = rtna;
+      bestPorch = porch;
+    }
+  }
+  return setFrameTiming(bestRtna, bestPorch / 2, bestPorch - bestPorch / 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the refresh timing in normal mode directly: porches with
+            PORCTRL, line period with FRCTRL2. Idle and partial mode
+            porches are left at their defaults.
+    @param  rtna   Line period, 250 + 16 x rtna oscillator clocks, 0-31
+    @param  front  Front porch lines, 1-127
+    @param  back   Back porch lines, 1-127
+    @return Nominal frame period in microseconds, at the typical oscillator
+            frequency
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST7789::setFrameTiming(uint8_t rtna, uint8_t front,
+                                         uint8_t back) {
+  rtna &= 0x1F;
+  front = (front & 0x7F) ? (front & 0x7F) : 1;
+  back = (back & 0x7F) ? (back & 0x7F) : 1;
+  uint8_t porch[5] = {back, front, 0x00, 0x33, 0x33};
+  fence();
+  sendCommand(ST7789_PORCTRL, porch, 5);
+  sendCommand(ST7789_FRCTRL2, &rtna, 1); // Dot inversion, as after reset
+  uint32_t clocks = (250 + rtna * 16) * (_gramHeight + front + (uint32_t)back);
+  return (clocks + ST7789_FOSC / 2000000) / (ST7789_FOSC / 1000000);
 }
@@ -3,6 +3,9 @@
 
 #include "Adafruit_ST77xx.h"
 
+#define ST7789_PORCTRL 0xB2 // Porch setting
+#define ST7789_FRCTRL2 0xC6 // Frame rate control in normal mode
+
 /// Subclass of ST77XX type display for ST7789 TFT Driver
 class Adafruit_ST7789 : public Adafruit_ST77xx {
 public:
@@ -14,13 +17,21 @@ public:
 #endif // end !ESP8266
 
   void setRotation(uint8_t m);
+  uint32_t setFrameRate(uint16_t hz);
+  uint32_t setFrameTiming(uint8_t rtna, uint8_t front, uint8_t back);
   void init(uint16_t width, uint16_t height, uint8_t spiMode = SPI_MODE0);
+  void initAsync(uint16_t width, uint16_t height, uint8_t spiMode = SPI_MODE0);
+  static const uint8_t *initTable(void);
 
 protected:
+  void initDone(void);
+
   uint8_t _colstart2 = 0, ///< Offset from the right
       _rowstart2 = 0;     ///< Offset from the bottom
 
 private:
+  void initSetup(uint16_t width, uint16_t height);
+
   uint16_t windowWidth;
   uint16_t windowHeight;
 };
@@ -70,6 +70,13 @@ static const uint8_t PROGMEM st7796s_init[] = {14, // 14 commands
                                                ST_CMD_DELAY, // Display on
                                                150};
 
+/**
+ * @brief The init table, for Adafruit_ST77xxPanel. Only builds that use it
+ * keep it in flash.
+ * @return Command list in flash memory.
+ */
+const uint8_t *Adafruit_ST7796S::initTable(void) { return st7796s_init; }
+
 /**
  * @brief Constructor with software SPI.
  * @param CS Chip select pin.
@@ -116,6 +123,37 @@ Adafruit_ST7796S::Adafruit_ST7796S(SPIClass *spiClass, int8_t CS, int8_t RS,
  */
 void Adafruit_ST7796S::init(uint16_t width, uint16_t height, uint8_t rowOffset,
                             uint8_t colOffset, ST7796S_ColorOrder colorOrder) {
+  initSetup(width, height, rowOffset, colOffset, colorOrder);
+  commonInit(st7796s_init);
+  initDone();
+}
+
+/**
+ * @brief Start init() without waiting for it; poll() until isReady().
+ * @param width Display width in pixels.
+ * @param height Display height in pixels.
+ * @param rowOffset Row offset for display.
+ * @param colOffset Column offset for display.
+ * @param colorOrder Color order (RGB or BGR).
+ */
+void Adafruit_ST7796S::initAsync(uint16_t width, uint16_t height,
+                                 uint8_t rowOffset, uint8_t colOffset,
+                                 ST7796S_ColorOrder colorOrder) {
+  initSetup(width, height, rowOffset, colOffset, colorOrder);
+  commonInitAsync(st7796s_init);
+}
+
+/**
+ * @brief Store the panel geometry.
+ * @param width Display width in pixels.
+ * @param height Display height in pixels.
+ * @param rowOffset Row offset for display.
+ * @param colOffset Column offset for display.
+ * @param colorOrder Color order (RGB or BGR).
+ */
+void Adafruit_ST7796S::initSetup(uint16_t width, uint16_t height,
+                                 uint8_t rowOffset, uint8_t colOffset,
+                                 ST7796S_ColorOrder colorOrder) {
   _width = width;
   _height = height;
   _rowstart = rowOffset;
@@ -123,9 +161,13 @@ void Adafruit_ST7796S::init(uint16_t width, uint16_t height, uint8_t rowOffset,
   _colorOrder = colorOrder;
   windowWidth = width;
   windowHeight = height;
+  _gramHeight = 480;
+}
 
-  commonInit(NULL);
-  displayInit(st7796s_init);
+/**
+ * @brief Finish init once the command table has run.
+ */
+void Adafruit_ST7796S::initDone(void) {
   invertOnCommand = ST77XX_INVOFF;
   invertOffCommand = ST77XX_INVON;
   invertDisplay(false);
@@ -174,5 +216,5 @@ void Adafruit_ST7796S::setRotation(uint8_t m) {
   }
 
   Serial.println(madctl, HEX);
-  sendCommand(ST77XX_MADCTL, &madctl, 1);
+  sendMADCTL(madctl);
 }
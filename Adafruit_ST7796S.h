@@ -63,10 +63,21 @@ public:
   void init(uint16_t width = ST7796S_TFTWIDTH,
             uint16_t height = ST7796S_TFTHEIGHT, uint8_t rowOffset = 0,
             uint8_t colOffset = 0, ST7796S_ColorOrder colorOrder = ST7796S_RGB);
+  void initAsync(uint16_t width = ST7796S_TFTWIDTH,
+                 uint16_t height = ST7796S_TFTHEIGHT, uint8_t rowOffset = 0,
+                 uint8_t colOffset = 0,
+                 ST7796S_ColorOrder colorOrder = ST7796S_RGB);
+  static const uint8_t *initTable(void);
 
   void setRotation(uint8_t r);
 
+protected:
+  void initDone(void);
+
 private:
+  void initSetup(uint16_t width, uint16_t height, uint8_t rowOffset,
+                 uint8_t colOffset, ST7796S_ColorOrder colorOrder);
+
   ST7796S_ColorOrder _colorOrder;     ///< Color order setting.
   uint16_t windowWidth, windowHeight; ///< Dimensions of the display window.
 };
@@ -23,6 +23,9 @@
  **************************************************************************/
 
 #include "Adafruit_ST77xx.h"
+#include "Adafruit_ST77xxAsync.h"
+#include "Adafruit_ST77xxConvert.h"
+#include "Adafruit_ST77xxGlyphCache.h"
 #include <limits.h>
 #if !defined(ARDUINO_STM32_FEATHER) && !defined(ARDUINO_UNOR4_WIFI)
 #if !defined(ARDUINO_UNOR4_MINIMA)
@@ -33,6 +36,20 @@
 #include <SPI.h>
 
 #define SPI_DEFAULT_FREQ 32000000 ///< Default SPI data clock frequency
+#define ST77XX_PACK_WORDS 16    ///< Staging buffer for 12/18-bit pixels, words
+#define ST77XX_RLE_WORDS 16     ///< Staging buffer for RLE literals, words
+#define ST77XX_CONVERT_WORDS 32 ///< Staging buffer for converted pixels, words
+#define ST77XX_QOI_WORDS 32     ///< Staging buffer for QOI pixels, words
+#define ST77XX_QOI_READ 32      ///< Bytes read from a Stream at a time
+#define ST77XX_QOI_RUN 8        ///< Shortest QOI run sent as a fill
+#define ST77XX_READ_WORDS 32    ///< Pixels read back per transaction
+
+// Bus statistics hooks, compiled only with ST77XX_STATS
+#if defined(ST77XX_STATS)
+#define ST77XX_STATS_ONLY(x) x
+#else
+#define ST77XX_STATS_ONLY(x)
+#endif
 
 /**************************************************************************/
 /*!
@@ -92,25 +109,176 @@ Adafruit_ST77xx::Adafruit_ST77xx(uint16_t w, uint16_t h, SPIClass *spiClass,
 /**************************************************************************/
 void Adafruit_ST77xx::displayInit(const uint8_t *addr) {
 
-  uint8_t numCommands, cmd, numArgs;
+  uint8_t numCommands;
   uint16_t ms;
+  uint32_t t;
 
   numCommands = pgm_read_byte(addr++); // Number of commands to follow
   while (numCommands--) {              // For each command...
-    cmd = pgm_read_byte(addr++);       // Read command
-    numArgs = pgm_read_byte(addr++);   // Number of args to follow
-    ms = numArgs & ST_CMD_DELAY;       // If hibit set, delay follows args
-    numArgs &= ~ST_CMD_DELAY;          // Mask out delay bit
-    sendCommand(cmd, addr, numArgs);
-    addr += numArgs;
-
-    if (ms) {
-      ms = pgm_read_byte(addr++); // Read post-command delay time (ms)
-      if (ms == 255)
-        ms = 500; // If 255, delay for 500 ms
+    ms = initCommand(addr);
+    t = micros();
+    if (ms)
       delay(ms);
-    }
+    if (fastBoot && (stepCmd == ST77XX_SLPOUT))
+      while (!boosterReady())
+        yield();
+    if (initTrace)
+      initTrace(stepCmd, stepSendUs, micros() - t);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send one command of an initialization table
+    @param  addr  Flash memory address of the command; moved past it and
+                  its arguments and delay
+    @return Milliseconds to wait before the next command: the table's delay,
+            or the datasheet minimum with fast boot
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::initCommand(const uint8_t *&addr) {
+  uint8_t cmd, numArgs, pm = 0;
+  uint16_t ms;
+  uint32_t t;
+
+  cmd = pgm_read_byte(addr++);     // Read command
+  numArgs = pgm_read_byte(addr++); // Number of args to follow
+  ms = numArgs & ST_CMD_DELAY;     // If hibit set, delay follows args
+  numArgs &= ~ST_CMD_DELAY;        // Mask out delay bit
+  if (fastBoot && (cmd == ST77XX_SWRESET))
+    pm = readPowerMode(); // A reset from sleep out takes longer
+  t = micros();
+  sendCommand(cmd, addr, numArgs);
+  trackCommand(cmd, addr);
+  stepSendUs = micros() - t;
+  stepCmd = cmd;
+  addr += numArgs;
+
+  if (ms) {
+    ms = pgm_read_byte(addr++); // Read post-command delay time (ms)
+    if (ms == 255)
+      ms = 500; // If 255, delay for 500 ms
+  }
+  // Datasheet minimums instead of the table's delays
+  return fastBoot ? bootDelay(cmd, pm) : ms;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Pulse the reset line for the datasheet minimum, instead of the
+            400 ms of the generic SPITFT reset
+    @return RDDPM read just before the reset
+*/
+/**************************************************************************/
+uint8_t Adafruit_ST77xx::pulseReset(void) {
+  pinMode(_rst, OUTPUT);
+  digitalWrite(_rst, HIGH);
+  uint8_t pm = readPowerMode(); // A reset from sleep out takes longer
+  digitalWrite(_rst, LOW);
+  delayMicroseconds(10); // Minimum reset pulse
+  digitalWrite(_rst, HIGH);
+  return pm;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reset the controller with a minimal pulse and wait only as long
+            as it needs to recover
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::fastReset(void) {
+  bootWait(ST77XX_SWRESET, pulseReset()); // Same recovery as a software reset
+}
+
+/**************************************************************************/
+/*!
+    @brief  Wait after a reset or sleep command for as long as the datasheet
+            requires. After SLPOUT the booster is polled through RDDPM when
+            status reads work, or given 120 ms when they do not; the
+            SLPOUT to SLPIN minimum is left to enableSleep(), so callers
+            can get on with other work.
+    @param  cmd  Command just sent
+    @param  pm   RDDPM read before a reset command
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::bootWait(uint8_t cmd, uint8_t pm) {
+  delay(bootDelay(cmd, pm));
+  if (cmd == ST77XX_SLPOUT)
+    while (!boosterReady())
+      yield();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Datasheet minimum wait after a command
+    @param  cmd  Command just sent
+    @param  pm   RDDPM read before a reset command
+    @return Milliseconds before the next command may be sent
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::bootDelay(uint8_t cmd, uint8_t pm) {
+  switch (cmd) {
+  case ST77XX_SWRESET:
+    // Without a trustworthy read, assume it was out of sleep
+    bootPolling = powerModeValid(pm);
+    return (bootPolling && !(pm & ST77XX_PM_SLEEPOUT)) ? ST77XX_RESET_MS
+                                                       : ST77XX_SLEEPOUT_MS;
+  case ST77XX_SLPOUT:
+  case ST77XX_SLPIN:
+    return ST77XX_SLPOUT_MS;
   }
+  return 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check whether the booster is up after SLPOUT. Without status
+            reads, that is assumed 120 ms after SLPOUT.
+    @return true once the display can be driven
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::boosterReady(void) {
+  if ((millis() - sleepOutMs) >= ST77XX_SLEEPOUT_MS)
+    return true;
+  return bootPolling &&
+         ((readPowerMode() & (ST77XX_PM_BOOSTER | ST77XX_PM_SLEEPOUT)) ==
+          (ST77XX_PM_BOOSTER | ST77XX_PM_SLEEPOUT));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read the display power mode (RDDPM). Needs MISO to be
+            connected.
+    @return ST77XX_PM_* bits
+*/
+/**************************************************************************/
+uint8_t Adafruit_ST77xx::readPowerMode(void) {
+  // Not a draw call, so this bypasses the idle mode bookkeeping
+  fence();
+  ST77XX_STATS_ONLY(busBegin());
+  Adafruit_SPITFT::startWrite();
+  SPI_DC_LOW();
+  spiWrite(ST77XX_RDDPM);
+  SPI_DC_HIGH();
+  ST77XX_STATS_ONLY(busCommand(ST77XX_RDDPM, 0, 0));
+  uint8_t pm = spiRead();
+  Adafruit_SPITFT::endWrite();
+  ST77XX_STATS_ONLY(busEnd());
+  return pm;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check that an RDDPM value could have come from the controller,
+            rather than from an unconnected MISO line
+    @param  pm  Value read
+    @return true if exactly one of normal and partial mode is set and the
+            reserved bits are clear
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::powerModeValid(uint8_t pm) {
+  return !(pm & 0x03) &&
+         (!(pm & ST77XX_PM_NORMAL) != !(pm & ST77XX_PM_PARTIAL));
 }
 
 /**************************************************************************/
@@ -121,6 +289,23 @@ void Adafruit_ST77xx::displayInit(const uint8_t *addr) {
 */
 /**************************************************************************/
 void Adafruit_ST77xx::begin(uint32_t freq) {
+  uint32_t t = micros();
+  bool fast = fastBoot && (_rst >= 0);
+  startSPI(freq, !fast);
+  if (fast)
+    fastReset();
+  if (initTrace)
+    initTrace(ST77XX_NOP, 0, micros() - t);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set up the SPI bus and pins
+    @param  freq   Desired SPI clock frequency, 0 for the default
+    @param  reset  Let SPITFT pulse the reset pin, with its long delays
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::startSPI(uint32_t freq, bool reset) {
   if (!freq) {
     freq = SPI_DEFAULT_FREQ;
   }
@@ -129,7 +314,12 @@ void Adafruit_ST77xx::begin(uint32_t freq) {
   invertOnCommand = ST77XX_INVON;
   invertOffCommand = ST77XX_INVOFF;
 
+  invalidateState(); // initSPI() may reset the controller
+  int8_t rst = _rst;
+  if (!reset)
+    _rst = -1; // Keep initSPI() from doing its own, slower reset
   initSPI(freq, spiMode);
+  _rst = rst;
 }
 
 /**************************************************************************/
@@ -146,6 +336,164 @@ void Adafruit_ST77xx::commonInit(const uint8_t *cmdList) {
   }
 }
 
+/**************************************************************************/
+/*!
+    @brief  Non-blocking counterpart of commonInit(). Sets up SPI and
+            resets the display, then returns; poll() sends the tables in
+            order as their delays expire and calls initDone() at the end.
+    @param  cmdList1  First flash memory array of commands
+    @param  cmdList2  Table to run after it, or NULL
+    @param  cmdList3  Table to run after that, or NULL
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::commonInitAsync(const uint8_t *cmdList1,
+                                      const uint8_t *cmdList2,
+                                      const uint8_t *cmdList3) {
+  uint32_t t = micros();
+  uint16_t ms = 0;
+  startSPI(0, false);
+  if (_rst >= 0) {
+    uint8_t pm = pulseReset();
+    ms = fastBoot ? bootDelay(ST77XX_SWRESET, pm) : ST77XX_SLEEPOUT_MS;
+  }
+
+  initQueue[0] = cmdList1;
+  initQueue[1] = cmdList2;
+  initQueue[2] = cmdList3;
+  initLeft = 0;
+  asyncInit = true;
+  stepCmd = ST77XX_NOP; // Traced as the bus setup and reset
+  stepSendUs = 0;
+  asyncWait(ms);
+  asyncSentUs = t;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Advance a non-blocking init or sleep change: send whatever
+            commands are due and return without waiting. Call regularly,
+            e.g. from loop(), until it returns true; draw nothing before.
+    @return true when done (same as isReady())
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::poll(void) {
+  for (;;) {
+    switch (asyncState) {
+    case ST77XX_ASYNC_WAIT:
+      if ((millis() - asyncFrom) < asyncMs)
+        return false;
+      // The stock tables' own delays stand in for the booster wait
+      asyncState = ((stepCmd == ST77XX_SLPOUT) && (fastBoot || !asyncInit))
+                       ? ST77XX_ASYNC_BOOSTER
+                       : ST77XX_ASYNC_NEXT;
+      break;
+    case ST77XX_ASYNC_BOOSTER:
+      if (!boosterReady())
+        return false;
+      asyncState = ST77XX_ASYNC_NEXT;
+      break;
+    case ST77XX_ASYNC_SLPIN:
+      if ((millis() - sleepOutMs) < ST77XX_SLEEPOUT_MS)
+        return false;
+      asyncSleep(ST77XX_SLPIN);
+      break;
+    case ST77XX_ASYNC_NEXT:
+      if (!asyncInit) {
+        asyncState = ST77XX_ASYNC_READY;
+        break;
+      }
+      if (initTrace)
+        initTrace(stepCmd, stepSendUs, micros() - asyncSentUs);
+      while (!initLeft && initQueue[0]) { // Move on to the next table
+        initCmds = initQueue[0];
+        initQueue[0] = initQueue[1];
+        initQueue[1] = initQueue[2];
+        initQueue[2] = NULL;
+        initLeft = pgm_read_byte(initCmds++);
+      }
+      if (initLeft) {
+        initLeft--;
+        asyncWait(initCommand(initCmds));
+      } else {
+        asyncInit = false;
+        asyncState = ST77XX_ASYNC_READY;
+        initDone();
+      }
+      break;
+    default:
+      return true;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Have poll() wait before the next step
+    @param  ms  Milliseconds to wait
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::asyncWait(uint16_t ms) {
+  asyncFrom = millis();
+  asyncMs = ms;
+  asyncSentUs = micros();
+  asyncState = ST77XX_ASYNC_WAIT;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send SLPIN or SLPOUT and have poll() wait for it to settle
+    @param  cmd  ST77XX_SLPIN or ST77XX_SLPOUT
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::asyncSleep(uint8_t cmd) {
+  sendToggle(cmd, shadowSleep);
+  if (cmd == ST77XX_SLPOUT)
+    sleepOutMs = millis();
+  stepCmd = cmd;
+  asyncWait(bootDelay(cmd, 0));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Begin an SPI transaction, after any asynchronous pixel push
+            still in flight has finished
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::startWrite(void) {
+  fence();
+  if (idleAuto) {
+    idleAuto = false;
+    sendToggle(ST77XX_IDMOFF, shadowIdle);
+  }
+  ST77XX_STATS_ONLY(busBegin());
+  Adafruit_SPITFT::startWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  End an SPI transaction, completing any 12-bit pixel left half
+            sent, and restart the idle timeout
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::endWrite(void) {
+  flushPacked();
+  Adafruit_SPITFT::endWrite();
+  ST77XX_STATS_ONLY(busEnd());
+  if (idleTimeout)
+    idleLastWrite = millis();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Wait for the attached Adafruit_ST77xxAsync pipeline, if any, so
+            nothing sent from here on can overtake pixels still in flight
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::fence(void) {
+  if (pipeline)
+    pipeline->wait();
+}
+
 /**************************************************************************/
 /*!
   @brief  SPI displays set an address window rectangle for blitting pixels
@@ -157,18 +505,65 @@ void Adafruit_ST77xx::commonInit(const uint8_t *cmdList) {
 /**************************************************************************/
 void Adafruit_ST77xx::setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
                                     uint16_t h) {
-  x += _xstart;
-  y += _ystart;
+  openWindow(x, y, w, h, x + _xstart, y + _ystart);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start a pixel write to a window, given both its screen and its
+            GRAM position, so subclasses that know their offsets at compile
+            time can skip adding _xstart and _ystart
+    @param  x   Top left corner x coordinate on screen
+    @param  y   Top left corner y coordinate on screen
+    @param  w   Width of window
+    @param  h   Height of window
+    @param  gx  Top left corner column in GRAM
+    @param  gy  Top left corner row in GRAM
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::openWindow(uint16_t x, uint16_t y, uint16_t w,
+                                 uint16_t h, uint16_t gx, uint16_t gy) {
+  ST77XX_STATS_ONLY(uint32_t statsFrom = micros());
+  fence();
+  flushPacked();
+  winX = x;
+  winY = y;
+  winW = w ? w : 1;
+  winCol = winRow = 0;
+  setBounds(gx, gy, w, h);
+  writeCommand(ST77XX_RAMWR); // write to RAM
+  ST77XX_STATS_ONLY(busWindow(w, h, statsFrom));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send CASET and RASET for a window, skipping whichever bounds
+            the controller already has. RAMWR or RAMRD must follow; either
+            restarts at the window's top left corner.
+    @param  x  Top left corner column in GRAM
+    @param  y  Top left corner row in GRAM
+    @param  w  Width of window
+    @param  h  Height of window
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::setBounds(uint16_t x, uint16_t y, uint16_t w,
+                                uint16_t h) {
   uint32_t xa = ((uint32_t)x << 16) | (x + w - 1);
   uint32_t ya = ((uint32_t)y << 16) | (y + h - 1);
 
-  writeCommand(ST77XX_CASET); // Column addr set
-  SPI_WRITE32(xa);
-
-  writeCommand(ST77XX_RASET); // Row addr set
-  SPI_WRITE32(ya);
+  if (!(shadowValid & ST77XX_SHADOW_CASET) || (xa != shadowCaset)) {
+    writeCommand(ST77XX_CASET); // Column addr set
+    SPI_WRITE32(xa);
+    shadowCaset = xa;
+    shadowValid |= ST77XX_SHADOW_CASET;
+  }
 
-  writeCommand(ST77XX_RAMWR); // write to RAM
+  if (!(shadowValid & ST77XX_SHADOW_RASET) || (ya != shadowRaset)) {
+    writeCommand(ST77XX_RASET); // Row addr set
+    SPI_WRITE32(ya);
+    shadowRaset = ya;
+    shadowValid |= ST77XX_SHADOW_RASET;
+  }
 }
 
 /**************************************************************************/
@@ -180,6 +575,8 @@ void Adafruit_ST77xx::setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
 void Adafruit_ST77xx::setRotation(uint8_t m) {
   uint8_t madctl = 0;
 
+  fence();
+
   rotation = m % 4; // can't be higher than 3
 
   switch (rotation) {
@@ -205,7 +602,22 @@ void Adafruit_ST77xx::setRotation(uint8_t m) {
     break;
   }
 
+  sendMADCTL(madctl);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send MADCTL, unless the controller already has this value
+    @param  madctl  Memory data access control bits (ST77XX_MADCTL_*)
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::sendMADCTL(uint8_t madctl) {
+  if ((shadowValid & ST77XX_SHADOW_MADCTL) && (madctl == shadowMadctl))
+    return;
+  fence();
   sendCommand(ST77XX_MADCTL, &madctl, 1);
+  shadowMadctl = madctl;
+  shadowValid |= ST77XX_SHADOW_MADCTL;
 }
 
 /**************************************************************************/
@@ -227,7 +639,7 @@ void Adafruit_ST77xx::setColRowStart(int8_t col, int8_t row) {
  */
 /**************************************************************************/
 void Adafruit_ST77xx::enableDisplay(boolean enable) {
-  sendCommand(enable ? ST77XX_DISPON : ST77XX_DISPOFF);
+  sendToggle(enable ? ST77XX_DISPON : ST77XX_DISPOFF, shadowDisplay);
 }
 
 /**************************************************************************/
@@ -237,18 +649,2070 @@ void Adafruit_ST77xx::enableDisplay(boolean enable) {
  */
 /**************************************************************************/
 void Adafruit_ST77xx::enableTearing(boolean enable) {
-  sendCommand(enable ? ST77XX_TEON : ST77XX_TEOFF);
+  sendToggle(enable ? ST77XX_TEON : ST77XX_TEOFF, shadowTearing);
 }
 
 /**************************************************************************/
 /*!
- @brief  Change whether sleep mode is on or off
+ @brief  Change whether sleep mode is on or off, and wait for the change to
+         settle. Sleeping within 120 ms of waking (or of a fast boot) waits
+         out the rest of that time, as the controller requires.
  @param  enable True if you want sleep mode ON, false OFF
  */
 /**************************************************************************/
 void Adafruit_ST77xx::enableSleep(boolean enable) {
-  sendCommand(enable ? ST77XX_SLPIN : ST77XX_SLPOUT);
+  uint8_t cmd = enable ? ST77XX_SLPIN : ST77XX_SLPOUT;
+  if (cmd == shadowSleep)
+    return;
+  if (enable && (shadowSleep == ST77XX_SLPOUT)) {
+    // SLPIN may not follow SLPOUT too closely
+    uint32_t awake = millis() - sleepOutMs;
+    if (awake < ST77XX_SLEEPOUT_MS)
+      delay(ST77XX_SLEEPOUT_MS - awake);
+  }
+  sendToggle(cmd, shadowSleep);
+  if (!enable)
+    sleepOutMs = millis();
+  bootWait(cmd, 0);
+}
+
+/**************************************************************************/
+/*!
+ @brief  Non-blocking enableSleep(): start the change and return. poll()
+         sends a held-back SLPIN and waits out the settle time; the display
+         takes commands again once isReady().
+ @param  enable True if you want sleep mode ON, false OFF
+ @return false if an init or sleep change is still in progress
+ */
+/**************************************************************************/
+bool Adafruit_ST77xx::enableSleepAsync(boolean enable) {
+  if (!isReady())
+    return false;
+  uint8_t cmd = enable ? ST77XX_SLPIN : ST77XX_SLPOUT;
+  if (cmd == shadowSleep)
+    return true;
+  if (enable && (shadowSleep == ST77XX_SLPOUT))
+    asyncState = ST77XX_ASYNC_SLPIN; // Sent by poll() when allowed
+  else
+    asyncSleep(cmd);
+  poll();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+ @brief  Change whether idle mode is on or off. Idle mode shows 8 colors
+         (each channel fully on or off) at a lower refresh rate, which saves
+         power on screens that don't need more.
+ @param  enable True if you want idle mode ON, false OFF
+ */
+/**************************************************************************/
+void Adafruit_ST77xx::enableIdle(boolean enable) {
+  idleAuto = false;
+  sendToggle(enable ? ST77XX_IDMON : ST77XX_IDMOFF, shadowIdle);
+  // Restart the timeout, or checkIdle() would undo this right away
+  idleLastWrite = millis();
+}
+
+/**************************************************************************/
+/*!
+ @brief  Enter idle mode automatically once nothing has been drawn for a
+         while. checkIdle() must be called regularly (e.g. from loop()) to
+         notice the timeout; the next draw call leaves idle mode again.
+ @param  ms  Milliseconds without drawing before idle mode, 0 to disable
+ */
+/**************************************************************************/
+void Adafruit_ST77xx::setIdleTimeout(uint32_t ms) {
+  idleTimeout = ms;
+  idleLastWrite = millis();
+  if (!ms && idleAuto)
+    enableIdle(false);
+}
+
+/**************************************************************************/
+/*!
+ @brief  Enter idle mode if the timeout set with setIdleTimeout() has passed
+         since the last draw call. Returns at once otherwise, so it can be
+         called on every pass of the render loop.
+ @return true if the display is in idle mode
+ */
+/**************************************************************************/
+bool Adafruit_ST77xx::checkIdle(void) {
+  if (idleTimeout && !idleAuto && (shadowIdle != ST77XX_IDMON) &&
+      ((millis() - idleLastWrite) >= idleTimeout)) {
+    sendToggle(ST77XX_IDMON, shadowIdle);
+    idleAuto = true;
+  }
+  return shadowIdle == ST77XX_IDMON;
+}
+
+/**************************************************************************/
+/*!
+ @brief  Read the line the panel is currently refreshing (GSCAN). Needs
+         MISO to be connected.
+ @return Scanline, a GRAM row. Only the rows from getVisibleScanStart()
+         on, as many as the panel has, are on the glass; the rest are
+         scanned but not shown, and values from getGramHeight() on are in
+         vertical blanking.
+ */
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::readScanline(void) {
+  // Not a draw call, so this bypasses the idle mode bookkeeping
+  fence();
+  ST77XX_STATS_ONLY(busBegin());
+  Adafruit_SPITFT::startWrite();
+  SPI_DC_LOW();
+  spiWrite(ST77XX_GSCAN);
+  SPI_DC_HIGH();
+  ST77XX_STATS_ONLY(busCommand(ST77XX_GSCAN, 0, 0));
+  uint16_t line = (uint16_t)spiRead() << 8;
+  line |= spiRead();
+  Adafruit_SPITFT::endWrite();
+  ST77XX_STATS_ONLY(busEnd());
+  return line;
+}
+
+/**************************************************************************/
+/*!
+    @brief  First scan line the panel shows. Panels smaller than the
+            controller's GRAM, like the 240x240 ST7789, are wired to a band
+            of its rows and the scan spends the rest of each frame on rows
+            nobody sees.
+    @return GRAM row, as readScanline() reports it
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::getVisibleScanStart(void) {
+  uint16_t len = (shadowMadctl & ST77XX_MADCTL_MV) ? _width : _height;
+  if (!_gramHeight || !len)
+    return 0;
+  int32_t first = scanRow(0), last = scanRow(len - 1);
+  return (first < last) ? first : last;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start reading a window of GRAM back, within a transaction:
+            CASET and RASET as needed, RAMRD, and the dummy byte the
+            controller sends before the first pixel
+    @param  x  Top left corner x coordinate
+    @param  y  Top left corner y coordinate
+    @param  w  Width of window
+    @param  h  Height of window
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::startRead(uint16_t x, uint16_t y, uint16_t w,
+                                uint16_t h) {
+  flushPacked();
+  setBounds(x + _xstart, y + _ystart, w, h);
+  writeCommand(ST77XX_RAMRD);
+  spiRead();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read pixels after startRead(). Serial reads always come in the
+            18-bit format, one byte per channel with the 6 bits left
+            aligned, whatever the color depth.
+    @param  dest  Receives 16-bit 5-6-5 pixels
+    @param  len   Pixel count
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::readPixels(uint16_t *dest, uint32_t len) {
+  while (len--) {
+    uint8_t r = spiRead(), g = spiRead(), b = spiRead();
+    *dest++ = ((uint16_t)(r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read one pixel back from the display. Needs MISO to be
+            connected.
+    @param  x  Horizontal coordinate
+    @param  y  Vertical coordinate
+    @return 16-bit 5-6-5 color, 0 off screen
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::readPixel(int16_t x, int16_t y) {
+  uint16_t color = 0;
+  readRect(x, y, 1, 1, &color);
+  return color;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read a rectangle back from the display in one RAMRD, e.g. to
+            blend over it or save it before a popup. Needs MISO to be
+            connected. Pixels from 12-bit drawing come back with their low
+            bits filled in from the high ones.
+    @param  x        Top left corner horizontal coordinate
+    @param  y        Top left corner vertical coordinate
+    @param  w        Width in pixels
+    @param  h        Height in pixels
+    @param  pcolors  Receives 16-bit 5-6-5 pixels, row by row, w * h of
+                     them; entries for pixels off screen are left as they
+                     are
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::readRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t *pcolors) {
+  int16_t x2, y2; // Lower-right coord
+  if ((w <= 0) || (h <= 0) || (x >= _width) || (y >= _height) ||
+      ((x2 = (x + w - 1)) < 0) || ((y2 = (y + h - 1)) < 0))
+    return; // Off-screen
+  int16_t saveW = w;
+  if (x < 0) { // Clip left
+    w += x;
+    pcolors -= x;
+    x = 0;
+  }
+  if (y < 0) { // Clip top
+    h += y;
+    pcolors -= (int32_t)y * saveW;
+    y = 0;
+  }
+  if (x2 >= _width)
+    w = _width - x; // Clip right
+  if (y2 >= _height)
+    h = _height - y; // Clip bottom
+
+  // Not a draw call, so this bypasses the idle mode bookkeeping
+  fence();
+  ST77XX_STATS_ONLY(busBegin());
+  Adafruit_SPITFT::startWrite();
+  startRead(x, y, w, h);
+  while (h--) {
+    readPixels(pcolors, w);
+    pcolors += saveW;
+  }
+  Adafruit_SPITFT::endWrite();
+  ST77XX_STATS_ONLY(busEnd());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Blend a color over a rectangle of what the display shows,
+            reading it back ST77XX_READ_WORDS pixels at a time, so overlays
+            need no framebuffer. Needs MISO to be connected.
+    @param  x      Top left corner horizontal coordinate
+    @param  y      Top left corner vertical coordinate
+    @param  w      Width in pixels
+    @param  h      Height in pixels
+    @param  color  16-bit 5-6-5 color to blend in
+    @param  alpha  Its opacity, 0 (none) to 255 (a plain fill)
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::blendRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                uint16_t color, uint8_t alpha) {
+  uint32_t a = (alpha + 4) >> 3; // 0-32, enough for 5-6-5
+  if (a == 32) {
+    fillRect(x, y, w, h, color);
+    return;
+  }
+  if (!a || (w <= 0) || (h <= 0) || (x >= _width) || (y >= _height) ||
+      (x + w <= 0) || (y + h <= 0))
+    return;
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > _width)
+    w = _width - x;
+  if (y + h > _height)
+    h = _height - y;
+
+  // Green, red and blue spread out in one word with room to multiply
+  uint32_t fg = (color | ((uint32_t)color << 16)) & 0x07E0F81F;
+  uint16_t buf[ST77XX_READ_WORDS];
+  startWrite();
+  for (int16_t row = y; row < y + h; row++) {
+    for (int16_t col = x; col < x + w; col += ST77XX_READ_WORDS) {
+      int16_t n = x + w - col;
+      if (n > ST77XX_READ_WORDS)
+        n = ST77XX_READ_WORDS;
+      startRead(col, row, n, 1);
+      readPixels(buf, n);
+      for (int16_t i = 0; i < n; i++) {
+        uint32_t bg = (buf[i] | ((uint32_t)buf[i] << 16)) & 0x07E0F81F;
+        bg = ((fg * a + bg * (32 - a)) >> 5) & 0x07E0F81F;
+        buf[i] = bg | (bg >> 16);
+      }
+      setAddrWindow(col, row, n, 1); // Same bounds, so just RAMWR
+      writePixels(buf, n);
+    }
+  }
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Save what the display shows as a 24-bit BMP file, read back a
+            few pixels at a time, so no framebuffer is needed. SPI
+            transactions end before each write to the output, which may
+            be a File on an SD card sharing the display's bus. Needs MISO
+            to be connected.
+    @param  out  Where the file goes, e.g. a File or Serial
+    @return false if the output took fewer bytes than it was given
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::writeBMP(Print &out) {
+  uint16_t w = _width, h = _height;
+  uint32_t rowBytes = ((uint32_t)w * 3 + 3) & ~3UL;
+  uint32_t fields[] = {54 + rowBytes * h, 0, 54, 40, w, h,
+                       0x00180001UL, // 1 plane, 24 bits per pixel
+                       0, rowBytes * h, 2835, 2835, 0, 0};
+  uint8_t buf[ST77XX_READ_WORDS * 3] = {'B', 'M'};
+  for (uint8_t i = 0; i < 13; i++)
+    for (uint8_t b = 0; b < 4; b++) // Little endian
+      buf[2 + i * 4 + b] = fields[i] >> (b * 8);
+  if (out.write(buf, 54) != 54)
+    return false;
+
+  for (int16_t y = h - 1; y >= 0; y--) { // Rows go bottom-up
+    for (int16_t x = 0; x < w; x += ST77XX_READ_WORDS) {
+      int16_t n = w - x;
+      if (n > ST77XX_READ_WORDS)
+        n = ST77XX_READ_WORDS;
+      fence();
+      ST77XX_STATS_ONLY(busBegin());
+      Adafruit_SPITFT::startWrite();
+      startRead(x, y, n, 1);
+      for (int16_t i = 0; i < n; i++) {
+        for (int8_t c = 2; c >= 0; c--) { // BMP stores blue first
+          uint8_t v = spiRead();
+          buf[i * 3 + c] = v | (v >> 6); // 6 bits widen to 8
+        }
+      }
+      Adafruit_SPITFT::endWrite();
+      ST77XX_STATS_ONLY(busEnd());
+      if (out.write(buf, n * 3) != (size_t)n * 3)
+        return false;
+    }
+    uint8_t pad = rowBytes - (uint32_t)w * 3;
+    memset(buf, 0, pad);
+    if (out.write(buf, pad) != pad)
+      return false;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Define the hardware scroll area. Scrolling runs along the
+            panel's scan direction, which is the y axis in rotations 0 and
+            2 and the x axis in rotations 1 and 3. Call after setRotation();
+            the scroll position is reset.
+    @param  top     Lines at the start of the axis that stay put
+    @param  bottom  Lines at the end of the axis that stay put
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::setScrollMargins(uint16_t top, uint16_t bottom) {
+  uint16_t len = (shadowMadctl & ST77XX_MADCTL_MV) ? _width : _height;
+  if (!_gramHeight || (top + bottom >= len))
+    return;
+
+  // Areas are in GRAM rows, which may run opposite to the display's axis
+  uint16_t vsa = len - top - bottom;
+  int32_t first = scanRow(top), last = scanRow(len - bottom - 1);
+  uint16_t tfa = (first < last) ? first : last;
+  uint16_t bfa = _gramHeight - tfa - vsa;
+  uint8_t data[6] = {(uint8_t)(tfa >> 8), (uint8_t)tfa, (uint8_t)(vsa >> 8),
+                     (uint8_t)vsa,        (uint8_t)(bfa >> 8), (uint8_t)bfa};
+  fence();
+  sendCommand(ST77XX_VSCRDEF, data, 6);
+  scrollTFA = tfa;
+  scrollVSA = vsa;
+  scrollTo(top);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Scroll so that a given line is shown first in the scroll area.
+            Only the scroll offset is sent; nothing is redrawn.
+    @param  pos  Line (in drawing coordinates along the scroll axis) to
+                 show at the start of the scroll area
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::scrollTo(uint16_t pos) {
+  if (!scrollVSA)
+    return;
+  int32_t row = scanRow(pos) - scrollTFA;
+  // With MY the area is scanned from its last GRAM row down
+  if (shadowMadctl & ST77XX_MADCTL_MY)
+    row++;
+  row = ((row % scrollVSA) + scrollVSA) % scrollVSA + scrollTFA;
+  uint8_t data[2] = {(uint8_t)(row >> 8), (uint8_t)row};
+  fence();
+  sendCommand(ST77XX_VSCSAD, data, 2);
+  scrollSSA = row;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Line currently shown first in the scroll area
+    @return Line in drawing coordinates along the scroll axis
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::getScrollPosition(void) {
+  if (!scrollVSA)
+    return 0;
+  int32_t row = scrollSSA;
+  if (shadowMadctl & ST77XX_MADCTL_MY)
+    row = scrollTFA + (row - scrollTFA + scrollVSA - 1) % scrollVSA;
+  return scanPos(row);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Scroll the area set by setScrollMargins() and clear only the
+            lines that come into view, e.g. to add a line to a text log.
+            Costs two short commands plus the cleared lines, instead of a
+            full repaint.
+    @param  lines  Lines to scroll by; positive moves the content toward
+                   the start of the axis and exposes lines at its end
+    @param  color  16-bit 5-6-5 color for the exposed lines
+    @return Drawing coordinate of the first exposed line (draw the new
+            content from there), or -1 if no scroll area is set
+*/
+/**************************************************************************/
+int16_t Adafruit_ST77xx::scrollLines(int16_t lines, uint16_t color) {
+  if (!scrollVSA)
+    return -1;
+  int32_t vsa = scrollVSA, top = scrollAreaTop();
+  if (lines > vsa)
+    lines = vsa;
+  else if (lines < -vsa)
+    lines = -vsa;
+
+  // Offsets within the area; the exposed lines are the ones leaving one
+  // edge, which reappear at the other
+  int32_t cur = getScrollPosition() - top;
+  int32_t next = ((cur + lines) % vsa + vsa) % vsa;
+  int32_t first = (lines > 0) ? cur : next;
+  int32_t n = (lines > 0) ? lines : -lines;
+  int32_t run = (n < vsa - first) ? n : vsa - first;
+  if (run)
+    scrollFill(top + first, run, color);
+  if (n > run)
+    scrollFill(top, n - run, color); // Wrapped around the end of the area
+  scrollTo(top + next);
+  return top + first;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the lines refreshed in partial mode. Like scrolling, this
+            runs along the panel's scan direction: rows in rotations 0 and
+            2, columns in rotations 1 and 3. The rest of the panel is left
+            unrefreshed (blank) while partial mode is on.
+    @param  top    First line to keep refreshing, in drawing coordinates
+    @param  lines  Number of lines to keep refreshing
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::setPartialArea(uint16_t top, uint16_t lines) {
+  uint16_t len = (shadowMadctl & ST77XX_MADCTL_MV) ? _width : _height;
+  if (!_gramHeight || !lines || (top >= len))
+    return;
+  if (lines > len - top)
+    lines = len - top;
+
+  // PTLAR takes GRAM rows, which may run opposite to the display's axis
+  int32_t first = scanRow(top), last = scanRow(top + lines - 1);
+  uint16_t start = (first < last) ? first : last;
+  uint16_t end = (first < last) ? last : first;
+  uint8_t data[4] = {(uint8_t)(start >> 8), (uint8_t)start,
+                     (uint8_t)(end >> 8), (uint8_t)end};
+  fence();
+  sendCommand(ST77XX_PTLAR, data, 4);
+}
+
+/**************************************************************************/
+/*!
+ @brief  Change whether partial mode is on or off. In partial mode only the
+         area set with setPartialArea() is refreshed, which saves power when
+         most of the panel has nothing to show. Hardware scrolling is
+         suspended in partial mode and resumes when it is turned off.
+ @param  enable True for partial mode, false for normal mode
+ */
+/**************************************************************************/
+void Adafruit_ST77xx::enablePartialMode(boolean enable) {
+  uint8_t prev = shadowPartial;
+  sendToggle(enable ? ST77XX_PTLON : ST77XX_NORON, shadowPartial);
+  // Both commands end scroll mode; writing the start address resumes it
+  if (!enable && (prev != shadowPartial) && scrollVSA) {
+    uint8_t data[2] = {(uint8_t)(scrollSSA >> 8), (uint8_t)scrollSSA};
+    sendCommand(ST77XX_VSCSAD, data, 2);
+  }
+}
+
+// GRAM row of a line along the scan axis, in drawing coordinates
+int32_t Adafruit_ST77xx::scanRow(int32_t pos) {
+  pos += (shadowMadctl & ST77XX_MADCTL_MV) ? _xstart : _ystart;
+  return (shadowMadctl & ST77XX_MADCTL_MY) ? _gramHeight - 1 - pos : pos;
+}
+
+// Inverse of scanRow()
+int32_t Adafruit_ST77xx::scanPos(int32_t row) {
+  if (shadowMadctl & ST77XX_MADCTL_MY)
+    row = _gramHeight - 1 - row;
+  return row - ((shadowMadctl & ST77XX_MADCTL_MV) ? _xstart : _ystart);
+}
+
+// First line of the scroll area, in drawing coordinates
+uint16_t Adafruit_ST77xx::scrollAreaTop(void) {
+  return scanPos((shadowMadctl & ST77XX_MADCTL_MY)
+                       ? scrollTFA + scrollVSA - 1
+                       : scrollTFA);
+}
+
+// Fill n full-width lines along the scroll axis
+void Adafruit_ST77xx::scrollFill(uint16_t pos, uint16_t n, uint16_t color) {
+  if (shadowMadctl & ST77XX_MADCTL_MV)
+    fillRect(pos, 0, n, _height, color);
+  else
+    fillRect(0, pos, _width, n, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Select the pixel format used on the bus (COLMOD). Drawing calls
+            keep taking 16-bit 5-6-5 colors and are converted as they are
+            sent. 12 bits (4-4-4) packs two pixels in three bytes, 25% less
+            bus time than 16 bits; 18 bits (6-6-6, one byte per channel)
+            costs 50% more but is what 24-bit sources need for full
+            precision. Reinitializing the display returns it to 16 bits.
+    @param  bits    12, 16 or 18
+    @param  dither  With 12 bits, hide the lost color precision with an
+                    ordered (4x4 Bayer) dither instead of truncating
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::setColorDepth(uint8_t bits, bool dither) {
+  uint8_t colmod = (bits == 12) ? 0x53 : (bits == 18) ? 0x66 : 0x55;
+  pixelDither = dither;
+  if ((shadowValid & ST77XX_SHADOW_COLMOD) && (colmod == shadowColmod))
+    return;
+  fence();
+  sendCommand(ST77XX_COLMOD, &colmod, 1);
+  shadowColmod = colmod;
+  shadowValid |= ST77XX_SHADOW_COLMOD;
+  pixelBits = (bits == 12 || bits == 18) ? bits : 16;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Bus bytes taken by a run of pixels at the current color depth
+    @param  pixels  Pixel count
+    @return Bytes, rounded up
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xx::pixelBytes(uint32_t pixels) const {
+  if (pixelBits == 12)
+    return pixels + (pixels + 1) / 2;
+  return pixels * ((pixelBits == 18) ? 3 : 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Push pixels to the current address window. At 12 and 18 bits
+            they are converted while sending, so the call blocks even when
+            block is false.
+    @param  colors     16-bit 5-6-5 pixels
+    @param  len        Pixel count
+    @param  block      If false, may return while a DMA transfer continues
+                       (16 bits only)
+    @param  bigEndian  If true, colors are stored most significant byte
+                       first
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writePixels(uint16_t *colors, uint32_t len, bool block,
+                                  bool bigEndian) {
+  if (pixelBits == 16)
+    Adafruit_SPITFT::writePixels(colors, len, block, bigEndian);
+  else
+    writePacked(colors, 0, len, bigEndian);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Push one color repeatedly to the current address window
+    @param  color  16-bit 5-6-5 color
+    @param  len    Pixel count
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeColor(uint16_t color, uint32_t len) {
+  if (pixelBits == 16)
+    Adafruit_SPITFT::writeColor(color, len);
+  else
+    writePacked(NULL, color, len, false);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a single pixel
+    @param  x      Horizontal position
+    @param  y      Vertical position
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (pixelBits == 16) {
+    Adafruit_SPITFT::drawPixel(x, y, color);
+    return;
+  }
+  startWrite();
+  writePixel(x, y, color);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a single pixel inside a startWrite()/endWrite() pair
+    @param  x      Horizontal position
+    @param  y      Vertical position
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (pixelBits == 16) {
+    Adafruit_SPITFT::writePixel(x, y, color);
+  } else if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height)) {
+    setAddrWindow(x, y, 1, 1);
+    writePacked(NULL, color, 1, false);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle inside a startWrite()/endWrite() pair, clipped
+            to the display
+    @param  x      Top left corner x coordinate
+    @param  y      Top left corner y coordinate
+    @param  w      Width in pixels, negative extends left
+    @param  h      Height in pixels, negative extends up
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeFillRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint16_t color) {
+  if (pixelBits == 16) {
+    Adafruit_SPITFT::writeFillRect(x, y, w, h, color);
+    return;
+  }
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  int16_t x2 = x + w - 1, y2 = y + h - 1;
+  if (!w || !h || (x >= _width) || (y >= _height) || (x2 < 0) || (y2 < 0))
+    return;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x2 >= _width)
+    x2 = _width - 1;
+  if (y2 >= _height)
+    y2 = _height - 1;
+  w = x2 - x + 1;
+  h = y2 - y + 1;
+  setAddrWindow(x, y, w, h);
+  writePacked(NULL, color, (uint32_t)w * h, false);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a horizontal line inside a startWrite()/endWrite() pair
+    @param  x      Left end x coordinate
+    @param  y      Row
+    @param  w      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                     uint16_t color) {
+  if (pixelBits == 16)
+    Adafruit_SPITFT::writeFastHLine(x, y, w, color);
+  else
+    writeFillRect(x, y, w, 1, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a vertical line inside a startWrite()/endWrite() pair
+    @param  x      Column
+    @param  y      Top end y coordinate
+    @param  h      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                     uint16_t color) {
+  if (pixelBits == 16)
+    Adafruit_SPITFT::writeFastVLine(x, y, h, color);
+  else
+    writeFillRect(x, y, 1, h, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle, clipped to the display
+    @param  x      Top left corner x coordinate
+    @param  y      Top left corner y coordinate
+    @param  w      Width in pixels
+    @param  h      Height in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t color) {
+  if (pixelBits == 16) {
+    Adafruit_SPITFT::fillRect(x, y, w, h, color);
+    return;
+  }
+  startWrite();
+  writeFillRect(x, y, w, h, color);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a horizontal line
+    @param  x      Left end x coordinate
+    @param  y      Row
+    @param  w      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                    uint16_t color) {
+  if (pixelBits == 16)
+    Adafruit_SPITFT::drawFastHLine(x, y, w, color);
+  else
+    fillRect(x, y, w, 1, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a vertical line
+    @param  x      Column
+    @param  y      Top end y coordinate
+    @param  h      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                    uint16_t color) {
+  if (pixelBits == 16)
+    Adafruit_SPITFT::drawFastVLine(x, y, h, color);
+  else
+    fillRect(x, y, 1, h, color);
+}
+
+// Filled shapes as horizontal spans. Spans with the same ends on
+// consecutive rows are merged into one rectangle, so a run of equal rows
+// costs a single address window.
+struct SpanRun {
+  Adafruit_ST77xx &tft;
+  uint16_t color;
+  int16_t a, b, y, h; // Pending rectangle: columns a to b, rows y to y+h-1
+
+  void add(int16_t x0, int16_t x1, int16_t row) {
+    if (h && (x0 == a) && (x1 == b) && (row == y + h)) {
+      h++;
+      return;
+    }
+    flush();
+    a = x0;
+    b = x1;
+    y = row;
+    h = 1;
+  }
+  void flush(void) {
+    if (h)
+      tft.writeFillRect(a, y, b - a + 1, h, color);
+    h = 0;
+  }
+};
+
+// A circle of radius r stretched by dx columns and dy rows: corner centers
+// at (x0, y0) and (x0 + dx, y0 + dy). Runs the midpoint loop of
+// Adafruit_GFX::fillCircleHelper(), whose shape is symmetric about the
+// diagonal, so the column heights it finds are the row half-widths here
+// and the pixels are the same. Each row above the middle is sent right
+// before its mirror image below, which has the same columns, so the
+// second window needs no CASET.
+struct RoundSpans {
+  Adafruit_ST77xx &tft;
+  int16_t x0, y0, dx, dy;
+  uint16_t color;
+
+  // Rows from..to above and below the middle, half-width w; row 0 is the
+  // middle band itself
+  void rows(int16_t from, int16_t to, int16_t w) {
+    int16_t span = 2 * w + dx + 1;
+    if (!from) {
+      tft.writeFillRect(x0 - w, y0 - to, span, 2 * to + dy + 1, color);
+    } else {
+      tft.writeFillRect(x0 - w, y0 - to, span, to - from + 1, color);
+      tft.writeFillRect(x0 - w, y0 + dy + from, span, to - from + 1, color);
+    }
+  }
+
+  void fill(int16_t r) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x,
+            py = y;
+    int16_t runFrom = 0, runTo = 0, runW = r; // Rows of equal half-width
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (x < (y + 1)) {
+        if ((y == runW) && (x == runTo + 1)) {
+          runTo = x;
+        } else {
+          rows(runFrom, runTo, runW);
+          runFrom = runTo = x;
+          runW = y;
+        }
+      }
+      if (y != py) {
+        rows(py, py, px);
+        py = y;
+      }
+      px = x;
+    }
+    rows(runFrom, runTo, runW);
+  }
+};
+
+static inline void swapInt16(int16_t &a, int16_t &b) {
+  int16_t t = a;
+  a = b;
+  b = t;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a filled circle as horizontal spans in one transaction.
+            Same pixels as Adafruit_GFX::fillCircle(), in about 40% fewer
+            address windows.
+    @param  x0     Center x coordinate
+    @param  y0     Center y coordinate
+    @param  r      Radius in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::fillCircle(int16_t x0, int16_t y0, int16_t r,
+                                 uint16_t color) {
+  if (r < 0)
+    return;
+  RoundSpans round = {*this, x0, y0, 0, 0, color};
+  startWrite();
+  round.fill(r);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a filled rounded rectangle as horizontal spans in one
+            transaction: the straight middle part is a single window.
+            Same pixels as Adafruit_GFX::fillRoundRect().
+    @param  x      Top left corner x coordinate
+    @param  y      Top left corner y coordinate
+    @param  w      Width in pixels
+    @param  h      Height in pixels
+    @param  r      Corner radius in pixels, at most half the shorter side
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::fillRoundRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, int16_t r, uint16_t color) {
+  if ((w <= 0) || (h <= 0))
+    return;
+  int16_t maxRadius = ((w < h) ? w : h) / 2;
+  if (r > maxRadius)
+    r = maxRadius;
+  if (r < 0)
+    r = 0;
+  int16_t dx = w - 2 * r - 1, dy = h - 2 * r - 1;
+  RoundSpans round = {*this, (int16_t)(x + r), (int16_t)(y + r), dx, dy,
+                      color};
+  startWrite();
+  round.fill(r);
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a filled triangle as horizontal spans in one transaction,
+            skipping rows off screen and merging rows with the same ends
+            (steep sides) into one window. Same pixels as
+            Adafruit_GFX::fillTriangle().
+    @param  x0     First corner x coordinate
+    @param  y0     First corner y coordinate
+    @param  x1     Second corner x coordinate
+    @param  y1     Second corner y coordinate
+    @param  x2     Third corner x coordinate
+    @param  y2     Third corner y coordinate
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::fillTriangle(int16_t x0, int16_t y0, int16_t x1,
+                                   int16_t y1, int16_t x2, int16_t y2,
+                                   uint16_t color) {
+  // Sort corners by row (y0 <= y1 <= y2)
+  if (y0 > y1) {
+    swapInt16(y0, y1);
+    swapInt16(x0, x1);
+  }
+  if (y1 > y2) {
+    swapInt16(y2, y1);
+    swapInt16(x2, x1);
+  }
+  if (y0 > y1) {
+    swapInt16(y0, y1);
+    swapInt16(x0, x1);
+  }
+  if ((y2 < 0) || (y0 >= _height))
+    return;
+
+  SpanRun run = {*this, color, 0, 0, 0, 0};
+  startWrite();
+  if (y0 == y2) { // All on one row; same ends as Adafruit_GFX picks
+    int16_t a = x0, b = x0;
+    if (x1 < a)
+      a = x1;
+    else if (x1 > b)
+      b = x1;
+    if (x2 < a)
+      a = x2;
+    else if (x2 > b)
+      b = x2;
+    run.add(a, b, y0);
+  } else {
+    // Same integer steps as Adafruit_GFX, started at the first visible row
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0,
+            dx12 = x2 - x1, dy12 = y2 - y1;
+    int16_t last = (y1 == y2) ? y1 : y1 - 1; // Rows of the upper part
+    int16_t yEnd = (y2 < _height) ? y2 : _height - 1, y = y0;
+    if (y < 0)
+      y = 0;
+    if (y <= last) {
+      int32_t sa = (int32_t)dx01 * (y - y0), sb = (int32_t)dx02 * (y - y0);
+      int16_t stop = (last < yEnd) ? last : yEnd;
+      for (; y <= stop; y++) {
+        int16_t a = x0 + sa / dy01, b = x0 + sb / dy02;
+        sa += dx01;
+        sb += dx02;
+        if (a > b)
+          swapInt16(a, b);
+        run.add(a, b, y);
+      }
+      y = last + 1;
+    }
+    if (y < 0)
+      y = 0;
+    int32_t sa = (int32_t)dx12 * (y - y1), sb = (int32_t)dx02 * (y - y0);
+    for (; y <= yEnd; y++) {
+      int16_t a = x1 + sa / dy12, b = x0 + sb / dy02;
+      sa += dx12;
+      sb += dx02;
+      if (a > b)
+        swapInt16(a, b);
+      run.add(a, b, y);
+    }
+  }
+  run.flush();
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a 16-bit image from RAM, converted to the color depth
+    @param  x        Top left corner horizontal coordinate
+    @param  y        Top left corner vertical coordinate
+    @param  pcolors  16-bit 5-6-5 pixels, row by row
+    @param  w        Width of the image in pixels
+    @param  h        Height of the image in pixels
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors,
+                                    int16_t w, int16_t h) {
+  if (pixelBits == 16) {
+    Adafruit_SPITFT::drawRGBBitmap(x, y, pcolors, w, h);
+    return;
+  }
+
+  int16_t x2, y2; // Lower-right coord
+  if ((x >= _width) || (y >= _height) || ((x2 = (x + w - 1)) < 0) ||
+      ((y2 = (y + h - 1)) < 0))
+    return; // Off-screen
+  int16_t bx1 = 0, by1 = 0, saveW = w; // Clipped top-left within bitmap
+  if (x < 0) {                         // Clip left
+    w += x;
+    bx1 = -x;
+    x = 0;
+  }
+  if (y < 0) { // Clip top
+    h += y;
+    by1 = -y;
+    y = 0;
+  }
+  if (x2 >= _width)
+    w = _width - x; // Clip right
+  if (y2 >= _height)
+    h = _height - y; // Clip bottom
+
+  pcolors += by1 * saveW + bx1; // Offset bitmap ptr to clipped top-left
+  startWrite();
+  setAddrWindow(x, y, w, h); // Clipped area
+  while (h--) {              // For each (clipped) scanline...
+    writePixels(pcolors, w); // Push one (clipped) row
+    pcolors += saveW;        // Advance pointer by one full (unclipped) line
+  }
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a run-length encoded 16-bit image from PROGMEM, as made
+            by the st77xx_rleencode host tool. The address window is set
+            once and runs are sent as fills. The stream is a series of
+            packets, each starting with a count byte:
+            0x01-0x7F: that many literal pixels follow;
+            0x81-0xFF: one pixel follows, repeated (count & 0x7F) times;
+            0x00, 0x80: as above, with the count in the next two bytes.
+            Counts and pixels (5-6-5) are stored most significant byte
+            first, and rows follow each other without a break.
+    @param  x       Top left corner horizontal coordinate
+    @param  y       Top left corner vertical coordinate
+    @param  bitmap  Encoded image in flash memory
+    @param  w       Width of the image in pixels
+    @param  h       Height of the image in pixels
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawRLEBitmap(int16_t x, int16_t y,
+                                    const uint8_t bitmap[], int16_t w,
+                                    int16_t h) {
+  // Visible part of the image, in image coordinates
+  int16_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int16_t x1 = ((x + w) > _width) ? _width - x : w,
+          y1 = ((y + h) > _height) ? _height - y : h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return;
+  // Whole rows visible: a packet can be sent without splitting it per row
+  bool wholeRows = !x0 && (x1 == w);
+  uint32_t i = 0, end = (uint32_t)y1 * w, first = (uint32_t)y0 * w;
+  int16_t col = 0, row = 0;
+  uint16_t words[ST77XX_RLE_WORDS], color = 0;
+  uint8_t *buf = (uint8_t *)words;
+
+  startWrite();
+  setAddrWindow(x + x0, y + y0, x1 - x0, y1 - y0);
+  while (i < end) {
+    uint8_t c = pgm_read_byte(bitmap++);
+    uint16_t n = c & 0x7F;
+    if (!n) {
+      n = (pgm_read_byte(bitmap) << 8) | pgm_read_byte(bitmap + 1);
+      bitmap += 2;
+    }
+    bool run = c & 0x80;
+    if (run) {
+      color = (pgm_read_byte(bitmap) << 8) | pgm_read_byte(bitmap + 1);
+      bitmap += 2;
+    }
+
+    while (n && (i < end)) {
+      // Piece of the packet to handle next, and its visible pixels
+      uint16_t span, skip = 0, count = 0;
+      if (wholeRows) {
+        span = ((end - i) < n) ? end - i : n;
+        if (i + span > first) {
+          skip = (i < first) ? first - i : 0;
+          count = span - skip;
+        }
+      } else {
+        span = ((w - col) < n) ? w - col : n;
+        if ((row >= y0) && (col + span > x0) && (col < x1)) {
+          skip = (col < x0) ? x0 - col : 0;
+          count = (((col + span) < x1) ? col + span : x1) - col - skip;
+        }
+        col += span;
+        if (col == w) {
+          col = 0;
+          row++;
+        }
+      }
+
+      if (run) {
+        if (count)
+          writeColor(color, count);
+      } else {
+        const uint8_t *src = bitmap + 2 * skip;
+        while (count) { // Stage literals in RAM, bytes in bus order
+          uint16_t m = (count < ST77XX_RLE_WORDS) ? count : ST77XX_RLE_WORDS;
+          for (uint16_t b = 0; b < 2 * m; b++)
+            buf[b] = pgm_read_byte(src++);
+          writePixels(words, m, true, true);
+          count -= m;
+        }
+        bitmap += 2 * span;
+      }
+      i += span;
+      n -= span;
+    }
+  }
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert 8-bit RGB pixels to 5-6-5 and push them to the current
+            address window, inside a startWrite()/endWrite() pair. They are
+            converted a few at a time into a buffer in bus byte order, so
+            rows of any length can be streamed, e.g. from a camera.
+    @param  rgb     3 bytes per pixel: red, green, blue
+    @param  len     Pixel count
+    @param  dither  If true, ordered dithering instead of truncation. The
+                    pattern follows the pixels' place in the window. Has
+                    no effect on 12-bit pixels already dithered by
+                    setColorDepth().
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeRGB888(const uint8_t *rgb, uint32_t len,
+                                  bool dither) {
+  uint16_t words[ST77XX_CONVERT_WORDS];
+  // 12-bit pixels dithered by writePacked() are not dithered twice
+  if ((pixelBits == 12) && pixelDither)
+    dither = false;
+  while (len) {
+    uint32_t n = (len < ST77XX_CONVERT_WORDS) ? len : ST77XX_CONVERT_WORDS;
+    if (dither) {
+      if (n > (uint32_t)(winW - winCol))
+        n = winW - winCol; // One row at a time
+      Adafruit_ST77xxConvert::rgb888Dither(words, rgb, n, winX + winCol,
+                                           winY + winRow, true);
+      if ((winCol += n) >= winW) {
+        winCol = 0;
+        winRow++;
+      }
+    } else {
+      Adafruit_ST77xxConvert::rgb888(words, rgb, n, true);
+    }
+    writePixels(words, n, true, true);
+    rgb += 3 * n;
+    len -= n;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert YUV 4:2:2 pixels (YUYV byte order) to 5-6-5 and push
+            them to the current address window, inside a
+            startWrite()/endWrite() pair
+    @param  yuv  4 bytes per pixel pair: Y0, U, Y1, V
+    @param  len  Pixel count, even except at the end of a line
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeYUV422(const uint8_t *yuv, uint32_t len) {
+  uint16_t words[ST77XX_CONVERT_WORDS];
+  while (len) {
+    uint32_t n = (len < ST77XX_CONVERT_WORDS) ? len : ST77XX_CONVERT_WORDS;
+    Adafruit_ST77xxConvert::yuv422(words, yuv, n, true);
+    writePixels(words, n, true, true);
+    yuv += 2 * n;
+    len -= n;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw an 8-bit RGB image from RAM, converted to the color depth
+    @param  x       Top left corner horizontal coordinate
+    @param  y       Top left corner vertical coordinate
+    @param  rgb     3 bytes per pixel: red, green, blue; row by row
+    @param  w       Width of the image in pixels
+    @param  h       Height of the image in pixels
+    @param  dither  If true, ordered dithering instead of truncation
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawRGB888Bitmap(int16_t x, int16_t y,
+                                       const uint8_t *rgb, int16_t w,
+                                       int16_t h, bool dither) {
+  // Visible part of the image, in image coordinates
+  int16_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int16_t x1 = ((x + w) > _width) ? _width - x : w,
+          y1 = ((y + h) > _height) ? _height - y : h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return;
+
+  startWrite();
+  setAddrWindow(x + x0, y + y0, x1 - x0, y1 - y0);
+  if (!x0 && (x1 == w)) { // Whole rows: one stream
+    writeRGB888(rgb + 3 * (int32_t)y0 * w, (uint32_t)(y1 - y0) * w, dither);
+  } else {
+    for (int16_t row = y0; row < y1; row++)
+      writeRGB888(rgb + 3 * ((int32_t)row * w + x0), x1 - x0, dither);
+  }
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a YUV 4:2:2 image (YUYV byte order) from RAM, such as a
+            camera frame, converted to the color depth
+    @param  x    Top left corner horizontal coordinate
+    @param  y    Top left corner vertical coordinate
+    @param  yuv  4 bytes per pixel pair: Y0, U, Y1, V; row by row
+    @param  w    Width of the image in pixels, even
+    @param  h    Height of the image in pixels
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawYUV422Bitmap(int16_t x, int16_t y,
+                                       const uint8_t *yuv, int16_t w,
+                                       int16_t h) {
+  int16_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int16_t x1 = ((x + w) > _width) ? _width - x : w,
+          y1 = ((y + h) > _height) ? _height - y : h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return;
+
+  startWrite();
+  setAddrWindow(x + x0, y + y0, x1 - x0, y1 - y0);
+  if (!x0 && (x1 == w)) {
+    writeYUV422(yuv + 2 * (int32_t)y0 * w, (uint32_t)(y1 - y0) * w);
+  } else {
+    for (int16_t row = y0; row < y1; row++) {
+      const uint8_t *src = yuv + 2 * ((int32_t)row * w + (x0 & ~1));
+      int16_t n = x1 - x0;
+      if (x0 & 1) { // Clipped inside a pair: its second pixel only
+        uint16_t pair[2];
+        Adafruit_ST77xxConvert::yuv422(pair, src, 2, true);
+        writePixels(pair + 1, 1, true, true);
+        src += 4;
+        n--;
+      }
+      writeYUV422(src, n);
+    }
+  }
+  endWrite();
+}
+
+// QOI ("Quite OK Image") decoding. Sources hand out one byte at a time and
+// set eof once they run dry, reading 0 from then on.
+
+struct QOIOutput;
+
+// Image in flash memory
+struct QOIFlashSource {
+  const uint8_t *p;
+  uint32_t left;
+  bool eof;
+  void attach(QOIOutput *) {} // Reading never touches the bus
+  uint8_t read(void) {
+    if (!left) {
+      eof = true;
+      return 0;
+    }
+    left--;
+    return pgm_read_byte(p++);
+  }
+};
+
+// Image read from a Stream (e.g. an SD card File) in small blocks. The
+// output's transaction is ended before each block, as the stream may be
+// a device on the display's bus.
+struct QOIStreamSource {
+  Stream &stream;
+  QOIOutput *out;
+  uint8_t buf[ST77XX_QOI_READ], pos, n;
+  bool eof;
+  void attach(QOIOutput *o) { out = o; }
+  uint8_t read(void);
+};
+
+// Decoded pixels in image order, clipped to the visible columns and rows
+// and sent to the address window: short spans are staged in bus byte
+// order, long runs of one color go out as fills. The transaction and the
+// window open at the first visible pixel; after suspend() they reopen
+// where the pixels left off, with a window for the rest of that row if
+// it stopped partway through.
+enum { QOI_CLOSED, QOI_ROW, QOI_REST }; // What the open window covers
+
+struct QOIOutput {
+  Adafruit_ST77xx &tft;
+  int16_t x, y; // Image position on screen
+  uint32_t w;
+  int16_t x0, x1, y0, y1; // Visible part, in image coordinates
+  uint32_t col, row;
+  uint8_t n;
+  uint8_t open; // QOI_ROW: rest of row rowOpen; QOI_REST: to the end
+  uint32_t rowOpen;
+  uint16_t words[ST77XX_QOI_WORDS];
+
+  void put(uint16_t color, uint32_t count) {
+    while (count) {
+      uint32_t span = ((w - col) < count) ? w - col : count;
+      if ((row >= (uint32_t)y0) && (col + span > (uint32_t)x0) &&
+          (col < (uint32_t)x1)) {
+        uint32_t from = (col < (uint32_t)x0) ? x0 : col,
+                 to = ((col + span) < (uint32_t)x1) ? col + span : x1;
+        uint32_t visible = to - from;
+        window(from);
+        if (visible >= ST77XX_QOI_RUN) {
+          flush();
+          tft.writeColor(color, visible);
+        } else {
+          uint16_t be = (color >> 8) | (color << 8);
+          while (visible--) {
+            words[n++] = be;
+            if (n == ST77XX_QOI_WORDS)
+              flush();
+          }
+        }
+      }
+      col += span;
+      if (col == w) {
+        col = 0;
+        row++;
+      }
+      count -= span;
+    }
+  }
+
+  // Make sure the pixel at column from of the current row is next in GRAM
+  void window(uint32_t from) {
+    if (open == QOI_REST)
+      return;
+    if (open == QOI_ROW) {
+      if (row == rowOpen)
+        return;
+      flush(); // Row done; the rest of the image below it
+    } else {
+      tft.startWrite();
+    }
+    if (from > (uint32_t)x0) {
+      tft.setAddrWindow(x + from, y + row, x1 - from, 1);
+      open = QOI_ROW;
+      rowOpen = row;
+    } else {
+      tft.setAddrWindow(x + x0, y + row, x1 - x0, y1 - row);
+      open = QOI_REST;
+    }
+  }
+
+  // End the transaction; the next visible pixel reopens it
+  void suspend(void) {
+    if (open == QOI_CLOSED)
+      return;
+    flush();
+    tft.endWrite();
+    open = QOI_CLOSED;
+  }
+
+  void flush(void) {
+    if (n)
+      tft.writePixels(words, n, true, true);
+    n = 0;
+  }
+};
+
+inline uint8_t QOIStreamSource::read(void) {
+  if (pos == n) {
+    if (out)
+      out->suspend();
+    n = stream.readBytes(buf, sizeof(buf));
+    pos = 0;
+    if (!n) {
+      eof = true;
+      return 0;
+    }
+  }
+  return buf[pos++];
+}
+
+// Check a QOI header, returning the image size
+static bool qoiHeader(const uint8_t h[14], uint32_t &w, uint32_t &ht) {
+  if ((h[0] != 'q') || (h[1] != 'o') || (h[2] != 'i') || (h[3] != 'f'))
+    return false;
+  w = ((uint32_t)h[4] << 24) | ((uint32_t)h[5] << 16) | (h[6] << 8) | h[7];
+  ht = ((uint32_t)h[8] << 24) | ((uint32_t)h[9] << 16) | (h[10] << 8) | h[11];
+  return w && ht && (w <= 0x7FFF) && (ht <= 0x7FFF);
+}
+
+// Decode an image from src into tft at (x, y). Only the 64-entry color
+// index and the current pixel are kept; decoding stops after the last
+// visible row.
+template <class Source>
+static bool decodeQOI(Adafruit_ST77xx &tft, int16_t x, int16_t y,
+                      Source &src) {
+  uint8_t h[14];
+  for (uint8_t i = 0; i < sizeof(h); i++)
+    h[i] = src.read();
+  uint32_t w, ht;
+  if (src.eof || !qoiHeader(h, w, ht))
+    return false;
+
+  // Visible part of the image, in image coordinates
+  int32_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int32_t x1 = ((x + (int32_t)w) > tft.width()) ? tft.width() - x : w,
+          y1 = ((y + (int32_t)ht) > tft.height()) ? tft.height() - y : ht;
+  if ((x0 >= x1) || (y0 >= y1))
+    return true; // Valid image, nothing to draw
+
+  QOIOutput out = {tft, x, y, w, (int16_t)x0, (int16_t)x1, (int16_t)y0,
+                   (int16_t)y1, 0, 0, 0, QOI_CLOSED, 0, {0}};
+  src.attach(&out);
+  uint8_t index[64][4], px[4] = {0, 0, 0, 255};
+  memset(index, 0, sizeof(index));
+  uint32_t left = (uint32_t)y1 * w; // Pixels to decode
+  while (left) {
+    uint8_t b = src.read();
+    uint32_t run = 1;
+    if (b == 0xFE) { // QOI_OP_RGB
+      px[0] = src.read();
+      px[1] = src.read();
+      px[2] = src.read();
+    } else if (b == 0xFF) { // QOI_OP_RGBA; alpha is kept for the index only
+      px[0] = src.read();
+      px[1] = src.read();
+      px[2] = src.read();
+      px[3] = src.read();
+    } else if ((b & 0xC0) == 0x00) { // QOI_OP_INDEX
+      memcpy(px, index[b], 4);
+    } else if ((b & 0xC0) == 0x40) { // QOI_OP_DIFF
+      px[0] += ((b >> 4) & 3) - 2;
+      px[1] += ((b >> 2) & 3) - 2;
+      px[2] += (b & 3) - 2;
+    } else if ((b & 0xC0) == 0x80) { // QOI_OP_LUMA
+      uint8_t b2 = src.read();
+      int8_t dg = (b & 0x3F) - 32;
+      px[0] += dg - 8 + (b2 >> 4);
+      px[1] += dg;
+      px[2] += dg - 8 + (b2 & 0x0F);
+    } else { // QOI_OP_RUN
+      run = (b & 0x3F) + 1;
+    }
+    if (src.eof)
+      break;
+    memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63], px,
+           4);
+    if (run > left)
+      run = left;
+    out.put(((uint16_t)(px[0] & 0xF8) << 8) | ((px[1] & 0xFC) << 3) |
+                (px[2] >> 3),
+            run);
+    left -= run;
+  }
+  out.suspend();
+  src.attach(NULL);
+  return !left;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a QOI (Quite OK Image format, qoiformat.org) image from
+            flash memory. Lossless, it usually takes less than half the
+            space of a raw RGB565 array for photos, and decodes with a few
+            hundred bytes of RAM. The address window is set once; colors
+            are truncated to 5-6-5 and alpha is ignored.
+    @param  x    Top left corner horizontal coordinate
+    @param  y    Top left corner vertical coordinate
+    @param  qoi  The .qoi file's bytes, in PROGMEM
+    @param  len  Their count
+    @return false if the data is not a QOI image or ends early
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::drawQOI(int16_t x, int16_t y, const uint8_t qoi[],
+                              uint32_t len) {
+  QOIFlashSource src = {qoi, len, false};
+  return decodeQOI(*this, x, y, src);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a QOI image read from a Stream, such as a File on an SD
+            card. The stream is read in blocks of ST77XX_QOI_READ bytes, so
+            up to that many bytes past the image may be consumed. The SPI
+            transaction ends before each block is read, so the card may
+            share the display's bus; the address window is set again where
+            drawing left off.
+    @param  x       Top left corner horizontal coordinate
+    @param  y       Top left corner vertical coordinate
+    @param  stream  Source, positioned at the start of the .qoi data
+    @return false if the data is not a QOI image or ends early
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::drawQOI(int16_t x, int16_t y, Stream &stream) {
+  QOIStreamSource src = {stream, NULL, {0}, 0, 0, false};
+  return decodeQOI(*this, x, y, src);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read the size of a QOI image in flash memory, e.g. to center it
+    @param  qoi  The .qoi file's bytes, in PROGMEM
+    @param  w    Receives the width in pixels
+    @param  h    Receives the height in pixels
+    @return false if the data is not a QOI image
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::getQOISize(const uint8_t qoi[], uint16_t *w,
+                                 uint16_t *h) {
+  uint8_t hdr[14];
+  uint32_t qw, qh;
+  for (uint8_t i = 0; i < sizeof(hdr); i++)
+    hdr[i] = pgm_read_byte(&qoi[i]);
+  if (!qoiHeader(hdr, qw, qh))
+    return false;
+  *w = qw;
+  *h = qh;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Print a character at the cursor, as Adafruit_GFX::write() does,
+            drawing classic font characters with drawChar() below so they
+            can come from the glyph cache
+    @param  c  Character
+    @return 1
+*/
+/**************************************************************************/
+size_t Adafruit_ST77xx::write(uint8_t c) {
+  if (!glyphCache || gfxFont)
+    return Adafruit_GFX::write(c);
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+  } else if (c != '\r') {
+    if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    }
+    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+             textsize_y);
+    cursor_x += textsize_x * 6;
+  }
+  return 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a single character
+    @param  x      Top left corner horizontal coordinate
+    @param  y      Top left corner vertical coordinate
+    @param  c      Character
+    @param  color  16-bit 5-6-5 foreground color
+    @param  bg     16-bit 5-6-5 background color, the same as color for
+                   transparent text
+    @param  size   Magnification in both directions
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawChar(int16_t x, int16_t y, unsigned char c,
+                               uint16_t color, uint16_t bg, uint8_t size) {
+  drawChar(x, y, c, color, bg, size, size);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a single character. A classic font character with a
+            background color is taken from the glyph cache, if one is
+            attached, and sent as one block of pixels; anything else goes
+            to Adafruit_GFX::drawChar().
+    @param  x       Top left corner horizontal coordinate
+    @param  y       Top left corner vertical coordinate
+    @param  c       Character
+    @param  color   16-bit 5-6-5 foreground color
+    @param  bg      16-bit 5-6-5 background color, the same as color for
+                    transparent text
+    @param  size_x  Horizontal magnification
+    @param  size_y  Vertical magnification
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::drawChar(int16_t x, int16_t y, unsigned char c,
+                               uint16_t color, uint16_t bg, uint8_t size_x,
+                               uint8_t size_y) {
+  const uint16_t *glyph = NULL;
+  int16_t w = 6 * size_x, h = 8 * size_y;
+  // Visible part of the glyph, in glyph coordinates
+  int16_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int16_t x1 = ((x + w) > _width) ? _width - x : w,
+          y1 = ((y + h) > _height) ? _height - y : h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return;
+  if (glyphCache && !gfxFont && (bg != color))
+    glyph = glyphCache->get(c, color, bg, size_x, size_y, _cp437);
+  if (!glyph) {
+    Adafruit_GFX::drawChar(x, y, c, color, bg, size_x, size_y);
+    return;
+  }
+
+  startWrite();
+  setAddrWindow(x + x0, y + y0, x1 - x0, y1 - y0);
+  if (!x0 && (x1 == w)) {
+    writePixels((uint16_t *)glyph + y0 * w, (uint32_t)(y1 - y0) * w, true,
+                true);
+  } else {
+    for (int16_t row = y0; row < y1; row++)
+      writePixels((uint16_t *)glyph + row * w + x0, x1 - x0, true, true);
+  }
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert 8-bit red, green and blue to a 12-bit 4-4-4 color
+    @param  r  Red, 0 to 255
+    @param  g  Green, 0 to 255
+    @param  b  Blue, 0 to 255
+    @return 0x0RGB
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::color444(uint8_t r, uint8_t g, uint8_t b) {
+  return ((uint16_t)(r & 0xF0) << 4) | (g & 0xF0) | (b >> 4);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert a 16-bit 5-6-5 color to 12-bit 4-4-4 by truncation
+    @param  color565  16-bit color
+    @return 0x0RGB
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::color444(uint16_t color565) {
+  return ((color565 >> 4) & 0xF00) | ((color565 >> 3) & 0xF0) |
+         ((color565 >> 1) & 0xF);
+}
+
+// Quantize an 8-bit channel to 4 bits, rounding up where the remainder
+// beats the Bayer threshold t (0-15). Scaling by 15/256 instead of 15/255
+// keeps this in 16-bit math.
+static inline uint8_t dither4(uint8_t v, uint8_t t) {
+  return ((uint16_t)v * 15 + t * 16 + 8) >> 8;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert 8-bit red, green and blue to a 12-bit 4-4-4 color with
+            ordered dithering
+    @param  r  Red, 0 to 255
+    @param  g  Green, 0 to 255
+    @param  b  Blue, 0 to 255
+    @param  x  Horizontal position of the pixel on screen
+    @param  y  Vertical position of the pixel on screen
+    @return 0x0RGB
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::ditherColor444(uint8_t r, uint8_t g, uint8_t b,
+                                         int16_t x, int16_t y) {
+  uint8_t t = pgm_read_byte(
+      &Adafruit_ST77xxConvert::bayer4[((y & 3) << 2) | (x & 3)]);
+  return ((uint16_t)dither4(r, t) << 8) | (dither4(g, t) << 4) |
+         dither4(b, t);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert a 16-bit 5-6-5 color to 12-bit 4-4-4 with ordered
+            dithering
+    @param  color565  16-bit color
+    @param  x         Horizontal position of the pixel on screen
+    @param  y         Vertical position of the pixel on screen
+    @return 0x0RGB
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xx::ditherColor444(uint16_t color565, int16_t x,
+                                         int16_t y) {
+  uint8_t r = color565 >> 11, g = (color565 >> 5) & 0x3F, b = color565 & 0x1F;
+  return ditherColor444((r << 3) | (r >> 2), (g << 2) | (g >> 4),
+                        (b << 3) | (b >> 2), x, y);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert and send pixels at 12 or 18 bits. Bytes are staged in
+            a small buffer and sent with SPITFT's writePixels(), which takes
+            them in memory order when told they are big-endian. A 12-bit run
+            of odd length leaves its last nibble pending, so the next run in
+            the same window continues the packing; flushPacked() sends it.
+    @param  colors     16-bit 5-6-5 pixels, or NULL to repeat color
+    @param  color      Color to repeat when colors is NULL
+    @param  len        Pixel count
+    @param  bigEndian  If true, colors are stored most significant byte
+                       first
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writePacked(const uint16_t *colors, uint16_t color,
+                                  uint32_t len, bool bigEndian) {
+  uint16_t words[ST77XX_PACK_WORDS];
+  uint8_t *out = (uint8_t *)words, n = 0;
+  uint16_t c444 = 0;
+  bool convert = true;
+
+  while (len--) {
+    uint16_t c = color;
+    if (colors) {
+      c = *colors++;
+      if (bigEndian)
+        c = (c >> 8) | (c << 8);
+      convert = true;
+    }
+    if (pixelBits == 18) {
+      uint8_t r = c >> 11, g = (c >> 5) & 0x3F, b = c & 0x1F;
+      out[n++] = (r << 3) | (r >> 2);
+      out[n++] = (g << 2) | (g >> 4);
+      out[n++] = (b << 3) | (b >> 2);
+    } else {
+      if (pixelDither) {
+        c444 = ditherColor444(c, winX + winCol, winY + winRow);
+        if (++winCol >= winW) {
+          winCol = 0;
+          winRow++;
+        }
+      } else if (convert) {
+        c444 = color444(c);
+        convert = (colors != NULL); // A repeated color converts once
+      }
+      if (!packHalf) {
+        out[n++] = c444 >> 4;
+        packNibble = c444 & 0xF;
+      } else {
+        out[n++] = (packNibble << 4) | (c444 >> 8);
+        out[n++] = c444;
+      }
+      packHalf = !packHalf;
+    }
+
+    if (n > sizeof(words) - 3) {
+      Adafruit_SPITFT::writePixels(words, n / 2, true, true);
+      if (n & 1)
+        out[0] = out[n - 1];
+      n &= 1;
+    }
+  }
+  if (n > 1)
+    Adafruit_SPITFT::writePixels(words, n / 2, true, true);
+  if (n & 1)
+    spiWrite(out[n - 1]);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send the last nibble of a 12-bit pixel left half sent. The
+            padding nibble is dropped by the controller at the next command.
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::flushPacked(void) {
+  if (packHalf) {
+    spiWrite(packNibble << 4);
+    packHalf = false;
+  }
+}
+
+/**************************************************************************/
+/*!
+ @brief  Invert the colors of the display (if supported by hardware)
+ @param  i  True if you want to invert, false to make 'normal'
+ */
+/**************************************************************************/
+void Adafruit_ST77xx::invertDisplay(bool i) {
+  sendToggle(i ? invertOnCommand : invertOffCommand, shadowInvert);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send one of a pair of argument-less on/off commands, unless it
+            is the last one of the pair that was sent
+    @param  cmd     Command to send
+    @param  shadow  Shadow of the last command of the pair sent
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::sendToggle(uint8_t cmd, uint8_t &shadow) {
+  if (cmd == shadow)
+    return;
+  fence();
+  sendCommand(cmd);
+  shadow = cmd;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Update the state shadow for a command sent from an
+            initialization table
+    @param  cmd   Command that was sent
+    @param  addr  Flash memory address of its arguments
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::trackCommand(uint8_t cmd, const uint8_t *addr) {
+  switch (cmd) {
+  case ST77XX_SWRESET:
+    invalidateState();
+    break;
+  case ST77XX_CASET:
+    shadowValid &= ~ST77XX_SHADOW_CASET;
+    break;
+  case ST77XX_RASET:
+    shadowValid &= ~ST77XX_SHADOW_RASET;
+    break;
+  case ST77XX_MADCTL:
+    shadowMadctl = pgm_read_byte(addr);
+    shadowValid |= ST77XX_SHADOW_MADCTL;
+    break;
+  case ST77XX_COLMOD:
+    shadowColmod = pgm_read_byte(addr);
+    shadowValid |= ST77XX_SHADOW_COLMOD;
+    pixelBits = ((shadowColmod & 7) == 3)   ? 12
+                : ((shadowColmod & 7) == 6) ? 18
+                                            : 16;
+    break;
+  case ST77XX_INVON:
+  case ST77XX_INVOFF:
+    shadowInvert = cmd;
+    break;
+  case ST77XX_DISPON:
+  case ST77XX_DISPOFF:
+    shadowDisplay = cmd;
+    break;
+  case ST77XX_SLPOUT:
+    sleepOutMs = millis();
+    // fall through
+  case ST77XX_SLPIN:
+    shadowSleep = cmd;
+    break;
+  case ST77XX_TEON:
+  case ST77XX_TEOFF:
+    shadowTearing = cmd;
+    break;
+  case ST77XX_PTLON:
+  case ST77XX_NORON:
+    shadowPartial = cmd;
+    break;
+  case ST77XX_IDMON:
+  case ST77XX_IDMOFF:
+    shadowIdle = cmd;
+    break;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Forget the shadowed controller state, so the next call to each
+            setter sends its command again. Call this after resetting the
+            display, or after sending it commands outside of this class.
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::invalidateState(void) {
+  shadowValid = 0;
+  shadowInvert = shadowDisplay = shadowSleep = shadowTearing = 0;
+  shadowPartial = shadowIdle = 0;
+  // A reset ends idle mode and scrolling
+  idleAuto = false;
+  scrollVSA = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Count the display's bus work into a set of counters, zeroing
+            them. Needs the library built with ST77XX_STATS.
+    @param  stats  Counters, with their trace function set or NULL; NULL
+                   to stop counting
+    @return false if the library was built without ST77XX_STATS, and
+            nothing will be counted
+*/
+/**************************************************************************/
+bool Adafruit_ST77xx::setBusStats(ST77xxBusStats *stats) {
+#if defined(ST77XX_STATS)
+  busStats = stats;
+  resetBusStats();
+  return true;
+#else
+  (void)stats;
+  return false;
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief  Zero the attached counters, keeping their trace function
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::resetBusStats(void) {
+  if (busStats) {
+    ST77xxBusTraceFunc trace = busStats->trace;
+    memset(busStats, 0, sizeof(ST77xxBusStats));
+    busStats->trace = trace;
+  }
+}
+
+#if defined(ST77XX_STATS)
+/**************************************************************************/
+/*!
+    @brief  Send a command and its arguments from RAM in a transaction of
+            its own, counting it
+    @param  cmd   Command byte
+    @param  data  Argument bytes
+    @param  n     Argument count
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::sendCommand(uint8_t cmd, uint8_t *data, uint8_t n) {
+  uint32_t t = micros(), before = busStats ? busStats->transactions : 0;
+  Adafruit_SPITFT::sendCommand(cmd, data, n);
+  busSent(cmd, n, t, busStats && (busStats->transactions != before));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send a command and its arguments from flash memory in a
+            transaction of its own, counting it
+    @param  cmd   Command byte
+    @param  data  Argument bytes
+    @param  n     Argument count
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::sendCommand(uint8_t cmd, const uint8_t *data,
+                                  uint8_t n) {
+  uint32_t t = micros(), before = busStats ? busStats->transactions : 0;
+  Adafruit_SPITFT::sendCommand(cmd, data, n);
+  busSent(cmd, n, t, busStats && (busStats->transactions != before));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write a command byte inside a transaction, counting it
+    @param  cmd  Command byte
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::writeCommand(uint8_t cmd) {
+  Adafruit_SPITFT::writeCommand(cmd);
+  busCommand(cmd, 0, 0);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Count a transaction starting
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::busBegin(void) {
+  if (!busStats)
+    return;
+  busStats->transactions++;
+  if (_cs >= 0)
+    busStats->csToggles += 2;
+  busStats->flushBytes = 0;
+  busStats->from = micros();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Count a transaction ending, and report it as a flush
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::busEnd(void) {
+  if (!busStats)
+    return;
+  busPixelsDone();
+  uint32_t us = micros() - busStats->from;
+  busStats->transactionUs += us;
+  if (busStats->trace)
+    busStats->trace(ST77XX_TRACE_FLUSH, 0, busStats->flushBytes, us);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Count a command sent in a transaction of its own, which may be
+            nested in another
+    @param  cmd      Command byte
+    @param  args     Argument bytes
+    @param  from     micros() when sending it started
+    @param  counted  Sending went through startWrite(), which counted the
+                     transaction already
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::busSent(uint8_t cmd, uint8_t args, uint32_t from,
+                              bool counted) {
+  if (!busStats)
+    return;
+  uint32_t us = micros() - from;
+  if (!counted) {
+    busStats->transactions++;
+    if (_cs >= 0)
+      busStats->csToggles += 2;
+    busStats->transactionUs += us;
+  }
+  busCommand(cmd, args, us);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Count a command
+    @param  cmd   Command byte
+    @param  args  Argument bytes, if known
+    @param  us    Time it took, if it had a transaction of its own, else 0
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::busCommand(uint8_t cmd, uint8_t args, uint32_t us) {
+  if (!busStats)
+    return;
+  busPixelsDone();
+  busStats->commands++;
+  if (cmd < ST77XX_STATS_OPCODES)
+    busStats->opcodes[cmd]++;
+  if ((cmd == ST77XX_CASET) || (cmd == ST77XX_RASET))
+    busStats->windowCommands++;
+  busStats->commandUs += us;
+  if (busStats->trace)
+    busStats->trace(ST77XX_TRACE_COMMAND, cmd, args, us);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Count an address window opened for writing, and start timing
+            its pixels
+    @param  w     Width of window
+    @param  h     Height of window
+    @param  from  micros() when opening it started
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::busWindow(uint16_t w, uint16_t h, uint32_t from) {
+  if (!busStats)
+    return;
+  uint32_t bytes = pixelBytes((uint32_t)w * h), us = micros() - from;
+  busStats->windows++;
+  busStats->pixelBytes += bytes;
+  busStats->windowUs += us;
+  busStats->flushBytes += bytes;
+  if (busStats->trace)
+    busStats->trace(ST77XX_TRACE_WINDOW, ST77XX_RAMWR, bytes, us);
+  busStats->pixels = true;
+  busStats->pixelsFrom = micros();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Stop timing the pixels of the last window
+*/
+/**************************************************************************/
+void Adafruit_ST77xx::busPixelsDone(void) {
+  if (busStats->pixels) {
+    busStats->pixelUs += micros() - busStats->pixelsFrom;
+    busStats->pixels = false;
+  }
 }
+#endif // ST77XX_STATS
 
 ////////// stuff not actively being used, but kept for posterity
 /*
@@ -38,10 +38,23 @@
 
 #define ST_CMD_DELAY 0x80 // special signifier for command lists
 
+// Build with -DST77XX_STATS to count the driver's bus work into an
+// ST77xxBusStats attached with setBusStats(). Left undefined, the counting
+// code is not compiled and setBusStats() returns false. The layout of the
+// classes is the same either way, but the counting only happens if the
+// library's .cpp files see the define: set it for the whole build (e.g.
+// build_flags in PlatformIO) or uncomment it here, not in a sketch, which
+// the Arduino IDE compiles separately.
+// #define ST77XX_STATS
+
+// Bus cost of one setAddrWindow(): CASET, RASET, RAMWR + 8 argument bytes
+#define ST77XX_WINDOW_COST 11
+
 #define ST77XX_NOP 0x00
 #define ST77XX_SWRESET 0x01
 #define ST77XX_RDDID 0x04
 #define ST77XX_RDDST 0x09
+#define ST77XX_RDDPM 0x0A
 
 #define ST77XX_SLPIN 0x10
 #define ST77XX_SLPOUT 0x11
@@ -58,10 +71,15 @@
 #define ST77XX_RAMRD 0x2E
 
 #define ST77XX_PTLAR 0x30
+#define ST77XX_VSCRDEF 0x33
 #define ST77XX_TEOFF 0x34
 #define ST77XX_TEON 0x35
 #define ST77XX_MADCTL 0x36
+#define ST77XX_VSCSAD 0x37
+#define ST77XX_IDMOFF 0x38
+#define ST77XX_IDMON 0x39
 #define ST77XX_COLMOD 0x3A
+#define ST77XX_GSCAN 0x45
 
 #define ST77XX_MADCTL_MY 0x80
 #define ST77XX_MADCTL_MX 0x40
@@ -69,6 +87,32 @@
 #define ST77XX_MADCTL_ML 0x10
 #define ST77XX_MADCTL_RGB 0x00
 
+// Bits of Adafruit_ST77xx::shadowValid: which shadowed registers are known
+#define ST77XX_SHADOW_CASET 0x01
+#define ST77XX_SHADOW_RASET 0x02
+#define ST77XX_SHADOW_MADCTL 0x04
+#define ST77XX_SHADOW_COLMOD 0x08
+
+// RDDPM (read display power mode) bits
+#define ST77XX_PM_BOOSTER 0x80  // Booster voltage running
+#define ST77XX_PM_IDLE 0x40     // Idle mode on
+#define ST77XX_PM_PARTIAL 0x20  // Partial mode on
+#define ST77XX_PM_SLEEPOUT 0x10 // Out of sleep
+#define ST77XX_PM_NORMAL 0x08   // Normal display mode on
+#define ST77XX_PM_DISPON 0x04   // Display on
+
+// Datasheet minimum timings, milliseconds
+#define ST77XX_RESET_MS 5      // After a reset from sleep, before any command
+#define ST77XX_SLEEPOUT_MS 120 // Reset from sleep out; SLPOUT to SLPIN
+#define ST77XX_SLPOUT_MS 5     // After SLPOUT, before any command
+
+// Steps of a non-blocking init or sleep change, advanced by poll()
+#define ST77XX_ASYNC_READY 0   // Nothing in progress
+#define ST77XX_ASYNC_NEXT 1    // Send the next init command
+#define ST77XX_ASYNC_WAIT 2    // Waiting out a command's delay
+#define ST77XX_ASYNC_BOOSTER 3 // Polling RDDPM for the booster after SLPOUT
+#define ST77XX_ASYNC_SLPIN 4   // SLPIN held back until 120 ms after SLPOUT
+
 #define ST77XX_RDID1 0xDA
 #define ST77XX_RDID2 0xDB
 #define ST77XX_RDID3 0xDC
@@ -85,8 +129,62 @@
 #define ST77XX_YELLOW 0xFFE0
 #define ST77XX_ORANGE 0xFC00
 
+class Adafruit_ST77xxAsync;
+class Adafruit_ST77xxGlyphCache;
+class Adafruit_ST77xxGroup;
+
+// Commands below this opcode are counted one by one; the rest (init and ID
+// registers) only in the total
+#define ST77XX_STATS_OPCODES 0x50
+
+// Events passed to a ST77xxBusTraceFunc
+#define ST77XX_TRACE_COMMAND 0 // A command
+#define ST77XX_TRACE_WINDOW 1  // An address window opened for writing
+#define ST77XX_TRACE_FLUSH 2   // A transaction ended, its pixels sent
+
+/// Receives bus work as it happens, with ST77XX_STATS. For a command: its
+/// opcode, argument bytes and time when sent in a transaction of its own (0
+/// inside one). For a window: ST77XX_RAMWR, the pixel bytes it holds and
+/// the time to open it. For a flush: 0, the pixel bytes of the windows
+/// opened in the transaction and its duration. Called on the bus path, so
+/// keep it short.
+typedef void (*ST77xxBusTraceFunc)(uint8_t event, uint8_t cmd, uint32_t bytes,
+                                   uint32_t us);
+
+/// Bus work counted by an Adafruit_ST77xx built with ST77XX_STATS, once
+/// attached with setBusStats(). Times overlap: windows and pixels are sent
+/// inside transactions.
+typedef struct {
+  uint32_t commands;                      ///< Commands sent
+  uint32_t opcodes[ST77XX_STATS_OPCODES]; ///< Commands by opcode
+  uint32_t windows;        ///< Address windows opened for writing
+  uint32_t windowCommands; ///< CASET and RASET sent; the shadow skips others
+  uint32_t pixelBytes;     ///< Pixel bytes the windows opened hold
+  uint32_t transactions;   ///< SPI transactions
+  uint32_t csToggles;      ///< Chip select edges, none if CS is tied low
+  uint32_t commandUs;      ///< Time in commands sent in their own transaction
+  uint32_t windowUs;       ///< Time opening address windows
+  uint32_t pixelUs;        ///< Time from opening a window to the next
+                           ///< command or the end of the transaction
+  uint32_t transactionUs;  ///< Time with the bus held
+  ST77xxBusTraceFunc trace; ///< Reports each event as it happens, or NULL
+  uint32_t from,            ///< micros() at transaction start
+      flushBytes,           ///< Pixel bytes in the transaction
+      pixelsFrom;           ///< micros() at the last window
+  bool pixels;              ///< Pixels of a window are going out
+} ST77xxBusStats;
+
+/// Receives one step of display initialization: the command (ST77XX_NOP
+/// for the bus setup and hardware reset), the time spent sending it and the
+/// time spent waiting after it, in microseconds
+typedef void (*ST77xxInitTraceFunc)(uint8_t cmd, uint32_t sendUs,
+                                    uint32_t waitUs);
+
 /// Subclass of SPITFT for ST77xx displays (lots in common!)
 class Adafruit_ST77xx : public Adafruit_SPITFT {
+  friend class Adafruit_ST77xxAsync;
+  friend class Adafruit_ST77xxGroup;
+
 public:
   Adafruit_ST77xx(uint16_t w, uint16_t h, int8_t _CS, int8_t _DC, int8_t _MOSI,
                   int8_t _SCLK, int8_t _RST = -1, int8_t _MISO = -1);
@@ -97,21 +195,243 @@ public:
                   int8_t RS, int8_t RST = -1);
 #endif // end !ESP8266
 
+  void startWrite(void);
+  void endWrite(void);
   void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
   void setRotation(uint8_t r);
   void enableDisplay(boolean enable);
   void enableTearing(boolean enable);
   void enableSleep(boolean enable);
+  bool enableSleepAsync(boolean enable);
+  void enableIdle(boolean enable);
+  void setIdleTimeout(uint32_t ms);
+  bool checkIdle(void);
+  uint16_t readScanline(void);
+  /*!
+    @brief  Scan lines the controller refreshes per frame, visible or not
+    @return GRAM rows, 0 if not known for this controller
+  */
+  uint16_t getGramHeight(void) const { return _gramHeight; }
+  uint16_t getVisibleScanStart(void);
+  // Reading GRAM back; needs MISO to be connected
+  uint16_t readPixel(int16_t x, int16_t y);
+  void readRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t *pcolors);
+  void blendRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color,
+                 uint8_t alpha);
+  bool writeBMP(Print &out);
+
+  void setScrollMargins(uint16_t top, uint16_t bottom);
+  void scrollTo(uint16_t pos);
+  uint16_t getScrollPosition(void);
+  int16_t scrollLines(int16_t lines, uint16_t color);
+
+  void setPartialArea(uint16_t top, uint16_t lines);
+  void enablePartialMode(boolean enable);
+
+  void setColorDepth(uint8_t bits, bool dither = false);
+  /*!
+    @brief  Bits per pixel sent over the bus
+    @return 12, 16 or 18
+  */
+  uint8_t getColorDepth(void) const { return pixelBits; }
+  uint32_t pixelBytes(uint32_t pixels) const;
+
+  // Pixel paths that follow the color depth; 16 bits goes straight to SPITFT
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true,
+                   bool bigEndian = false);
+  void writeColor(uint16_t color, uint32_t len);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void writePixel(int16_t x, int16_t y, uint16_t color);
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                     uint16_t color);
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  using Adafruit_SPITFT::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w,
+                     int16_t h);
+  // Filled shapes as horizontal spans, one transaction each
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                     uint16_t color);
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                    int16_t x2, int16_t y2, uint16_t color);
+  void drawRLEBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                     int16_t h);
+  void writeRGB888(const uint8_t *rgb, uint32_t len, bool dither = false);
+  void writeYUV422(const uint8_t *yuv, uint32_t len);
+  void drawRGB888Bitmap(int16_t x, int16_t y, const uint8_t *rgb, int16_t w,
+                        int16_t h, bool dither = false);
+  void drawYUV422Bitmap(int16_t x, int16_t y, const uint8_t *yuv, int16_t w,
+                        int16_t h);
+  bool drawQOI(int16_t x, int16_t y, const uint8_t qoi[], uint32_t len);
+  bool drawQOI(int16_t x, int16_t y, Stream &stream);
+  static bool getQOISize(const uint8_t qoi[], uint16_t *w, uint16_t *h);
+
+  // Classic font text, through the glyph cache when one is attached
+  using Adafruit_GFX::write;
+  size_t write(uint8_t c);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size_x, uint8_t size_y);
+  /*!
+    @brief  Draw classic font text that has a background color from a
+            cache of expanded glyphs, one block write per character
+    @param  cache  Allocated cache, NULL to draw text the usual way
+  */
+  void setGlyphCache(Adafruit_ST77xxGlyphCache *cache) { glyphCache = cache; }
+
+  static uint16_t color444(uint8_t r, uint8_t g, uint8_t b);
+  static uint16_t color444(uint16_t color565);
+  static uint16_t ditherColor444(uint8_t r, uint8_t g, uint8_t b, int16_t x,
+                                 int16_t y);
+  static uint16_t ditherColor444(uint16_t color565, int16_t x, int16_t y);
+
+  void invertDisplay(bool i);
+  void invalidateState(void);
+
+  /*!
+    @brief  Use datasheet minimum timings and status polling, instead of
+            the init tables' fixed delays, in the next init call
+    @param  enable  True for fast boot
+  */
+  void setFastBoot(boolean enable) { fastBoot = enable; }
+  /*!
+    @brief  Report each step of the next init call, to see where boot time
+            goes
+    @param  func  Called after every command, NULL to stop reporting
+  */
+  void setInitTrace(ST77xxInitTraceFunc func) { initTrace = func; }
+  uint8_t readPowerMode(void);
+
+  bool poll(void);
+  /*!
+    @brief  Check whether a non-blocking init or sleep change has finished
+    @return true once the display takes commands again
+  */
+  bool isReady(void) const { return asyncState == ST77XX_ASYNC_READY; }
+
+  bool setBusStats(ST77xxBusStats *stats);
+  void resetBusStats(void);
+#if defined(ST77XX_STATS)
+  // Counting versions of the SPITFT command calls. They hide, not override,
+  // Adafruit_SPITFT's: commands it sends from its own code (readcommand8(),
+  // sendCommand16()) or that are sent through an Adafruit_SPITFT pointer
+  // are not counted.
+  void sendCommand(uint8_t cmd, uint8_t *data, uint8_t n);
+  void sendCommand(uint8_t cmd, const uint8_t *data = NULL, uint8_t n = 0);
+  void writeCommand(uint8_t cmd);
+#endif
 
 protected:
   uint8_t _colstart = 0,   ///< Some displays need this changed to offset
       _rowstart = 0,       ///< Some displays need this changed to offset
       spiMode = SPI_MODE0; ///< Certain display needs MODE3 instead
+  uint16_t _gramHeight = 0; ///< GRAM rows, i.e. scan lines, of the controller
 
   void begin(uint32_t freq = 0);
   void commonInit(const uint8_t *cmdList);
+  void commonInitAsync(const uint8_t *cmdList1,
+                       const uint8_t *cmdList2 = NULL,
+                       const uint8_t *cmdList3 = NULL);
   void displayInit(const uint8_t *addr);
+  uint16_t initCommand(const uint8_t *&addr);
+  /*!
+    @brief  Finish init once the command tables have run: rotation and
+            whatever else depends on the panel variant. Called by the
+            blocking init functions and by poll().
+  */
+  virtual void initDone(void) {}
   void setColRowStart(int8_t col, int8_t row);
+  void sendMADCTL(uint8_t madctl);
+  void openWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t gx,
+                  uint16_t gy);
+  void setBounds(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void startRead(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void readPixels(uint16_t *dest, uint32_t len);
+  void sendToggle(uint8_t cmd, uint8_t &shadow);
+  void trackCommand(uint8_t cmd, const uint8_t *addr);
+  void fence(void);
+  int32_t scanRow(int32_t pos);
+  int32_t scanPos(int32_t row);
+  uint16_t scrollAreaTop(void);
+  void scrollFill(uint16_t pos, uint16_t n, uint16_t color);
+  void writePacked(const uint16_t *colors, uint16_t color, uint32_t len,
+                   bool bigEndian);
+  void flushPacked(void);
+  void startSPI(uint32_t freq, bool reset);
+  uint8_t pulseReset(void);
+  void fastReset(void);
+  void bootWait(uint8_t cmd, uint8_t pm);
+  uint16_t bootDelay(uint8_t cmd, uint8_t pm);
+  bool boosterReady(void);
+  bool powerModeValid(uint8_t pm);
+  void asyncWait(uint16_t ms);
+  void asyncSleep(uint8_t cmd);
+#if defined(ST77XX_STATS)
+  void busBegin(void);
+  void busEnd(void);
+  void busSent(uint8_t cmd, uint8_t args, uint32_t from, bool counted);
+  void busCommand(uint8_t cmd, uint8_t args, uint32_t us);
+  void busWindow(uint16_t w, uint16_t h, uint32_t from);
+  void busPixelsDone(void);
+#endif
+
+  Adafruit_ST77xxAsync *pipeline = NULL; ///< Attached async pipeline, if any
+  Adafruit_ST77xxGlyphCache *glyphCache = NULL; ///< Text glyphs, if any
+
+  // Shadow of the controller state, so commands that would not change
+  // anything are not sent. Cleared by invalidateState().
+  uint32_t shadowCaset = 0,   ///< Last CASET arguments
+      shadowRaset = 0;        ///< Last RASET arguments
+  uint8_t shadowMadctl = 0,   ///< Last MADCTL argument
+      shadowColmod = 0,       ///< Last COLMOD argument
+      shadowValid = 0,        ///< ST77XX_SHADOW_* bits for the values above
+      shadowInvert = 0,       ///< Last INVON/INVOFF opcode, 0 if unknown
+      shadowDisplay = 0,      ///< Last DISPON/DISPOFF opcode, 0 if unknown
+      shadowSleep = 0,        ///< Last SLPIN/SLPOUT opcode, 0 if unknown
+      shadowTearing = 0,      ///< Last TEON/TEOFF opcode, 0 if unknown
+      shadowPartial = 0,      ///< Last PTLON/NORON opcode, 0 if unknown
+      shadowIdle = 0;         ///< Last IDMON/IDMOFF opcode, 0 if unknown
+
+  uint32_t idleTimeout = 0, ///< Automatic idle mode after this many ms, 0=off
+      idleLastWrite = 0;    ///< millis() at the end of the last write
+  bool idleAuto = false;    ///< Idle mode was entered by the timeout
+
+  bool fastBoot = false;                ///< Init with minimum timings
+  bool bootPolling = false;             ///< RDDPM reads back during init
+  ST77xxInitTraceFunc initTrace = NULL; ///< Init step reporting
+  uint32_t sleepOutMs = 0;              ///< millis() at the last SLPOUT
+  uint8_t stepCmd = 0;                  ///< Last init or sleep command sent
+  uint32_t stepSendUs = 0;              ///< Time it took to send
+
+  const uint8_t *initCmds = NULL;          ///< Next command of the init table
+  const uint8_t *initQueue[3] = {};        ///< Tables still to run, in order
+  uint8_t initLeft = 0;                    ///< Commands left in that table
+  bool asyncInit = false;                  ///< poll() is running an init
+  uint8_t asyncState = ST77XX_ASYNC_READY; ///< ST77XX_ASYNC_* step
+  uint16_t asyncMs = 0;                    ///< Delay being waited out
+  uint32_t asyncFrom = 0,                  ///< millis() at the delay's start
+      asyncSentUs = 0;                     ///< micros() when the step was sent
+
+  uint16_t scrollTFA = 0, ///< Top fixed area, GRAM rows
+      scrollVSA = 0,      ///< Vertical scroll area, GRAM rows (0 = none)
+      scrollSSA = 0;      ///< GRAM row shown on the first scrolling line
+
+  uint8_t pixelBits = 16;   ///< Bits per pixel on the bus, follows COLMOD
+  bool pixelDither = false; ///< Ordered dithering of 12-bit pixels
+  bool packHalf = false;    ///< A 12-bit pixel's last nibble is pending
+  uint8_t packNibble = 0;   ///< That nibble
+  int16_t winX = 0,         ///< Address window left edge, for dithering
+      winY = 0;             ///< Address window top edge, for dithering
+  uint16_t winW = 1,        ///< Address window width, for dithering
+      winCol = 0,           ///< Column of the next pixel in the window
+      winRow = 0;           ///< Row of the next pixel in the window
+
+  ST77xxBusStats *busStats = NULL; ///< Attached counters, ST77XX_STATS only
 };
 
 #endif // _ADAFRUIT_ST77XXH_
@@ -0,0 +1,158 @@
+#include "Adafruit_ST77xxAsync.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate an asynchronous pipeline for a display
+    @param  tft     Display the buffers are pushed to
+    @param  pixels  Size of each of the two buffers, e.g. width x rows for
+                    a band, or width for a single line
+*/
+/**************************************************************************/
+Adafruit_ST77xxAsync::Adafruit_ST77xxAsync(Adafruit_ST77xx &tft,
+                                           uint32_t pixels)
+    : display(tft), bufferPixels(pixels) {}
+
+/**************************************************************************/
+/*!
+    @brief  Finish any transfer still in flight and free the buffers
+*/
+/**************************************************************************/
+Adafruit_ST77xxAsync::~Adafruit_ST77xxAsync(void) {
+  // A subclass' transfer is gone by now; it must wait() in its destructor
+  if (display.pipeline == this)
+    display.pipeline = NULL;
+  for (uint8_t i = 0; i < 2; i++) {
+    if (buffer[i])
+      free(buffer[i]);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate both buffers and attach the pipeline to the display,
+            so that the display's own commands wait for pushed data first
+    @return true on success, false if the buffers could not be allocated
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxAsync::begin(void) {
+  for (uint8_t i = 0; i < 2; i++) {
+    if (!buffer[i])
+      buffer[i] = (uint16_t *)malloc(bufferPixels * 2);
+    if (!buffer[i])
+      return false;
+  }
+  display.pipeline = this;
+  stalls = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the buffer the CPU may draw into. It is never the one being
+            transferred.
+    @return Pointer to getBufferPixels() pixels, NULL before begin()
+*/
+/**************************************************************************/
+uint16_t *Adafruit_ST77xxAsync::getBuffer(void) { return buffer[current]; }
+
+/**************************************************************************/
+/*!
+    @brief  Send the drawing buffer to an area of the display and swap
+            buffers. Waits only if the previous push is still in flight.
+    @param  x  Top left x coordinate of the area
+    @param  y  Top left y coordinate of the area
+    @param  w  Width of the area
+    @param  h  Height of the area; w x h must not exceed getBufferPixels()
+*/
+/**************************************************************************/
+void Adafruit_ST77xxAsync::push(int16_t x, int16_t y, uint16_t w,
+                                uint16_t h) {
+  uint32_t len = (uint32_t)w * h;
+  if (!buffer[current] || !len || (len > bufferPixels))
+    return;
+  if (inFlight) {
+    stalls++;
+    wait();
+  }
+  display.startWrite();
+  display.setAddrWindow(x, y, w, h);
+  inFlight = true;
+  startTransfer(buffer[current], len);
+  current ^= 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Poll the pipeline. Runs the completion callback if the last
+            push has just finished.
+    @return true while a pushed buffer is still being transferred
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxAsync::busy(void) {
+  if (inFlight && !transferBusy())
+    finish();
+  return inFlight;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fence: block until everything pushed has reached the display.
+            The display calls this itself before sending any command, so
+            drawing directly on it between pushes is safe.
+*/
+/**************************************************************************/
+void Adafruit_ST77xxAsync::wait(void) {
+  if (!inFlight)
+    return;
+  waitTransfer();
+  finish();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set a function to call each time a pushed buffer has been
+            transferred. It runs from push(), busy() or wait(), never from
+            an interrupt.
+    @param  func  Callback, or NULL for none
+    @param  arg   Passed to the callback
+*/
+/**************************************************************************/
+void Adafruit_ST77xxAsync::setCallback(ST77xxDoneFunc func, void *arg) {
+  done = func;
+  doneArg = arg;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start sending pixels inside the open write transaction and
+            return as soon as possible
+    @param  pixels  Pixels to send, 16-bit 5-6-5 in native byte order
+    @param  len     Pixel count
+*/
+/**************************************************************************/
+void Adafruit_ST77xxAsync::startTransfer(uint16_t *pixels, uint32_t len) {
+  display.writePixels(pixels, len, false);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check whether the transfer started last is still running
+    @return true if it is still running
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxAsync::transferBusy(void) { return display.dmaBusy(); }
+
+/**************************************************************************/
+/*!
+    @brief  Block until the transfer started last has completed
+*/
+/**************************************************************************/
+void Adafruit_ST77xxAsync::waitTransfer(void) { display.dmaWait(); }
+
+// Close the write transaction of a completed push
+void Adafruit_ST77xxAsync::finish(void) {
+  inFlight = false;
+  display.endWrite();
+  if (done)
+    done(doneArg);
+}
@@ -0,0 +1,63 @@
+#ifndef _ADAFRUIT_ST77XXASYNC_H_
+#define _ADAFRUIT_ST77XXASYNC_H_
+
+#include "Adafruit_ST77xx.h"
+
+/// Called when a pushed buffer has finished transferring
+typedef void (*ST77xxDoneFunc)(void *arg);
+
+/// Double-buffered asynchronous pixel pipeline. The CPU renders into one
+/// buffer while the other is on its way to the display, so drawing and bus
+/// time overlap. The default transfer uses Adafruit_SPITFT's non-blocking
+/// writePixels() (DMA where the core supports it, blocking elsewhere);
+/// subclasses may provide their own transfer by overriding the three
+/// protected transfer methods.
+class Adafruit_ST77xxAsync {
+public:
+  Adafruit_ST77xxAsync(Adafruit_ST77xx &tft, uint32_t pixels);
+  virtual ~Adafruit_ST77xxAsync(void);
+
+  bool begin(void);
+  uint16_t *getBuffer(void);
+  void push(int16_t x, int16_t y, uint16_t w, uint16_t h);
+  bool busy(void);
+  void wait(void);
+  void setCallback(ST77xxDoneFunc func, void *arg = NULL);
+
+  /*!
+    @brief  Size of each of the two buffers
+    @return Pixel count
+  */
+  uint32_t getBufferPixels(void) const { return bufferPixels; }
+  /*!
+    @brief  Display the pipeline feeds
+    @return The display passed to the constructor
+  */
+  Adafruit_ST77xx &getDisplay(void) const { return display; }
+  /*!
+    @brief  How often push() or getBuffer() had to wait for a transfer,
+            i.e. rendering was faster than the bus
+    @return Number of stalls since begin()
+  */
+  uint32_t getStalls(void) const { return stalls; }
+
+protected:
+  virtual void startTransfer(uint16_t *pixels, uint32_t len);
+  virtual bool transferBusy(void);
+  virtual void waitTransfer(void);
+
+  Adafruit_ST77xx &display; ///< Display the pipeline feeds
+
+private:
+  void finish(void);
+
+  uint16_t *buffer[2] = {NULL, NULL};
+  uint32_t bufferPixels;
+  uint8_t current = 0; // Buffer the CPU may draw into
+  bool inFlight = false;
+  uint32_t stalls = 0;
+  ST77xxDoneFunc done = NULL;
+  void *doneArg = NULL;
+};
+
+#endif // _ADAFRUIT_ST77XXASYNC_H_
@@ -0,0 +1,292 @@
+#include "Adafruit_ST77xxCanvas.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate a damage-tracking 16-bit canvas
+    @param  w  Canvas width in pixels
+    @param  h  Canvas height in pixels
+*/
+/**************************************************************************/
+Adafruit_ST77xxCanvas::Adafruit_ST77xxCanvas(uint16_t w, uint16_t h)
+    : GFXcanvas16(w, h) {}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a pixel to the canvas and record the damage
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  markDirty(x, y, 1, 1);
+  GFXcanvas16::drawPixel(x, y, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill the canvas with a color; the whole canvas becomes dirty
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::fillScreen(uint16_t color) {
+  markAllDirty();
+  GFXcanvas16::fillScreen(color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a vertical line to the canvas and record the damage
+    @param  x      Top x coordinate
+    @param  y      Top y coordinate
+    @param  h      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                          uint16_t color) {
+  markDirty(x, y, 1, h);
+  GFXcanvas16::drawFastVLine(x, y, h, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a horizontal line to the canvas and record the damage
+    @param  x      Left x coordinate
+    @param  y      Left y coordinate
+    @param  w      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                          uint16_t color) {
+  markDirty(x, y, w, 1);
+  GFXcanvas16::drawFastHLine(x, y, w, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle on the canvas and record it as one damage
+            rectangle (rather than one per column)
+    @param  x      Top left x coordinate
+    @param  y      Top left y coordinate
+    @param  w      Width in pixels
+    @param  h      Height in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::fillRect(int16_t x, int16_t y, int16_t w,
+                                     int16_t h, uint16_t color) {
+  markDirty(x, y, w, h);
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  for (int16_t i = 0; i < w; i++) {
+    GFXcanvas16::drawFastVLine(x + i, y, h, color);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record an area as damaged. Drawing through Adafruit_GFX does
+            this automatically; call it directly after writing to
+            getBuffer() by hand.
+    @param  x  Top left x coordinate (current rotation)
+    @param  y  Top left y coordinate (current rotation)
+    @param  w  Width in pixels, may be negative
+    @param  h  Height in pixels, may be negative
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::markDirty(int16_t x, int16_t y, int16_t w,
+                                      int16_t h) {
+  if (!w || !h)
+    return;
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  int16_t x1 = x + w - 1, y1 = y + h - 1;
+  if ((x >= _width) || (y >= _height) || (x1 < 0) || (y1 < 0))
+    return;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x1 >= _width)
+    x1 = _width - 1;
+  if (y1 >= _height)
+    y1 = _height - 1;
+
+  // Damage is kept in raw buffer coordinates, as flush() pushes them
+  Rect r;
+  switch (rotation) {
+  case 0:
+    r.x0 = x;
+    r.x1 = x1;
+    r.y0 = y;
+    r.y1 = y1;
+    break;
+  case 1:
+    r.x0 = WIDTH - 1 - y1;
+    r.x1 = WIDTH - 1 - y;
+    r.y0 = x;
+    r.y1 = x1;
+    break;
+  case 2:
+    r.x0 = WIDTH - 1 - x1;
+    r.x1 = WIDTH - 1 - x;
+    r.y0 = HEIGHT - 1 - y1;
+    r.y1 = HEIGHT - 1 - y;
+    break;
+  default:
+    r.x0 = y;
+    r.x1 = y1;
+    r.y0 = HEIGHT - 1 - x1;
+    r.y1 = HEIGHT - 1 - x;
+    break;
+  }
+  addRect(r);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Mark the whole canvas as damaged
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::markAllDirty(void) {
+  dirty[0].x0 = dirty[0].y0 = 0;
+  dirty[0].x1 = WIDTH - 1;
+  dirty[0].y1 = HEIGHT - 1;
+  dirtyCount = 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Push the damaged areas to a display in a single transaction,
+            one address window per damage rectangle, then clear the damage
+    @param  tft  Display to draw on
+    @param  x    Display x coordinate of the canvas' top left corner
+    @param  y    Display y coordinate of the canvas' top left corner
+    @return Bus bytes sent, including address window overhead
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxCanvas::flush(Adafruit_ST77xx &tft, int16_t x,
+                                      int16_t y) {
+  uint16_t *buf = getBuffer();
+  flushBytes = 0;
+  if (buf && dirtyCount) {
+    tft.startWrite();
+    for (uint8_t i = 0; i < dirtyCount; i++) {
+      Rect r = dirty[i];
+      // Clip against the display as well, the canvas may hang off an edge
+      if (x + r.x0 < 0)
+        r.x0 = -x;
+      if (y + r.y0 < 0)
+        r.y0 = -y;
+      if (x + r.x1 >= tft.width())
+        r.x1 = tft.width() - 1 - x;
+      if (y + r.y1 >= tft.height())
+        r.y1 = tft.height() - 1 - y;
+      if ((r.x1 < r.x0) || (r.y1 < r.y0))
+        continue;
+      uint16_t w = r.x1 - r.x0 + 1;
+      tft.setAddrWindow(x + r.x0, y + r.y0, w, r.y1 - r.y0 + 1);
+      for (int16_t row = r.y0; row <= r.y1; row++) {
+        tft.writePixels(&buf[(int32_t)row * WIDTH + r.x0], w);
+      }
+      flushBytes += ST77XX_WINDOW_COST +
+                    tft.pixelBytes((uint32_t)w * (r.y1 - r.y0 + 1));
+    }
+    tft.endWrite();
+  }
+
+  uint32_t full =
+      ST77XX_WINDOW_COST + tft.pixelBytes((uint32_t)WIDTH * HEIGHT);
+  flushSavedBytes = (full > flushBytes) ? (full - flushBytes) : 0;
+  dirtyCount = 0;
+  return flushBytes;
+}
+
+// Bytes needed to push a rectangle: window setup plus 2 bytes per pixel.
+// Only used to choose between layouts, where 16 bits is close enough for
+// the other color depths too.
+uint32_t Adafruit_ST77xxCanvas::cost(const Rect &r) {
+  return ST77XX_WINDOW_COST +
+         2UL * (uint32_t)(r.x1 - r.x0 + 1) * (uint32_t)(r.y1 - r.y0 + 1);
+}
+
+Adafruit_ST77xxCanvas::Rect Adafruit_ST77xxCanvas::bounds(const Rect &a,
+                                                          const Rect &b) {
+  Rect r;
+  r.x0 = (a.x0 < b.x0) ? a.x0 : b.x0;
+  r.y0 = (a.y0 < b.y0) ? a.y0 : b.y0;
+  r.x1 = (a.x1 > b.x1) ? a.x1 : b.x1;
+  r.y1 = (a.y1 > b.y1) ? a.y1 : b.y1;
+  return r;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Add a damage rectangle, merging it with existing ones whenever
+            one bigger window is no more expensive on the bus than two
+            separate windows (setAddrWindow overhead vs. extra pixels)
+    @param  r  Damage rectangle in raw buffer coordinates
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::addRect(Rect r) {
+  for (uint8_t i = 0; i < dirtyCount; i++) {
+    const Rect &d = dirty[i];
+    if ((r.x0 >= d.x0) && (r.x1 <= d.x1) && (r.y0 >= d.y0) && (r.y1 <= d.y1))
+      return; // Already covered
+  }
+
+  // Merging can make the result worth merging with another rect, so keep
+  // folding until nothing changes.
+  bool merged;
+  do {
+    merged = false;
+    for (uint8_t i = 0; i < dirtyCount; i++) {
+      Rect m = bounds(dirty[i], r);
+      if (cost(m) <= cost(dirty[i]) + cost(r)) {
+        r = m;
+        dirty[i] = dirty[--dirtyCount];
+        merged = true;
+        break;
+      }
+    }
+  } while (merged);
+
+  // Over the limit, the new rectangle is as good a candidate as any
+  dirty[dirtyCount++] = r;
+  if (dirtyCount > ST77XX_MAX_DIRTY)
+    mergeCheapestPair();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Free a slot by merging the two rectangles whose union adds the
+            fewest bus bytes
+*/
+/**************************************************************************/
+void Adafruit_ST77xxCanvas::mergeCheapestPair(void) {
+  uint8_t bi = 0, bj = 1;
+  int32_t best = 0x7FFFFFFF;
+  for (uint8_t i = 0; i < dirtyCount; i++) {
+    for (uint8_t j = i + 1; j < dirtyCount; j++) {
+      int32_t extra = (int32_t)cost(bounds(dirty[i], dirty[j])) -
+                      (int32_t)(cost(dirty[i]) + cost(dirty[j]));
+      if (extra < best) {
+        best = extra;
+        bi = i;
+        bj = j;
+      }
+    }
+  }
+  dirty[bi] = bounds(dirty[bi], dirty[bj]);
+  dirty[bj] = dirty[--dirtyCount];
+}
@@ -0,0 +1,56 @@
+#ifndef _ADAFRUIT_ST77XXCANVAS_H_
+#define _ADAFRUIT_ST77XXCANVAS_H_
+
+#include "Adafruit_ST77xx.h"
+
+#define ST77XX_MAX_DIRTY 8 ///< Damage rectangles tracked before forced merge
+
+/// 16-bit canvas that tracks damaged areas and flushes only those to a
+/// ST77xx display, instead of pushing the whole framebuffer every frame.
+class Adafruit_ST77xxCanvas : public GFXcanvas16 {
+public:
+  Adafruit_ST77xxCanvas(uint16_t w, uint16_t h);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  void markAllDirty(void);
+  void clearDirty(void) { dirtyCount = 0; }
+  uint32_t flush(Adafruit_ST77xx &tft, int16_t x = 0, int16_t y = 0);
+
+  /*!
+    @brief  Number of damage rectangles pending for the next flush
+    @return Rectangle count
+  */
+  uint8_t getDirtyCount(void) const { return dirtyCount; }
+  /*!
+    @brief  Bus bytes sent by the last flush()
+    @return Byte count, including address window overhead
+  */
+  uint32_t getFlushBytes(void) const { return flushBytes; }
+  /*!
+    @brief  Bus bytes the last flush() saved versus pushing the full canvas
+    @return Byte count
+  */
+  uint32_t getFlushSavedBytes(void) const { return flushSavedBytes; }
+
+private:
+  struct Rect {
+    int16_t x0, y0, x1, y1; // Inclusive, raw (unrotated) buffer coordinates
+  };
+
+  void addRect(Rect r);
+  void mergeCheapestPair(void);
+  static uint32_t cost(const Rect &r);
+  static Rect bounds(const Rect &a, const Rect &b);
+
+  Rect dirty[ST77XX_MAX_DIRTY + 1]; // One over, briefly, while adding
+  uint8_t dirtyCount = 0;
+  uint32_t flushBytes = 0, flushSavedBytes = 0;
+};
+
+#endif // _ADAFRUIT_ST77XXCANVAS_H_
@@ -0,0 +1,326 @@
+#include "Adafruit_ST77xxConvert.h"
+#include <string.h>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 4x4 Bayer matrix, thresholds for ordered dithering
+const uint8_t PROGMEM Adafruit_ST77xxConvert::bayer4[16] = {
+    0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5};
+
+static inline uint16_t pack565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((uint16_t)(r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static inline uint16_t swap(uint16_t c) { return (c >> 8) | (c << 8); }
+
+// YUV422 is taken as BT.601 studio range (Y 16-235) in 6-bit fixed point:
+// R = 1.164 (Y - 16) + 1.596 (V - 128)
+// G = 1.164 (Y - 16) - 0.391 (U - 128) - 0.813 (V - 128)
+// B = 1.164 (Y - 16) + 2.018 (U - 128)
+// Every term fits in 16 bits. Only blue's sum can overflow, and the SIMD
+// paths saturate it, which clamps to 255 just the same.
+#define YUV_Y 74
+#define YUV_RV 102
+#define YUV_GU -25
+#define YUV_GV -52
+#define YUV_BU 129
+
+static inline uint8_t yuvChannel(int32_t v) {
+  v += 32;
+  return (v < 0) ? 0 : (v >= (256 << 6)) ? 255 : v >> 6;
+}
+
+// One pixel from its luma term c = YUV_Y * (Y - 16) and the chroma terms
+// its pair shares
+static inline uint16_t yuvPixel(int32_t c, int32_t rv, int32_t guv,
+                                int32_t bu) {
+  return pack565(yuvChannel(c + rv), yuvChannel(c + guv), yuvChannel(c + bu));
+}
+
+#if defined(ST77XX_CONVERT_SWAR)
+// Unaligned 32-bit access; compilers turn the memcpy into a plain load
+static inline uint32_t load32(const void *p) {
+  uint32_t w;
+  memcpy(&w, p, 4);
+  return w;
+}
+
+static inline void store32(void *p, uint32_t w) { memcpy(p, &w, 4); }
+
+// Swap the bytes of both 16-bit halves at once
+static inline uint32_t swapHalves(uint32_t w) {
+  return ((w & 0x00FF00FF) << 8) | ((w >> 8) & 0x00FF00FF);
+}
+#endif
+
+#if defined(__ARM_NEON)
+static inline uint16x8_t neonPack(uint8x8_t r, uint8x8_t g, uint8x8_t b,
+                                  bool bigEndian) {
+  uint16x8_t c = vorrq_u16(vshll_n_u8(vand_u8(r, vdup_n_u8(0xF8)), 8),
+                           vshll_n_u8(vand_u8(g, vdup_n_u8(0xFC)), 3));
+  c = vorrq_u16(c, vmovl_u8(vshr_n_u8(b, 3)));
+  return bigEndian ? vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(c)))
+                   : c;
+}
+
+// Clamp (v + 32) >> 6 to 0-255, saturating the sum as the scalar path
+// clamps it
+static inline uint8x8_t neonChannel(int16x8_t c, int16x8_t uv) {
+  return vqmovun_s16(vshrq_n_s16(
+      vqaddq_s16(vqaddq_s16(c, uv), vdupq_n_s16(32)), 6));
+}
+#elif defined(__SSE2__)
+// r, g and b are 0-255 in 16-bit lanes
+static inline __m128i ssePack(__m128i r, __m128i g, __m128i b,
+                              bool bigEndian) {
+  __m128i c = _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(r, _mm_set1_epi16(0xF8)), 8),
+      _mm_slli_epi16(_mm_and_si128(g, _mm_set1_epi16(0xFC)), 3));
+  c = _mm_or_si128(c, _mm_srli_epi16(b, 3));
+  return bigEndian ? _mm_or_si128(_mm_slli_epi16(c, 8), _mm_srli_epi16(c, 8))
+                   : c;
+}
+
+static inline __m128i sseChannel(__m128i c, __m128i uv) {
+  __m128i v = _mm_srai_epi16(
+      _mm_adds_epi16(_mm_adds_epi16(c, uv), _mm_set1_epi16(32)), 6);
+  return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()),
+                       _mm_set1_epi16(255));
+}
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Convert 8-bit RGB to 16-bit 5-6-5 by truncation, as color565()
+    @param  dst        Output pixels
+    @param  src        Input, 3 bytes per pixel: red, green, blue
+    @param  n          Pixel count
+    @param  bigEndian  If true, output most significant byte first
+*/
+/**************************************************************************/
+void Adafruit_ST77xxConvert::rgb888(uint16_t *dst, const uint8_t *src,
+                                    uint32_t n, bool bigEndian) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  for (; i + 8 <= n; i += 8) {
+    uint8x8x3_t p = vld3_u8(src + 3 * i);
+    vst1q_u16(dst + i, neonPack(p.val[0], p.val[1], p.val[2], bigEndian));
+  }
+#elif defined(__SSSE3__)
+  // Four pixels from each of two loads 12 bytes apart. The second load
+  // reads 4 bytes past the 8 pixels, so leave those to the next round.
+  const __m128i rm = _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, -1, -1, -1,
+                                   -1, -1, -1, -1, -1),
+                gm = _mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, -1, -1, -1,
+                                   -1, -1, -1, -1, -1),
+                bm = _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, -1, -1, -1,
+                                   -1, -1, -1, -1, -1);
+  for (; i + 10 <= n; i += 8) {
+    __m128i lo = _mm_loadu_si128((const __m128i *)(src + 3 * i)),
+            hi = _mm_loadu_si128((const __m128i *)(src + 3 * i + 12));
+    __m128i r = _mm_unpacklo_epi64(_mm_shuffle_epi8(lo, rm),
+                                   _mm_shuffle_epi8(hi, rm)),
+            g = _mm_unpacklo_epi64(_mm_shuffle_epi8(lo, gm),
+                                   _mm_shuffle_epi8(hi, gm)),
+            b = _mm_unpacklo_epi64(_mm_shuffle_epi8(lo, bm),
+                                   _mm_shuffle_epi8(hi, bm));
+    _mm_storeu_si128((__m128i *)(dst + i), ssePack(r, g, b, bigEndian));
+  }
+#elif defined(ST77XX_CONVERT_SWAR)
+  // Four pixels from three words: R0G0B0R1 G1B1R2G2 B2R3G3B3
+  for (; i + 4 <= n; i += 4) {
+    const uint8_t *s = src + 3 * i;
+    uint32_t w0 = load32(s), w1 = load32(s + 4), w2 = load32(s + 8);
+    uint32_t p0 = ((w0 << 8) & 0xF800) | ((w0 >> 5) & 0x07E0) |
+                  ((w0 >> 19) & 0x1F),
+             p1 = ((w0 >> 16) & 0xF800) | ((w1 << 3) & 0x07E0) |
+                  ((w1 >> 11) & 0x1F),
+             p2 = ((w1 >> 8) & 0xF800) | ((w1 >> 21) & 0x07E0) |
+                  ((w2 >> 3) & 0x1F),
+             p3 = (w2 & 0xF800) | ((w2 >> 13) & 0x07E0) | (w2 >> 27);
+    uint32_t a = p0 | (p1 << 16), b = p2 | (p3 << 16);
+    if (bigEndian) {
+      a = swapHalves(a);
+      b = swapHalves(b);
+    }
+    store32(dst + i, a);
+    store32(dst + i + 2, b);
+  }
+#endif
+  for (src += 3 * i; i < n; i++, src += 3) {
+    uint16_t c = pack565(src[0], src[1], src[2]);
+    dst[i] = bigEndian ? swap(c) : c;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert 8-bit RGB to 16-bit 5-6-5 with 4x4 ordered dithering,
+            which hides the banding truncation leaves in smooth gradients.
+            A run must not wrap to another row: convert a line at a time.
+    @param  dst        Output pixels
+    @param  src        Input, 3 bytes per pixel: red, green, blue
+    @param  n          Pixel count
+    @param  x          Horizontal position of the first pixel on screen
+    @param  y          Vertical position of the pixels on screen
+    @param  bigEndian  If true, output most significant byte first
+*/
+/**************************************************************************/
+void Adafruit_ST77xxConvert::rgb888Dither(uint16_t *dst, const uint8_t *src,
+                                          uint32_t n, int16_t x, int16_t y,
+                                          bool bigEndian) {
+  // Same rounding as the 12-bit dither: scale by 31/256 or 63/256 and
+  // round up where the remainder beats the threshold
+  uint8_t t[4];
+  for (uint8_t k = 0; k < 4; k++)
+    t[k] = pgm_read_byte(&bayer4[((y & 3) << 2) | ((x + k) & 3)]) * 16 + 8;
+  for (uint32_t i = 0; i < n; i++, src += 3) {
+    uint16_t d = t[i & 3];
+    uint16_t c = (((uint16_t)src[0] * 31 + d) >> 8 << 11) |
+                 (((uint16_t)src[1] * 63 + d) >> 8 << 5) |
+                 (((uint16_t)src[2] * 31 + d) >> 8);
+    dst[i] = bigEndian ? swap(c) : c;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert YUV 4:2:2 (YUYV byte order, as cameras such as the
+            OV7670 and OV2640 send it) to 16-bit 5-6-5. Each pair of pixels
+            shares its U and V samples.
+    @param  dst        Output pixels
+    @param  src        Input, 4 bytes per pixel pair: Y0, U, Y1, V
+    @param  n          Pixel count. If odd, the last pixel still reads its
+                       pair's 4 bytes.
+    @param  bigEndian  If true, output most significant byte first
+*/
+/**************************************************************************/
+void Adafruit_ST77xxConvert::yuv422(uint16_t *dst, const uint8_t *src,
+                                    uint32_t n, bool bigEndian) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  for (; i + 16 <= n; i += 16) {
+    uint8x8x4_t p = vld4_u8(src + 2 * i); // Y0s, Us, Y1s, Vs of 8 pairs
+    int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(p.val[1])),
+                            vdupq_n_s16(128)),
+              e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(p.val[3])),
+                            vdupq_n_s16(128));
+    int16x8_t rv = vmulq_n_s16(e, YUV_RV),
+              guv = vaddq_s16(vmulq_n_s16(d, YUV_GU), vmulq_n_s16(e, YUV_GV)),
+              bu = vmulq_n_s16(d, YUV_BU);
+    uint16x8x2_t out;
+    for (uint8_t k = 0; k < 2; k++) {
+      int16x8_t c = vmulq_n_s16(
+          vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(p.val[2 * k])),
+                    vdupq_n_s16(16)),
+          YUV_Y);
+      out.val[k] = neonPack(neonChannel(c, rv), neonChannel(c, guv),
+                            neonChannel(c, bu), bigEndian);
+    }
+    vst2q_u16(dst + i, out); // Interleaves the even and odd pixels
+  }
+#elif defined(__SSE2__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+    __m128i y = _mm_and_si128(v, _mm_set1_epi16(0xFF)),
+            uv = _mm_srli_epi16(v, 8); // U0 V0 U1 V1 ...
+    __m128i u = _mm_shufflehi_epi16(
+                _mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)),
+                _MM_SHUFFLE(2, 2, 0, 0)),
+            w = _mm_shufflehi_epi16(
+                _mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)),
+                _MM_SHUFFLE(3, 3, 1, 1));
+    __m128i c = _mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)),
+                                _mm_set1_epi16(YUV_Y)),
+            d = _mm_sub_epi16(u, _mm_set1_epi16(128)),
+            e = _mm_sub_epi16(w, _mm_set1_epi16(128));
+    __m128i rv = _mm_mullo_epi16(e, _mm_set1_epi16(YUV_RV)),
+            guv = _mm_add_epi16(_mm_mullo_epi16(d, _mm_set1_epi16(YUV_GU)),
+                                _mm_mullo_epi16(e, _mm_set1_epi16(YUV_GV))),
+            bu = _mm_mullo_epi16(d, _mm_set1_epi16(YUV_BU));
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     ssePack(sseChannel(c, rv), sseChannel(c, guv),
+                             sseChannel(c, bu), bigEndian));
+  }
+#endif
+  for (src += 2 * i; i < n; i += 2, src += 4) {
+#if defined(ST77XX_CONVERT_SWAR)
+    uint32_t w = load32(src); // Y0 U Y1 V
+    int32_t y0 = w & 0xFF, u = (w >> 8) & 0xFF, y1 = (w >> 16) & 0xFF,
+            v = w >> 24;
+#else
+    int32_t y0 = src[0], u = src[1], y1 = src[2], v = src[3];
+#endif
+    int32_t d = u - 128, e = v - 128;
+    int32_t rv = YUV_RV * e, guv = YUV_GU * d + YUV_GV * e, bu = YUV_BU * d;
+    uint16_t c0 = yuvPixel(YUV_Y * (y0 - 16), rv, guv, bu);
+    if (i + 1 == n) { // Odd count, half a pair left
+      dst[i] = bigEndian ? swap(c0) : c0;
+      break;
+    }
+    uint16_t c1 = yuvPixel(YUV_Y * (y1 - 16), rv, guv, bu);
+#if defined(ST77XX_CONVERT_SWAR)
+    uint32_t out = c0 | ((uint32_t)c1 << 16);
+    store32(dst + i, bigEndian ? swapHalves(out) : out);
+#else
+    dst[i] = bigEndian ? swap(c0) : c0;
+    dst[i + 1] = bigEndian ? swap(c1) : c1;
+#endif
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Swap the bytes of 16-bit pixels, e.g. between a little-endian
+            framebuffer and bus order. dst may be src.
+    @param  dst  Output pixels
+    @param  src  Input pixels
+    @param  n    Pixel count
+*/
+/**************************************************************************/
+void Adafruit_ST77xxConvert::swap16(uint16_t *dst, const uint16_t *src,
+                                    uint32_t n) {
+  uint32_t i = 0;
+#if defined(__ARM_NEON)
+  for (; i + 8 <= n; i += 8) {
+    uint8x16_t v = vld1q_u8((const uint8_t *)(src + i));
+    vst1q_u8((uint8_t *)(dst + i), vrev16q_u8(v));
+  }
+#elif defined(__SSE2__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+  }
+#elif defined(ST77XX_CONVERT_SWAR)
+  for (; i + 2 <= n; i += 2)
+    store32(dst + i, swapHalves(load32(src + i)));
+#endif
+  for (; i < n; i++)
+    dst[i] = swap(src[i]);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Name the code path the kernels were compiled with
+    @return "NEON", "SSSE3", "SSE2", "32-bit" or "8-bit"
+*/
+/**************************************************************************/
+const char *Adafruit_ST77xxConvert::path(void) {
+#if defined(__ARM_NEON)
+  return "NEON";
+#elif defined(__SSSE3__)
+  return "SSSE3";
+#elif defined(__SSE2__)
+  return "SSE2";
+#elif defined(ST77XX_CONVERT_SWAR)
+  return "32-bit";
+#else
+  return "8-bit";
+#endif
+}
@@ -0,0 +1,34 @@
+#ifndef _ADAFRUIT_ST77XXCONVERT_H_
+#define _ADAFRUIT_ST77XXCONVERT_H_
+
+#include "Arduino.h"
+
+// Word-at-a-time kernels where 32-bit loads are cheap and bytes are in
+// little-endian order; 8-bit AVR keeps the plain per-pixel loops
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) &&                           \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define ST77XX_CONVERT_SWAR
+#endif
+
+/// Pixel format conversion kernels, for camera frames and images that
+/// arrive as 8-bit RGB or YUV. Each call converts a run of pixels and keeps
+/// no state, so it can run a line at a time between a source and
+/// Adafruit_ST77xx::writePixels(). With bigEndian set the output is in bus
+/// byte order, ready for writePixels(buf, n, true, true) without a swap.
+/// Kernels use SSE2/SSSE3 or NEON when the compiler targets them, 32-bit
+/// word operations otherwise, and give the same result on every path.
+class Adafruit_ST77xxConvert {
+public:
+  static void rgb888(uint16_t *dst, const uint8_t *src, uint32_t n,
+                     bool bigEndian = false);
+  static void rgb888Dither(uint16_t *dst, const uint8_t *src, uint32_t n,
+                           int16_t x, int16_t y, bool bigEndian = false);
+  static void yuv422(uint16_t *dst, const uint8_t *src, uint32_t n,
+                     bool bigEndian = false);
+  static void swap16(uint16_t *dst, const uint16_t *src, uint32_t n);
+  static const char *path(void);
+
+  static const uint8_t bayer4[16]; ///< 4x4 Bayer thresholds, in PROGMEM
+};
+
+#endif // _ADAFRUIT_ST77XXCONVERT_H_
@@ -0,0 +1,350 @@
+#include "Adafruit_ST77xxDisplayList.h"
+
+// Parts of one operation still being cut by later ones, at most
+#define ST77XX_LIST_STACK 16
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate a display list. Call begin() to allocate it.
+    @param  tft  Display the frames are sent to
+    @param  ops  Operations recorded before a commit is forced (at least
+                 1). Each takes 32 bytes on 32-bit cores: the operation
+                 and room for one visible part of it.
+*/
+/**************************************************************************/
+Adafruit_ST77xxDisplayList::Adafruit_ST77xxDisplayList(Adafruit_ST77xx &tft,
+                                                       uint16_t ops)
+    : Adafruit_GFX(tft.width(), tft.height()), display(tft),
+      opMax(ops ? ops : 1) {}
+
+/**************************************************************************/
+/*!
+    @brief  Free the operation buffers
+*/
+/**************************************************************************/
+Adafruit_ST77xxDisplayList::~Adafruit_ST77xxDisplayList(void) {
+  if (ops)
+    free(ops);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate the operation buffers. Call after the display's
+            init().
+    @return true on success, false if out of memory
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxDisplayList::begin(void) {
+  if (!ops) {
+    // One block: recorded operations, then their visible parts
+    ops = (Op *)malloc(2 * (uint32_t)opMax * sizeof(Op));
+    if (!ops)
+      return false;
+    pieces = ops + opMax;
+  }
+  follow();
+  discard();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send the recorded frame and start recording the next one
+    @return Bus bytes the frame sent, including address window overhead
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxDisplayList::commit(void) {
+  replay();
+  frame = stats;
+  memset(&stats, 0, sizeof(stats));
+  follow();
+  return frame.bytes;
+}
+
+// Take the display's current rotation and size, for the next frame
+void Adafruit_ST77xxDisplayList::follow(void) {
+  rotation = display.getRotation();
+  _width = display.width();
+  _height = display.height();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Drop everything recorded since the last commit()
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::discard(void) {
+  opCount = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record an operation, extending the previous one instead where
+            both are fills of the same color that together make a
+            rectangle. Replays early if the list is full.
+    @param  op  Operation, with positive width and height
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::push(const Op &op) {
+  if (!ops)
+    return;
+  if (opCount && ops[opCount - 1].extend(op))
+    return;
+  if (opCount == opMax)
+    replay();
+  ops[opCount++] = op;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send the recorded operations in one transaction: drop those off
+            screen, cut away what later ones paint over, and send the
+            remaining parts sorted top to bottom
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::replay(void) {
+  if (!opCount)
+    return;
+  int16_t sw = display.width(), sh = display.height();
+  uint16_t n = 0;
+  uint32_t onScreen = 0;
+  for (uint16_t i = 0; i < opCount; i++) {
+    Op op = ops[i];
+    stats.recorded++;
+    int16_t x0 = (op.x < 0) ? 0 : op.x, y0 = (op.y < 0) ? 0 : op.y;
+    int16_t x1 = ((op.x + op.w) > sw) ? sw : op.x + op.w,
+            y1 = ((op.y + op.h) > sh) ? sh : op.y + op.h;
+    if ((x0 >= x1) || (y0 >= y1)) {
+      stats.clipped++;
+      continue;
+    }
+    op.crop(x0, y0, x1, y1);
+    uint32_t area = op.area();
+    onScreen += area;
+    stats.naiveBytes += ST77XX_WINDOW_COST + display.pixelBytes(area);
+    ops[n++] = op;
+  }
+
+  uint32_t drawn = stats.drawn;
+  pieceCount = 0;
+  display.startWrite();
+  for (uint16_t i = 0; i < n; i++)
+    visible(i, n);
+
+  // Parts left are disjoint from each other and from everything recorded
+  // after them, so any order gives the same frame: top to bottom, left to
+  // right, with same-color neighbors that make a rectangle joined.
+  for (uint16_t i = 1; i < pieceCount; i++) {
+    Op p = pieces[i];
+    uint16_t j = i;
+    for (; j && ((pieces[j - 1].y > p.y) ||
+                 ((pieces[j - 1].y == p.y) && (pieces[j - 1].x > p.x)));
+         j--)
+      pieces[j] = pieces[j - 1];
+    pieces[j] = p;
+  }
+  for (uint16_t i = 0; i < pieceCount; i++) {
+    Op p = pieces[i];
+    while ((i + 1 < pieceCount) && p.extend(pieces[i + 1]))
+      i++;
+    send(p);
+  }
+  display.endWrite();
+
+  stats.culledPixels += onScreen - (stats.drawn - drawn);
+  opCount = pieceCount = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Cut an operation down to the parts no later operation paints
+            over. Parts are kept to be sorted; one that is not worth
+            cutting further (the pixels saved would cost more in address
+            windows) or does not fit is sent right away, since nothing
+            recorded after it has been sent yet.
+    @param  i  Operation, clipped to the screen
+    @param  n  Number of operations
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::visible(uint16_t i, uint16_t n) {
+  struct Part {
+    int16_t x0, y0, x1, y1; // Exclusive ends
+    uint16_t next;          // First later operation not yet cut away
+  } stack[ST77XX_LIST_STACK];
+  const Op &op = ops[i];
+  uint8_t sp = 1;
+  stack[0].x0 = op.x;
+  stack[0].y0 = op.y;
+  stack[0].x1 = op.x + op.w;
+  stack[0].y1 = op.y + op.h;
+  stack[0].next = i + 1;
+  bool shown = false;
+
+  while (sp) {
+    Part p = stack[--sp];
+    uint16_t k = p.next;
+    for (; k < n; k++) {
+      const Op &c = ops[k];
+      if ((c.x < p.x1) && (c.x + c.w > p.x0) && (c.y < p.y1) &&
+          (c.y + c.h > p.y0))
+        break;
+    }
+    bool keep = (k == n);
+    if (!keep) {
+      const Op &c = ops[k];
+      int16_t ix0 = (p.x0 > c.x) ? p.x0 : c.x,
+              ix1 = (p.x1 < c.x + c.w) ? p.x1 : c.x + c.w,
+              iy0 = (p.y0 > c.y) ? p.y0 : c.y,
+              iy1 = (p.y1 < c.y + c.h) ? p.y1 : c.y + c.h;
+      uint8_t parts =
+          (p.y0 < iy0) + (iy1 < p.y1) + (p.x0 < ix0) + (ix1 < p.x1);
+      if (!parts)
+        continue; // Painted over entirely
+      uint32_t hidden = (uint32_t)(ix1 - ix0) * (iy1 - iy0);
+      if ((sp + parts <= ST77XX_LIST_STACK) &&
+          (display.pixelBytes(hidden) >
+           (uint32_t)(parts - 1) * ST77XX_WINDOW_COST)) {
+        // Bands above and below the occluder, then its left and right
+        Part band = {p.x0, p.y0, p.x1, iy0, (uint16_t)(k + 1)};
+        if (p.y0 < iy0)
+          stack[sp++] = band;
+        band.y0 = iy1;
+        band.y1 = p.y1;
+        if (iy1 < p.y1)
+          stack[sp++] = band;
+        band.y0 = iy0;
+        band.y1 = iy1;
+        band.x1 = ix0;
+        if (p.x0 < ix0)
+          stack[sp++] = band;
+        band.x0 = ix1;
+        band.x1 = p.x1;
+        if (ix1 < p.x1)
+          stack[sp++] = band;
+        continue;
+      }
+    }
+
+    Op part = op;
+    part.crop(p.x0, p.y0, p.x1, p.y1);
+    if (keep && (pieceCount < opMax))
+      pieces[pieceCount++] = part;
+    else
+      send(part);
+    shown = true;
+  }
+  if (!shown)
+    stats.culled++;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send one clipped operation, inside the replay transaction
+    @param  op  Operation
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::send(const Op &op) {
+  stats.drawn += op.area();
+  stats.bytes += op.send(display);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a pixel
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::drawPixel(int16_t x, int16_t y,
+                                           uint16_t color) {
+  Op op = {NULL, x, y, 1, 1, color, 0};
+  push(op);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a fill of the whole screen, following the display's
+            current rotation
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::fillScreen(uint16_t color) {
+  follow();
+  fillRect(0, 0, _width, _height, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a vertical line
+    @param  x      Top x coordinate
+    @param  y      Top y coordinate
+    @param  h      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::drawFastVLine(int16_t x, int16_t y,
+                                               int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a horizontal line
+    @param  x      Left x coordinate
+    @param  y      Left y coordinate
+    @param  w      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::drawFastHLine(int16_t x, int16_t y,
+                                               int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a filled rectangle as one operation
+    @param  x      Top left x coordinate
+    @param  y      Top left y coordinate
+    @param  w      Width in pixels, may be negative
+    @param  h      Height in pixels, may be negative
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::fillRect(int16_t x, int16_t y, int16_t w,
+                                          int16_t h, uint16_t color) {
+  if (!w || !h)
+    return;
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  Op op = {NULL, x, y, w, h, color, 0};
+  push(op);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record a 16-bit bitmap from RAM. Only the pointer is recorded,
+            so the pixels must stay unchanged until commit().
+    @param  x       Top left x coordinate
+    @param  y       Top left y coordinate
+    @param  bitmap  5-6-5 pixels, row by row
+    @param  w       Width in pixels
+    @param  h       Height in pixels
+*/
+/**************************************************************************/
+void Adafruit_ST77xxDisplayList::drawRGBBitmap(int16_t x, int16_t y,
+                                               uint16_t *bitmap, int16_t w,
+                                               int16_t h) {
+  if (!bitmap || (w <= 0) || (h <= 0))
+    return;
+  Op op = {bitmap, x, y, w, h, (uint16_t)w, 0};
+  push(op);
+}
@@ -0,0 +1,97 @@
+#ifndef _ADAFRUIT_ST77XXDISPLAYLIST_H_
+#define _ADAFRUIT_ST77XXDISPLAYLIST_H_
+
+#include "Adafruit_ST77xxDrawOp.h"
+
+/// Records drawing for a ST77xx display instead of sending it, and sends
+/// the frame on commit(): operations off screen are dropped, the parts of
+/// each one that later operations paint over are cut away, and what is
+/// left goes out top to bottom in one transaction. A full-screen background
+/// under a few panels then costs only the background still visible.
+class Adafruit_ST77xxDisplayList : public Adafruit_GFX {
+public:
+  Adafruit_ST77xxDisplayList(Adafruit_ST77xx &tft, uint16_t ops = 128);
+  ~Adafruit_ST77xxDisplayList(void);
+
+  bool begin(void);
+  uint32_t commit(void);
+  void discard(void);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w,
+                     int16_t h);
+
+  /*!
+    @brief  Operations recorded for the next commit()
+    @return Count
+  */
+  uint16_t getQueued(void) const { return opCount; }
+  /*!
+    @brief  Operations the last frame recorded. Adjacent fills of one color
+            that make a rectangle count as one.
+    @return Count
+  */
+  uint32_t getRecorded(void) const { return frame.recorded; }
+  /*!
+    @brief  Operations of the last frame that were entirely painted over
+    @return Count
+  */
+  uint32_t getCulled(void) const { return frame.culled; }
+  /*!
+    @brief  Operations of the last frame that were entirely off screen
+    @return Count
+  */
+  uint32_t getClipped(void) const { return frame.clipped; }
+  /*!
+    @brief  Pixels the last frame sent
+    @return Count
+  */
+  uint32_t getDrawnPixels(void) const { return frame.drawn; }
+  /*!
+    @brief  On-screen pixels of the last frame that were painted over, and
+            so not sent
+    @return Count
+  */
+  uint32_t getCulledPixels(void) const { return frame.culledPixels; }
+  /*!
+    @brief  Bus bytes the last frame sent
+    @return Byte count, including address window overhead
+  */
+  uint32_t getBytes(void) const { return frame.bytes; }
+  /*!
+    @brief  Bus bytes the last frame saved against drawing the recorded
+            operations as they came
+    @return Byte count, 0 if it saved nothing
+  */
+  uint32_t getSavedBytes(void) const {
+    return (frame.naiveBytes > frame.bytes) ? frame.naiveBytes - frame.bytes
+                                            : 0;
+  }
+
+private:
+  typedef ST77xxDrawOp Op;
+  struct Stats {
+    uint32_t recorded, culled, clipped, drawn, culledPixels, bytes,
+        naiveBytes;
+  };
+
+  void follow(void);
+  void push(const Op &op);
+  void replay(void);
+  void visible(uint16_t i, uint16_t n);
+  void send(const Op &op);
+
+  Adafruit_ST77xx &display;
+  Op *ops = NULL;      // Recorded operations
+  Op *pieces = NULL;   // Visible parts, while replaying
+  uint16_t opMax, opCount = 0, pieceCount = 0;
+  Stats stats = {},    // Frame being recorded
+      frame = {};      // Last committed frame
+};
+
+#endif // _ADAFRUIT_ST77XXDISPLAYLIST_H_
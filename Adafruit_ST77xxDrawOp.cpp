@@ -0,0 +1,60 @@
+#include "Adafruit_ST77xxDrawOp.h"
+
+/**************************************************************************/
+/*!
+    @brief  Take in the next operation where both are fills of the same
+            color, on the same display, that together make a rectangle
+    @param  op  Operation queued right after this one
+    @return true if op is now part of this one and needs no entry
+*/
+/**************************************************************************/
+bool ST77xxDrawOp::extend(const ST77xxDrawOp &op) {
+  if (pixels || op.pixels || (panel != op.panel) || (color != op.color))
+    return false;
+  if ((y == op.y) && (h == op.h) && (x + w == op.x)) {
+    w += op.w;
+    return true;
+  }
+  if ((x == op.x) && (w == op.w) && (y + h == op.y)) {
+    h += op.h;
+    return true;
+  }
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Cut the operation down to a rectangle within it, moving a
+            bitmap's start to match
+    @param  x0  Left edge, display coordinates
+    @param  y0  Top edge
+    @param  x1  Right edge, exclusive
+    @param  y1  Bottom edge, exclusive
+*/
+/**************************************************************************/
+void ST77xxDrawOp::crop(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  if (pixels)
+    pixels += (int32_t)(y0 - y) * color + (x0 - x);
+  x = x0;
+  y = y0;
+  w = x1 - x0;
+  h = y1 - y0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send the operation, inside a transaction the caller holds
+    @param  tft  Display, already clipped to
+    @return Bus bytes, including address window overhead
+*/
+/**************************************************************************/
+uint32_t ST77xxDrawOp::send(Adafruit_ST77xx &tft) const {
+  if (!pixels) {
+    tft.writeFillRect(x, y, w, h, color);
+  } else {
+    tft.setAddrWindow(x, y, w, h);
+    for (int16_t row = 0; row < h; row++)
+      tft.writePixels((uint16_t *)pixels + (int32_t)row * color, w);
+  }
+  return ST77XX_WINDOW_COST + tft.pixelBytes(area());
+}
@@ -0,0 +1,26 @@
+#ifndef _ADAFRUIT_ST77XXDRAWOP_H_
+#define _ADAFRUIT_ST77XXDRAWOP_H_
+
+#include "Adafruit_ST77xx.h"
+
+/// A fill or a bitmap queued for a ST77xx display, as Adafruit_ST77xxGroup
+/// and Adafruit_ST77xxDisplayList keep them until they send a frame. A
+/// bitmap may be a window into a larger image in RAM, so its row length
+/// is kept in place of the fill color.
+struct ST77xxDrawOp {
+  const uint16_t *pixels; ///< Bitmap, NULL for a fill
+  int16_t x, y, w, h;     ///< Display coordinates
+  uint16_t color;         ///< Fill color, or bitmap row length in pixels
+  uint8_t panel;          ///< Display in a group, 0 for a single display
+
+  bool extend(const ST77xxDrawOp &op);
+  void crop(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+  uint32_t send(Adafruit_ST77xx &tft) const;
+  /*!
+    @brief  Pixels covered
+    @return Width times height
+  */
+  uint32_t area(void) const { return (uint32_t)w * h; }
+};
+
+#endif // _ADAFRUIT_ST77XXDRAWOP_H_
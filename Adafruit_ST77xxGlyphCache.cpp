@@ -0,0 +1,140 @@
+#include "Adafruit_ST77xxGlyphCache.h"
+
+// Draws a glyph into a cache slot through Adafruit_GFX::drawChar(), so the
+// cached pixels are exactly those GFX would have sent
+class ST77xxGlyphTarget : public Adafruit_GFX {
+public:
+  ST77xxGlyphTarget(uint16_t *buf, uint8_t size_x, uint8_t size_y)
+      : Adafruit_GFX(6 * size_x, 8 * size_y), buf(buf) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x >= 0) && (y >= 0) && (x < WIDTH) && (y < HEIGHT))
+      buf[y * WIDTH + x] = (color >> 8) | (color << 8);
+  }
+
+private:
+  uint16_t *buf;
+};
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate a glyph cache. Call begin() to allocate it.
+    @param  glyphs   Glyphs held at once (at least 1)
+    @param  maxSize  Largest text size cached (1 to 15). Each slot takes
+                     96 bytes times its square, whatever size it holds.
+*/
+/**************************************************************************/
+Adafruit_ST77xxGlyphCache::Adafruit_ST77xxGlyphCache(uint8_t glyphs,
+                                                     uint8_t maxSize)
+    : glyphs(glyphs ? glyphs : 1),
+      maxSize((maxSize < 1) ? 1 : (maxSize > 15) ? 15 : maxSize),
+      slotWords(48 * this->maxSize * this->maxSize) {}
+
+Adafruit_ST77xxGlyphCache::~Adafruit_ST77xxGlyphCache(void) {
+  if (entries)
+    free(entries);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate the cache, empty
+    @return true on success, false if out of memory
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxGlyphCache::begin(void) {
+  if (entries)
+    return true;
+  // One block: keys first, so the pixels after them stay 16-bit aligned
+  entries = (Entry *)malloc(bytes());
+  if (!entries)
+    return false;
+  pixels = (uint16_t *)(entries + glyphs);
+  clear();
+  return true;
+}
+
+uint32_t Adafruit_ST77xxGlyphCache::bytes(void) const {
+  return (uint32_t)glyphs * (sizeof(Entry) + slotWords * 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Find a glyph, expanding it into the least recently used slot if
+            it is not cached
+    @param  c       Character, as passed to drawChar()
+    @param  color   Foreground 5-6-5 color
+    @param  bg      Background 5-6-5 color
+    @param  size_x  Horizontal text size
+    @param  size_y  Vertical text size
+    @param  cp437   Code page 437 character set, as set with cp437()
+    @return The glyph's 6 * size_x by 8 * size_y pixels, row by row in bus
+            byte order, valid until the next get() or clear(). NULL if the
+            size is too big for the cache or it is not allocated.
+*/
+/**************************************************************************/
+const uint16_t *Adafruit_ST77xxGlyphCache::get(unsigned char c,
+                                               uint16_t color, uint16_t bg,
+                                               uint8_t size_x, uint8_t size_y,
+                                               bool cp437) {
+  if (!entries || !size_x || !size_y || (size_x > maxSize) ||
+      (size_y > maxSize))
+    return NULL;
+  uint8_t size = (size_x << 4) | size_y, victim = 0;
+  tick++;
+  for (uint8_t i = 0; i < glyphs; i++) {
+    Entry &e = entries[i];
+    if (e.used && (e.c == c) && (e.color == color) && (e.bg == bg) &&
+        (e.size == size) && (e.cp437 == cp437)) {
+      e.used = tick;
+      hits++;
+      return pixels + (uint32_t)i * slotWords;
+    }
+    if (e.used < entries[victim].used)
+      victim = i; // Empty slots (0) go first
+  }
+
+  Entry &e = entries[victim];
+  uint16_t *slot = pixels + (uint32_t)victim * slotWords;
+  ST77xxGlyphTarget target(slot, size_x, size_y);
+  target.cp437(cp437);
+  target.drawChar(0, 0, c, color, bg, size_x, size_y);
+  e.used = tick;
+  e.color = color;
+  e.bg = bg;
+  e.c = c;
+  e.size = size;
+  e.cp437 = cp437;
+  misses++;
+  return slot;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Empty the cache, e.g. to free slots held by colors no longer
+            used. Statistics are kept.
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGlyphCache::clear(void) {
+  if (entries)
+    memset(entries, 0, glyphs * sizeof(Entry));
+  tick = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Zero the hit and miss counts
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGlyphCache::resetStats(void) { hits = misses = 0; }
+
+/**************************************************************************/
+/*!
+    @brief  Share of characters found in the cache since the last
+            resetStats()
+    @return Percent, 0 if nothing was drawn
+*/
+/**************************************************************************/
+uint8_t Adafruit_ST77xxGlyphCache::getHitRate(void) const {
+  uint32_t total = hits + misses;
+  return total ? (uint8_t)(100.0f * hits / total) : 0;
+}
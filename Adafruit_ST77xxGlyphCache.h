@@ -0,0 +1,67 @@
+#ifndef _ADAFRUIT_ST77XXGLYPHCACHE_H_
+#define _ADAFRUIT_ST77XXGLYPHCACHE_H_
+
+#include "Adafruit_ST77xx.h"
+
+/// Cache of classic font glyphs expanded to 5-6-5 pixels, for text drawn
+/// with a background color. Attached with Adafruit_ST77xx::setGlyphCache(),
+/// it lets each character go out as one address window and one block of
+/// pixels instead of a write per pixel. Glyphs are keyed on character,
+/// colors and text size; when the cache is full the least recently used
+/// one is replaced. Text in custom (GFXfont) fonts, transparent text and
+/// text sizes above the cache's maximum are drawn the usual way.
+class Adafruit_ST77xxGlyphCache {
+public:
+  Adafruit_ST77xxGlyphCache(uint8_t glyphs = 32, uint8_t maxSize = 1);
+  ~Adafruit_ST77xxGlyphCache(void);
+
+  bool begin(void);
+  const uint16_t *get(unsigned char c, uint16_t color, uint16_t bg,
+                      uint8_t size_x, uint8_t size_y, bool cp437 = false);
+  void clear(void);
+  void resetStats(void);
+  uint8_t getHitRate(void) const;
+
+  /*!
+    @brief  Characters found in the cache since the last resetStats()
+    @return Count
+  */
+  uint32_t getHits(void) const { return hits; }
+  /*!
+    @brief  Characters that had to be expanded since the last resetStats()
+    @return Count
+  */
+  uint32_t getMisses(void) const { return misses; }
+  /*!
+    @brief  RAM taken by the cache: glyph pixels and their keys
+    @return Bytes, 0 before a successful begin()
+  */
+  uint32_t getMemoryUsed(void) const { return entries ? bytes() : 0; }
+  /*!
+    @brief  Largest text size the cache holds glyphs for
+    @return Size, in each direction
+  */
+  uint8_t getMaxSize(void) const { return maxSize; }
+
+private:
+  struct Entry {
+    uint32_t used;         // Tick of the last lookup, 0 for an empty slot
+    uint16_t color, bg;    // Foreground and background, 5-6-5
+    unsigned char c;       // Character, before any CP437 adjustment
+    uint8_t size;          // size_x in the high nibble, size_y in the low
+    bool cp437;            // Code page 437 character set
+  };
+
+  uint32_t bytes(void) const;
+
+  uint8_t glyphs;          // Slots
+  uint8_t maxSize;         // Largest size_x and size_y cached
+  uint16_t slotWords;      // Pixels per slot
+  Entry *entries = NULL;   // Keys, followed by the pixels of every slot
+  uint16_t *pixels = NULL; // Slot pixels, in bus byte order
+  uint32_t tick = 0;       // Lookup counter, for least recently used
+  uint32_t hits = 0,       // Lookups found in the cache
+      misses = 0;          // Lookups that expanded a glyph
+};
+
+#endif // _ADAFRUIT_ST77XXGLYPHCACHE_H_
@@ -0,0 +1,376 @@
+#include "Adafruit_ST77xxGroup.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate a display group
+    @param  w  Width of the canvas spanning all displays
+    @param  h  Height of the canvas spanning all displays
+*/
+/**************************************************************************/
+Adafruit_ST77xxGroup::Adafruit_ST77xxGroup(uint16_t w, uint16_t h)
+    : Adafruit_GFX(w, h), panels() {}
+
+/**************************************************************************/
+/*!
+    @brief  Free the queue
+*/
+/**************************************************************************/
+Adafruit_ST77xxGroup::~Adafruit_ST77xxGroup(void) {
+  if (ops)
+    free(ops);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Add a display on the shared bus. Call after its init() and
+            setRotation(), as its size is taken from then on.
+    @param  tft  Display
+    @param  x    Canvas x coordinate of the display's top left corner
+    @param  y    Canvas y coordinate of the display's top left corner
+    @return The display's number in the group, -1 if the group is full
+*/
+/**************************************************************************/
+int8_t Adafruit_ST77xxGroup::addPanel(Adafruit_ST77xx &tft, int16_t x,
+                                      int16_t y) {
+  if (panelCount == ST77XX_MAX_PANELS)
+    return -1;
+  Panel &p = panels[panelCount];
+  p.tft = &tft;
+  p.x = x;
+  p.y = y;
+  p.pending = 0;
+  p.latency = p.maxLatency = p.bytes = 0;
+  return panelCount++;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate the queue. Without it, every update is sent as it is
+            drawn, in a transaction of its own.
+    @param  ops  Draw operations queued before flush() is forced (at least
+                 1). Each takes 16 bytes on 32-bit cores.
+    @return true on success, false if out of memory
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxGroup::begin(uint16_t ops) {
+  if (!ops)
+    ops = 1;
+  if (this->ops && (ops <= opMax))
+    return true;
+  flush();
+  if (this->ops)
+    free(this->ops);
+  this->ops = (Op *)malloc(ops * sizeof(Op));
+  opMax = this->ops ? ops : 0;
+  resetStats();
+  return this->ops != NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Queue a filled rectangle for one display
+    @param  panel  Display, in the order added
+    @param  x      Top left x coordinate on that display
+    @param  y      Top left y coordinate on that display
+    @param  w      Width in pixels, may be negative
+    @param  h      Height in pixels, may be negative
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::queueFill(uint8_t panel, int16_t x, int16_t y,
+                                     int16_t w, int16_t h, uint16_t color) {
+  if ((panel >= panelCount) || !w || !h)
+    return;
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  Adafruit_ST77xx &tft = *panels[panel].tft;
+  int16_t x1 = x + w, y1 = y + h;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x1 > tft.width())
+    x1 = tft.width();
+  if (y1 > tft.height())
+    y1 = tft.height();
+  if ((x >= x1) || (y >= y1))
+    return;
+  Op op = {NULL, x, y, (int16_t)(x1 - x), (int16_t)(y1 - y), color, panel};
+  push(panel, op);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Queue a 16-bit bitmap for one display. Only the pointer is
+            queued, so the pixels must stay unchanged until flush().
+    @param  panel   Display, in the order added
+    @param  x       Top left x coordinate on that display
+    @param  y       Top left y coordinate on that display
+    @param  pixels  5-6-5 pixels in RAM, row by row
+    @param  w       Width in pixels
+    @param  h       Height in pixels
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::queueBitmap(uint8_t panel, int16_t x, int16_t y,
+                                       const uint16_t *pixels, int16_t w,
+                                       int16_t h) {
+  if ((panel >= panelCount) || !pixels || (w <= 0) || (h <= 0))
+    return;
+  Adafruit_ST77xx &tft = *panels[panel].tft;
+  int16_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int16_t x1 = ((x + w) > tft.width()) ? tft.width() - x : w,
+          y1 = ((y + h) > tft.height()) ? tft.height() - y : h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return;
+  Op op = {pixels, x, y, w, h, (uint16_t)w, panel};
+  op.crop(x + x0, y + y0, x + x1, y + y1);
+  push(panel, op);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Add an operation to the queue, extending the previous one
+            instead where both are fills of the same color that together
+            make a rectangle. Flushes first if the queue is full.
+    @param  panel  Display
+    @param  op     Operation, clipped to the display
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::push(uint8_t panel, const Op &op) {
+  Panel &p = panels[panel];
+  if (!ops) {
+    p.pending = 1;
+    p.queuedAt = micros();
+    send(panel, &op, 1);
+    return;
+  }
+  if (opCount && ops[opCount - 1].extend(op))
+    return;
+  if (opCount == opMax)
+    flush();
+  if (!p.pending++)
+    p.queuedAt = micros();
+  ops[opCount++] = op;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send everything queued, one transaction per display
+    @return Bus bytes sent, including address window overhead
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxGroup::flush(void) {
+  uint32_t bytes = 0;
+  for (uint8_t p = 0; p < panelCount; p++) {
+    if (panels[p].pending)
+      bytes += send(p, ops, opCount);
+  }
+  opCount = 0;
+  return bytes;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Send one display's operations in a single transaction and
+            account for it
+    @param  panel  Display
+    @param  list   Operations, of any display
+    @param  count  Number of operations
+    @return Bus bytes sent, including address window overhead
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxGroup::send(uint8_t panel, const Op *list,
+                                    uint16_t count) {
+  Panel &p = panels[panel];
+  Adafruit_ST77xx &tft = *p.tft;
+  uint32_t bytes = 0;
+  // Another display's asynchronous transfer may still hold the bus
+  for (uint8_t i = 0; i < panelCount; i++)
+    panels[i].tft->fence();
+  uint32_t t0 = micros();
+  tft.startWrite();
+  for (uint16_t i = 0; i < count; i++) {
+    if (list[i].panel == panel)
+      bytes += list[i].send(tft);
+  }
+  tft.endWrite();
+  uint32_t t1 = micros();
+
+  busyUs += t1 - t0;
+  transactions++;
+  flushedOps += p.pending;
+  p.pending = 0;
+  p.latency = t1 - p.queuedAt;
+  if (p.latency > p.maxLatency)
+    p.maxLatency = p.latency;
+  p.bytes += bytes;
+  return bytes;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Queue an area of the canvas for every display it falls on
+    @param  x       Top left x coordinate on the canvas
+    @param  y       Top left y coordinate on the canvas
+    @param  w       Width in pixels, positive
+    @param  h       Height in pixels, positive
+    @param  color   Fill color, if pixels is NULL
+    @param  pixels  Bitmap of w by h pixels, NULL for a fill
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::drawArea(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint16_t color,
+                                    const uint16_t *pixels) {
+  // Clip to the canvas first, so displays hanging off it stay clipped too
+  int16_t x0 = (x < 0) ? 0 : x, y0 = (y < 0) ? 0 : y;
+  int16_t x1 = ((x + w) > _width) ? _width : x + w,
+          y1 = ((y + h) > _height) ? _height : y + h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return;
+  for (uint8_t i = 0; i < panelCount; i++) {
+    const Panel &p = panels[i];
+    int16_t px0 = (x0 > p.x) ? x0 : p.x, py0 = (y0 > p.y) ? y0 : p.y;
+    int16_t px1 = p.x + p.tft->width(), py1 = p.y + p.tft->height();
+    if (px1 > x1)
+      px1 = x1;
+    if (py1 > y1)
+      py1 = y1;
+    if ((px0 >= px1) || (py0 >= py1))
+      continue;
+    if (pixels) {
+      // Clip rows and columns here, so the bitmap keeps its row length
+      Op op = {pixels, (int16_t)(x - p.x), (int16_t)(y - p.y), w, h,
+               (uint16_t)w, i};
+      op.crop(px0 - p.x, py0 - p.y, px1 - p.x, py1 - p.y);
+      push(i, op);
+    } else {
+      queueFill(i, px0 - p.x, py0 - p.y, px1 - px0, py1 - py0, color);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a pixel on the canvas
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  drawArea(x, y, 1, 1, color, NULL);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill the whole canvas with a color
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::fillScreen(uint16_t color) {
+  drawArea(0, 0, _width, _height, color, NULL);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a vertical line on the canvas
+    @param  x      Top x coordinate
+    @param  y      Top y coordinate
+    @param  h      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                         uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a horizontal line on the canvas
+    @param  x      Left x coordinate
+    @param  y      Left y coordinate
+    @param  w      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                         uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle on the canvas, as one operation per display
+    @param  x      Top left x coordinate
+    @param  y      Top left y coordinate
+    @param  w      Width in pixels, may be negative
+    @param  h      Height in pixels, may be negative
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::fillRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  if (w && h)
+    drawArea(x, y, w, h, color, NULL);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a 16-bit bitmap from RAM on the canvas. Only the pointer
+            is queued, so the pixels must stay unchanged until flush().
+    @param  x       Top left x coordinate
+    @param  y       Top left y coordinate
+    @param  bitmap  5-6-5 pixels, row by row
+    @param  w       Width in pixels
+    @param  h       Height in pixels
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::drawRGBBitmap(int16_t x, int16_t y,
+                                         uint16_t *bitmap, int16_t w,
+                                         int16_t h) {
+  if (bitmap && (w > 0) && (h > 0))
+    drawArea(x, y, w, h, 0, bitmap);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Zero the bus and latency statistics and restart the
+            utilization measurement
+*/
+/**************************************************************************/
+void Adafruit_ST77xxGroup::resetStats(void) {
+  statsFrom = micros();
+  busyUs = flushedOps = transactions = 0;
+  for (uint8_t i = 0; i < panelCount; i++)
+    panels[i].latency = panels[i].maxLatency = panels[i].bytes = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Share of the time since resetStats() the bus spent sending
+            flushed updates
+    @return Percent
+*/
+/**************************************************************************/
+uint8_t Adafruit_ST77xxGroup::getBusUtilization(void) const {
+  uint32_t elapsed = micros() - statsFrom;
+  if (!elapsed)
+    return 0;
+  float percent = 100.0f * busyUs / elapsed;
+  return (percent > 100.0f) ? 100 : (uint8_t)percent;
+}
@@ -0,0 +1,123 @@
+#ifndef _ADAFRUIT_ST77XXGROUP_H_
+#define _ADAFRUIT_ST77XXGROUP_H_
+
+#include "Adafruit_ST77xxDrawOp.h"
+
+#define ST77XX_MAX_PANELS 4 ///< Displays one group can drive
+
+/// Several displays sharing one SPI bus, each with its own CS pin. Drawing
+/// is queued instead of sent: flush() then sends each display's updates in
+/// a single transaction, so the bus switches chip select once per display
+/// per flush rather than once per draw call. The group is also a canvas the
+/// size of the whole arrangement: each display shows the part of it at the
+/// offset it was added with, and drawing is clipped to each display.
+class Adafruit_ST77xxGroup : public Adafruit_GFX {
+public:
+  Adafruit_ST77xxGroup(uint16_t w, uint16_t h);
+  ~Adafruit_ST77xxGroup(void);
+
+  int8_t addPanel(Adafruit_ST77xx &tft, int16_t x = 0, int16_t y = 0);
+  bool begin(uint16_t ops = 64);
+
+  void queueFill(uint8_t panel, int16_t x, int16_t y, int16_t w, int16_t h,
+                 uint16_t color);
+  void queueBitmap(uint8_t panel, int16_t x, int16_t y,
+                   const uint16_t *pixels, int16_t w, int16_t h);
+  uint32_t flush(void);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w,
+                     int16_t h);
+  /*!
+    @brief  The canvas is laid out in the displays' own orientation; rotate
+            the displays before adding them instead
+    @param  r  Ignored
+  */
+  void setRotation(uint8_t r) { (void)r; }
+
+  void resetStats(void);
+  uint8_t getBusUtilization(void) const;
+  /*!
+    @brief  Number of displays added
+    @return Count
+  */
+  uint8_t getPanelCount(void) const { return panelCount; }
+  /*!
+    @brief  Draw operations waiting for flush()
+    @return Count
+  */
+  uint16_t getQueued(void) const { return opCount; }
+  /*!
+    @brief  Draw operations flushed since the last resetStats(). Sent one
+            by one, each would have been a transaction of its own.
+    @return Count
+  */
+  uint32_t getOps(void) const { return flushedOps; }
+  /*!
+    @brief  Bus transactions (chip select assertions) flushes made since
+            the last resetStats()
+    @return Count
+  */
+  uint32_t getTransactions(void) const { return transactions; }
+  /*!
+    @brief  Time the bus spent in flush transactions since resetStats()
+    @return Microseconds
+  */
+  uint32_t getBusyTime(void) const { return busyUs; }
+  /*!
+    @brief  Time from a display's first queued update to the end of its
+            transaction, in the last flush that sent it anything
+    @param  panel  Display, in the order added
+    @return Microseconds
+  */
+  uint32_t getLatency(uint8_t panel) const {
+    return (panel < panelCount) ? panels[panel].latency : 0;
+  }
+  /*!
+    @brief  Longest getLatency() since the last resetStats()
+    @param  panel  Display, in the order added
+    @return Microseconds
+  */
+  uint32_t getMaxLatency(uint8_t panel) const {
+    return (panel < panelCount) ? panels[panel].maxLatency : 0;
+  }
+  /*!
+    @brief  Bus bytes sent to a display since the last resetStats()
+    @param  panel  Display, in the order added
+    @return Byte count, including address window overhead
+  */
+  uint32_t getBytes(uint8_t panel) const {
+    return (panel < panelCount) ? panels[panel].bytes : 0;
+  }
+
+private:
+  struct Panel {
+    Adafruit_ST77xx *tft;
+    int16_t x, y;        // Offset on the canvas
+    uint16_t pending;    // Queued operations
+    uint32_t queuedAt;   // micros() when the first of them was queued
+    uint32_t latency,    // Last queue-to-sent time
+        maxLatency;      // Longest since resetStats()
+    uint32_t bytes;      // Bus bytes since resetStats()
+  };
+  typedef ST77xxDrawOp Op; // Clipped to its display
+
+  void push(uint8_t panel, const Op &op);
+  void drawArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color,
+                const uint16_t *pixels);
+  uint32_t send(uint8_t panel, const Op *list, uint16_t count);
+
+  Panel panels[ST77XX_MAX_PANELS];
+  uint8_t panelCount = 0;
+  Op *ops = NULL;
+  uint16_t opMax = 0, opCount = 0;
+
+  uint32_t statsFrom = 0, busyUs = 0, flushedOps = 0, transactions = 0;
+};
+
+#endif // _ADAFRUIT_ST77XXGROUP_H_
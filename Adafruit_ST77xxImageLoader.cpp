@@ -0,0 +1,188 @@
+#include "Adafruit_ST77xxImageLoader.h"
+
+// Little-endian fields of the BMP headers
+static inline uint16_t le16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+static inline uint32_t le32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate a loader for a pipeline
+    @param  pipeline  Double-buffered pipeline the images go through. Each
+                      push holds as many rows as fit in one of its buffers.
+    @param  readSize  Bytes asked of the stream at a time (at least 36).
+                      512 suits an SD card's sectors.
+    @param  sharedBus true if the stream reads from a device on the
+                      display's SPI bus, e.g. an SD card on the same SCK
+                      and MOSI with its own CS. Each band is then sent in
+                      full, and the display deselected, before the stream
+                      is read again, so there is no overlap. false only for
+                      storage on its own bus (SDIO, a second SPI port,
+                      flash in the MCU).
+*/
+/**************************************************************************/
+Adafruit_ST77xxImageLoader::Adafruit_ST77xxImageLoader(
+    Adafruit_ST77xxAsync &pipeline, uint16_t readSize, bool sharedBus)
+    : pipeline(pipeline), readSize((readSize < 36) ? 36 : readSize),
+      sharedBus(sharedBus) {}
+
+Adafruit_ST77xxImageLoader::~Adafruit_ST77xxImageLoader(void) {
+  if (raw)
+    free(raw);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate the read buffer. The pipeline needs its own begin().
+    @return true on success, false if out of memory
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxImageLoader::begin(void) {
+  if (!raw)
+    raw = (uint8_t *)malloc(readSize);
+  return raw != NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a BMP image read from a stream. 16-bit (5-6-5 or 5-5-5),
+            24-bit and 32-bit uncompressed images are supported. Rows that
+            fall off screen are read and dropped; reading stops after the
+            last visible one. On a shared bus every band has been sent
+            on return; otherwise the last may still be in flight, and the
+            pipeline's wait() ends it.
+    @param  src  Stream positioned at the start of the file
+    @param  x    Top left corner horizontal coordinate
+    @param  y    Top left corner vertical coordinate
+    @return false if the format is not supported, the stream ended early
+            or begin() was not called
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxImageLoader::drawBMP(Stream &src, int16_t x, int16_t y) {
+  if (!raw || !pipeline.getBuffer())
+    return false;
+
+  // File header and the start of the info header
+  if (!readFully(src, raw, 18) || (raw[0] != 'B') || (raw[1] != 'M'))
+    return false;
+  uint32_t offset = le32(raw + 10), consumed = 54;
+  if ((le32(raw + 14) < 40) || !readFully(src, raw, 36))
+    return false; // OS/2 headers are not supported
+  int32_t w = (int32_t)le32(raw), h = (int32_t)le32(raw + 4);
+  uint16_t bits = le16(raw + 10);
+  uint32_t compression = le32(raw + 12);
+  bool is555 = (bits == 16);
+  if (compression == 3) { // BI_BITFIELDS: color masks follow the 40 bytes
+    if (!readFully(src, raw, 12))
+      return false;
+    consumed += 12;
+    uint32_t r = le32(raw), g = le32(raw + 4), b = le32(raw + 8);
+    if ((bits == 16) && (r == 0xF800) && (g == 0x07E0) && (b == 0x001F))
+      is555 = false;
+    else if (!((bits == 16) && (r == 0x7C00) && (g == 0x03E0) &&
+               (b == 0x001F)) &&
+             !((bits == 32) && (r == 0xFF0000) && (g == 0xFF00) &&
+               (b == 0xFF)))
+      return false;
+  } else if (compression) {
+    return false; // Run-length encoded
+  }
+  if (((bits != 16) && (bits != 24) && (bits != 32)) || (w <= 0) ||
+      (w > 0x7FFF) || !h || (h < -0x7FFF) || (h > 0x7FFF) ||
+      (offset < consumed) || !skip(src, offset - consumed))
+    return false;
+  bool bottomUp = h > 0; // The usual order: last row first
+  if (!bottomUp)
+    h = -h;
+  width = w;
+  height = h;
+  bpp = bits;
+  rgb555 = is555;
+  rowBytes = ((uint32_t)w * bits / 8 + 3) & ~3;
+
+  // Visible part of the image, in image coordinates
+  Adafruit_ST77xx &tft = pipeline.getDisplay();
+  int32_t x0 = (x < 0) ? -x : 0, y0 = (y < 0) ? -y : 0;
+  int32_t x1 = ((x + w) > tft.width()) ? tft.width() - x : w,
+          y1 = ((y + h) > tft.height()) ? tft.height() - y : h;
+  if ((x0 >= x1) || (y0 >= y1))
+    return true; // Valid image, nothing to draw
+  uint16_t visible = x1 - x0;
+  uint16_t band = pipeline.getBufferPixels() / visible; // Rows per push
+  if (!band)
+    return false;
+
+  // Rows in file order; those before the visible ones are dropped
+  for (int32_t r = bottomUp ? h - y1 : y0; r > 0; r--) {
+    if (!skip(src, rowBytes))
+      return false;
+  }
+  uint16_t rows = y1 - y0;
+  for (uint16_t done = 0; done < rows;) {
+    uint16_t n = ((rows - done) < band) ? rows - done : band;
+    // The free buffer: the other one may still be on its way out
+    uint16_t *buf = pipeline.getBuffer();
+    for (uint16_t r = 0; r < n; r++) {
+      uint16_t *out = buf + (uint32_t)(bottomUp ? n - 1 - r : r) * visible;
+      if (!readRow(src, out, x0, x1))
+        return false;
+    }
+    int32_t top = bottomUp ? y1 - done - n : y0 + done;
+    pipeline.push(x + x0, y + top, visible, n);
+    done += n;
+  }
+  if (sharedBus) // The caller's next file operation uses the bus too
+    pipeline.wait();
+  return true;
+}
+
+// Read exactly n bytes, or fail. A push leaves the display selected until
+// the pipeline finishes it, which must happen before a device on the same
+// bus is selected.
+bool Adafruit_ST77xxImageLoader::readFully(Stream &src, uint8_t *buf,
+                                           uint16_t n) {
+  if (sharedBus)
+    pipeline.wait();
+  return src.readBytes(buf, n) == n;
+}
+
+// Read and drop n bytes; a Stream cannot seek
+bool Adafruit_ST77xxImageLoader::skip(Stream &src, uint32_t n) {
+  while (n) {
+    uint16_t m = (n < readSize) ? n : readSize;
+    if (!readFully(src, raw, m))
+      return false;
+    n -= m;
+  }
+  return true;
+}
+
+// Read one row of the file, padding included, and convert its columns
+// x0 to x1 - 1 to 5-6-5
+bool Adafruit_ST77xxImageLoader::readRow(Stream &src, uint16_t *out,
+                                         int16_t x0, int16_t x1) {
+  uint8_t bytes = bpp / 8;
+  uint16_t piece = (readSize / bytes) * bytes; // Whole pixels per read
+  for (uint32_t done = 0; done < rowBytes;) {
+    uint16_t n = ((rowBytes - done) < piece) ? rowBytes - done : piece;
+    if (!readFully(src, raw, n))
+      return false;
+    // Pixels in this piece, the visible ones; padding counts past x1
+    int32_t first = done / bytes, last = (done + n) / bytes;
+    int32_t a = (first > x0) ? first : x0, b = (last < x1) ? last : x1;
+    for (int32_t i = a; i < b; i++) {
+      const uint8_t *p = raw + (i - first) * bytes;
+      if (bytes == 2) {
+        uint16_t v = le16(p);
+        out[i - x0] =
+            rgb555 ? ((v << 1) & 0xFFC0) | ((v >> 4) & 0x20) | (v & 0x1F) : v;
+      } else { // Blue, green, red(, unused)
+        out[i - x0] = ((p[2] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[0] >> 3);
+      }
+    }
+    done += n;
+  }
+  return true;
+}
@@ -0,0 +1,53 @@
+#ifndef _ADAFRUIT_ST77XXIMAGELOADER_H_
+#define _ADAFRUIT_ST77XXIMAGELOADER_H_
+
+#include "Adafruit_ST77xxAsync.h"
+
+/// Streams BMP images from storage, such as an SD card File or any other
+/// Stream, through an Adafruit_ST77xxAsync pipeline. While one band of rows
+/// is on its way to the display, the next is read and converted into the
+/// other buffer, so an image loads in about the time of the slower of the
+/// two rather than their sum. Rows are taken in file order, bottom-up or
+/// top-down, and nothing bigger than the pipeline's buffers is needed.
+/// Reads only overlap transfers where the pipeline uses DMA and the storage
+/// is not on the display's SPI bus. Storage on the same bus, such as the SD
+/// slot of most Adafruit display breakouts, must be declared as shared: each
+/// transfer is then finished, and the display deselected, before the next
+/// read.
+class Adafruit_ST77xxImageLoader {
+public:
+  Adafruit_ST77xxImageLoader(Adafruit_ST77xxAsync &pipeline,
+                             uint16_t readSize = 512, bool sharedBus = true);
+  ~Adafruit_ST77xxImageLoader(void);
+
+  bool begin(void);
+  bool drawBMP(Stream &src, int16_t x, int16_t y);
+
+  /*!
+    @brief  Width of the last image drawBMP() read a header of
+    @return Pixels
+  */
+  int16_t getWidth(void) const { return width; }
+  /*!
+    @brief  Height of the last image drawBMP() read a header of
+    @return Pixels
+  */
+  int16_t getHeight(void) const { return height; }
+
+private:
+  bool readFully(Stream &src, uint8_t *buf, uint16_t n);
+  bool skip(Stream &src, uint32_t n);
+  bool readRow(Stream &src, uint16_t *out, int16_t x0, int16_t x1);
+
+  Adafruit_ST77xxAsync &pipeline;
+  uint16_t readSize;     // Bytes per read from the stream
+  uint8_t *raw = NULL;   // readSize bytes of file data
+  int16_t width = 0,     // Width of the last image
+      height = 0;        // Height of the last image
+  uint8_t bpp = 0;       // Its bits per pixel: 16, 24 or 32
+  bool rgb555 = false;   // 16-bit pixels are X1R5G5B5, not R5G6B5
+  uint32_t rowBytes = 0; // Bytes per row in the file, padding included
+  bool sharedBus;         // Storage is on the display's SPI bus
+};
+
+#endif // _ADAFRUIT_ST77XXIMAGELOADER_H_
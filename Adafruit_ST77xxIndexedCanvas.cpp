@@ -0,0 +1,418 @@
+#include "Adafruit_ST77xxIndexedCanvas.h"
+
+// Default 4-bit palette: the 16 classic PC text mode colors
+static const uint16_t PROGMEM palette16[16] = {
+    0x0000, 0x0015, 0x0540, 0x0555, 0xA800, 0xA815, 0xAAA0, 0xAD55,
+    0x52AA, 0x52BF, 0x57EA, 0x57FF, 0xFAAA, 0xFABF, 0xFFEA, 0xFFFF};
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate an indexed-color canvas. Call begin() to allocate
+            it.
+    @param  w     Canvas width in pixels
+    @param  h     Canvas height in pixels
+    @param  bits  Bits per pixel: 4 (16 colors) or 8 (256 colors)
+*/
+/**************************************************************************/
+Adafruit_ST77xxIndexedCanvas::Adafruit_ST77xxIndexedCanvas(uint16_t w,
+                                                           uint16_t h,
+                                                           uint8_t bits)
+    : Adafruit_GFX(w, h), bits((bits == 4) ? 4 : 8),
+      stride((bits == 4) ? (w + 1) / 2 : w) {}
+
+/**************************************************************************/
+/*!
+    @brief  Free the canvas
+*/
+/**************************************************************************/
+Adafruit_ST77xxIndexedCanvas::~Adafruit_ST77xxIndexedCanvas(void) {
+  if (palette)
+    free(palette);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate the canvas, its palette and a one-row line buffer, and
+            load the default palette: the 16 PC text mode colors for 4 bits,
+            3-3-2 RGB for 8 bits. The canvas starts at index 0.
+    @return true on success, false if the memory could not be allocated
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxIndexedCanvas::begin(void) {
+  if (palette)
+    return true;
+  uint16_t colors = 1 << bits;
+  // One block: palette and line buffer first, so both stay 16-bit aligned
+  palette =
+      (uint16_t *)malloc((colors + WIDTH) * 2 + (uint32_t)stride * HEIGHT);
+  if (!palette)
+    return false;
+  line = palette + colors;
+  buffer = (uint8_t *)(line + WIDTH);
+
+  for (uint16_t i = 0; i < colors; i++) {
+    if (bits == 4) {
+      setPaletteColor(i, pgm_read_word(&palette16[i]));
+    } else {
+      uint8_t r = i >> 5, g = (i >> 2) & 7, b = i & 3;
+      setPaletteColor(i, ((r * 31 / 7) << 11) | ((g * 63 / 7) << 5) |
+                             (b * 31 / 3));
+    }
+  }
+  memset(buffer, 0, (uint32_t)stride * HEIGHT);
+  markAllDirty();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Push the rows changed since the last flush to a display, each
+            expanded through the palette. Everything is pushed after a
+            palette change.
+    @param  tft  Display to draw on
+    @param  x    Display x coordinate of the canvas' top left corner
+    @param  y    Display y coordinate of the canvas' top left corner
+    @return Bus bytes sent, including address window overhead
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxIndexedCanvas::flush(Adafruit_ST77xx &tft, int16_t x,
+                                             int16_t y) {
+  // Rows and columns of the canvas that land on the display
+  int16_t top = dirtyTop, bottom = dirtyBottom, left = 0, right = WIDTH - 1;
+  dirtyTop = 0;
+  dirtyBottom = -1;
+  if (!buffer)
+    return 0;
+  if (y + top < 0)
+    top = -y;
+  if (y + bottom >= tft.height())
+    bottom = tft.height() - 1 - y;
+  if (x < 0)
+    left = -x;
+  if (x + right >= tft.width())
+    right = tft.width() - 1 - x;
+  if ((bottom < top) || (right < left))
+    return 0;
+
+  uint16_t w = right - left + 1;
+  tft.startWrite();
+  tft.setAddrWindow(x + left, y + top, w, bottom - top + 1);
+  for (int16_t row = top; row <= bottom; row++) {
+    const uint8_t *src = &buffer[(int32_t)row * stride];
+    uint16_t *out = line;
+    if (bits == 8) {
+      src += left;
+      for (uint16_t i = 0; i < w; i++)
+        *out++ = palette[*src++];
+    } else {
+      src += left / 2;
+      int16_t col = left;
+      if (col & 1) { // Starts on a low nibble
+        *out++ = palette[*src++ & 0x0F];
+        col++;
+      }
+      for (; col + 1 <= right; col += 2) {
+        uint8_t pair = *src++;
+        *out++ = palette[pair >> 4];
+        *out++ = palette[pair & 0x0F];
+      }
+      if (col == right)
+        *out++ = palette[*src >> 4];
+    }
+    tft.writePixels(line, w, true, true); // Palette is in bus byte order
+  }
+  tft.endWrite();
+  return ST77XX_WINDOW_COST + tft.pixelBytes((uint32_t)w * (bottom - top + 1));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a pixel to the canvas
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  Palette index
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::drawPixel(int16_t x, int16_t y,
+                                             uint16_t color) {
+  if (!buffer || (x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+  if (dirtyBottom < dirtyTop)
+    dirtyTop = dirtyBottom = y;
+  else if (y < dirtyTop)
+    dirtyTop = y;
+  else if (y > dirtyBottom)
+    dirtyBottom = y;
+
+  uint8_t *p = &buffer[(int32_t)y * stride];
+  if (bits == 8)
+    p[x] = color;
+  else if (x & 1)
+    p[x / 2] = (p[x / 2] & 0xF0) | (color & 0x0F);
+  else
+    p[x / 2] = (p[x / 2] & 0x0F) | ((color & 0x0F) << 4);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill the canvas with one palette index
+    @param  color  Palette index
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::fillScreen(uint16_t color) {
+  fillRaw(0, 0, WIDTH, HEIGHT, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a vertical line to the canvas
+    @param  x      Top x coordinate
+    @param  y      Top y coordinate
+    @param  h      Length in pixels
+    @param  color  Palette index
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::drawFastVLine(int16_t x, int16_t y,
+                                                 int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a horizontal line to the canvas
+    @param  x      Left x coordinate
+    @param  y      Left y coordinate
+    @param  w      Length in pixels
+    @param  color  Palette index
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::drawFastHLine(int16_t x, int16_t y,
+                                                 int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle on the canvas
+    @param  x      Top left x coordinate
+    @param  y      Top left y coordinate
+    @param  w      Width in pixels, may be negative
+    @param  h      Height in pixels, may be negative
+    @param  color  Palette index
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::fillRect(int16_t x, int16_t y, int16_t w,
+                                            int16_t h, uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  int16_t x1 = x + w - 1, y1 = y + h - 1;
+  if (!w || !h || (x >= _width) || (y >= _height) || (x1 < 0) || (y1 < 0))
+    return;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x1 >= _width)
+    x1 = _width - 1;
+  if (y1 >= _height)
+    y1 = _height - 1;
+
+  // Into the unrotated buffer layout
+  switch (rotation) {
+  case 0:
+    fillRaw(x, y, x1 - x + 1, y1 - y + 1, color);
+    break;
+  case 1:
+    fillRaw(WIDTH - 1 - y1, x, y1 - y + 1, x1 - x + 1, color);
+    break;
+  case 2:
+    fillRaw(WIDTH - 1 - x1, HEIGHT - 1 - y1, x1 - x + 1, y1 - y + 1, color);
+    break;
+  default:
+    fillRaw(y, HEIGHT - 1 - x1, y1 - y + 1, x1 - x + 1, color);
+    break;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read a pixel back
+    @param  x  x coordinate
+    @param  y  y coordinate
+    @return Palette index, 0 if outside the canvas
+*/
+/**************************************************************************/
+uint8_t Adafruit_ST77xxIndexedCanvas::getPixel(int16_t x, int16_t y) const {
+  if (!buffer || (x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return 0;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+  if (bits == 8)
+    return buffer[(int32_t)y * stride + x];
+  uint8_t pair = buffer[(int32_t)y * stride + x / 2];
+  return (x & 1) ? (pair & 0x0F) : (pair >> 4);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Load part of the palette. The next flush() pushes everything.
+    @param  colors  16-bit 5-6-5 colors
+    @param  count   Number of colors
+    @param  first   Palette index of the first color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::setPalette(const uint16_t *colors,
+                                              uint16_t count, uint8_t first) {
+  for (uint16_t i = 0; i < count; i++)
+    setPaletteColor(first + i, colors[i]);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Change one palette entry. The next flush() pushes everything.
+    @param  index  Palette index; 0 to 15 with 4 bits per pixel
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::setPaletteColor(uint8_t index,
+                                                   uint16_t color) {
+  if (!palette || (index >> bits))
+    return;
+  palette[index] = (color >> 8) | (color << 8);
+  markAllDirty();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read a palette entry
+    @param  index  Palette index
+    @return 16-bit 5-6-5 color
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xxIndexedCanvas::getPaletteColor(uint8_t index) const {
+  if (!palette || (index >> bits))
+    return 0;
+  uint16_t c = palette[index];
+  return (c >> 8) | (c << 8);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Rotate a range of palette entries, for color cycling effects:
+            pixels of each index in the range take the color of the next
+            (or previous) one, without redrawing anything
+    @param  first  First palette index of the range
+    @param  count  Number of entries in the range
+    @param  steps  Entries to rotate by; positive moves colors to higher
+                   indices
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::rotatePalette(uint8_t first, uint8_t count,
+                                                 int8_t steps) {
+  if (!palette || (count < 2) || ((uint16_t)first + count > (1U << bits)))
+    return;
+  uint16_t *p = &palette[first];
+  int16_t n = steps % count;
+  if (n < 0)
+    n += count;
+  while (n--) { // One place at a time; palettes are short
+    uint16_t last = p[count - 1];
+    memmove(p + 1, p, (count - 1) * 2);
+    p[0] = last;
+  }
+  markAllDirty();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Have the next flush() push the whole canvas
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::markAllDirty(void) {
+  dirtyTop = 0;
+  dirtyBottom = HEIGHT - 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle of the buffer and record the rows changed
+    @param  x      Left column, unrotated buffer coordinates, clipped
+    @param  y      Top row, unrotated buffer coordinates, clipped
+    @param  w      Width in pixels, at least 1
+    @param  h      Height in pixels, at least 1
+    @param  index  Palette index
+*/
+/**************************************************************************/
+void Adafruit_ST77xxIndexedCanvas::fillRaw(int16_t x, int16_t y, int16_t w,
+                                           int16_t h, uint8_t index) {
+  if (!buffer)
+    return;
+  if (dirtyBottom < dirtyTop) {
+    dirtyTop = y;
+    dirtyBottom = y + h - 1;
+  } else {
+    if (y < dirtyTop)
+      dirtyTop = y;
+    if (y + h - 1 > dirtyBottom)
+      dirtyBottom = y + h - 1;
+  }
+
+  uint8_t *row = &buffer[(int32_t)y * stride];
+  if (bits == 8) {
+    for (; h--; row += stride)
+      memset(row + x, index, w);
+    return;
+  }
+
+  // 4 bits: odd edge pixels by nibble, the pairs between them by byte
+  index &= 0x0F;
+  int16_t x1 = x + w; // Exclusive
+  bool headOdd = x & 1, tailOdd = x1 & 1;
+  int16_t b0 = (x + 1) / 2, b1 = x1 / 2; // Whole bytes [b0, b1)
+  for (; h--; row += stride) {
+    if (headOdd)
+      row[x / 2] = (row[x / 2] & 0xF0) | index;
+    if (b1 > b0)
+      memset(row + b0, index * 0x11, b1 - b0);
+    if (tailOdd)
+      row[b1] = (row[b1] & 0x0F) | (index << 4);
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef _ADAFRUIT_ST77XXINDEXEDCANVAS_H_
+#define _ADAFRUIT_ST77XXINDEXEDCANVAS_H_
+
+#include "Adafruit_ST77xx.h"
+
+/// Canvas that stores 4-bit or 8-bit palette indices instead of 16-bit
+/// colors, a half or a quarter of the RAM of a GFXcanvas16. Drawing colors
+/// are palette indices. flush() expands each row through the palette into
+/// a line buffer on its way to the display, so changing the palette
+/// recolors the whole image (e.g. color cycling) without redrawing it.
+class Adafruit_ST77xxIndexedCanvas : public Adafruit_GFX {
+public:
+  Adafruit_ST77xxIndexedCanvas(uint16_t w, uint16_t h, uint8_t bits = 8);
+  ~Adafruit_ST77xxIndexedCanvas(void);
+
+  bool begin(void);
+  uint32_t flush(Adafruit_ST77xx &tft, int16_t x = 0, int16_t y = 0);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  uint8_t getPixel(int16_t x, int16_t y) const;
+
+  void setPalette(const uint16_t *colors, uint16_t count, uint8_t first = 0);
+  void setPaletteColor(uint8_t index, uint16_t color);
+  uint16_t getPaletteColor(uint8_t index) const;
+  void rotatePalette(uint8_t first, uint8_t count, int8_t steps = 1);
+
+  void markAllDirty(void);
+
+  /*!
+    @brief  Bits per pixel
+    @return 4 or 8
+  */
+  uint8_t getBits(void) const { return bits; }
+  /*!
+    @brief  Palette indices, row by row in the unrotated layout. A 4-bit
+            row starts on a byte boundary, left pixel in the high nibble.
+    @return Buffer, or NULL before a successful begin()
+  */
+  uint8_t *getBuffer(void) const { return buffer; }
+  /*!
+    @brief  Bytes per row of getBuffer()
+    @return Row stride
+  */
+  uint16_t getStride(void) const { return stride; }
+
+private:
+  void fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t index);
+
+  uint8_t bits;
+  uint16_t stride;            // Bytes per buffer row
+  uint8_t *buffer = NULL;     // Palette indices
+  uint16_t *palette = NULL;   // 5-6-5 colors, stored in bus byte order
+  uint16_t *line = NULL;      // Row expanded for flush()
+  int16_t dirtyTop = 0,       // First buffer row changed since flush()
+      dirtyBottom = -1;       // Last one, < dirtyTop when clean
+};
+
+#endif // _ADAFRUIT_ST77XXINDEXEDCANVAS_H_
@@ -0,0 +1,273 @@
+#ifndef _ADAFRUIT_ST77XXPANEL_H_
+#define _ADAFRUIT_ST77XXPANEL_H_
+
+#include "Adafruit_ST7735.h"
+#include "Adafruit_ST7789.h"
+#include "Adafruit_ST7796S.h"
+
+// Controllers for Adafruit_ST77xxPanel
+#define ST77XX_PANEL_ST7735B 0
+#define ST77XX_PANEL_ST7735R 1
+#define ST77XX_PANEL_ST7789 2
+#define ST77XX_PANEL_ST7796S 3
+
+// Adafruit_ST77xxPanel flags
+#define ST77XX_PANEL_RGB 0x00      // Glass is wired RGB
+#define ST77XX_PANEL_BGR 0x08      // Glass is wired BGR (the MADCTL bit)
+#define ST77XX_PANEL_INVERTED 0x01 // Glass is normally black, INVON is off
+
+/// What differs between controllers, chosen at compile time, so only the
+/// init tables of the controller in use are referenced
+template <uint8_t Controller> struct ST77xxController;
+
+/// MADCTL for each rotation, as the ST7735 and ST7789 drivers set it
+struct ST77xxControllerMADCTL {
+  /*!
+    @brief  MADCTL direction bits for a rotation
+    @param  r  Rotation, 0-3
+    @return ST77XX_MADCTL_* bits
+  */
+  static constexpr uint8_t madctl(uint8_t r) {
+    return (r == 0)   ? ST77XX_MADCTL_MX | ST77XX_MADCTL_MY
+           : (r == 1) ? ST77XX_MADCTL_MY | ST77XX_MADCTL_MV
+           : (r == 2) ? 0
+                      : ST77XX_MADCTL_MX | ST77XX_MADCTL_MV;
+  }
+};
+
+/// ST7735B: one init table, 162 GRAM rows
+template <>
+struct ST77xxController<ST77XX_PANEL_ST7735B> : ST77xxControllerMADCTL {
+  static const uint8_t *init1(void) { return Adafruit_ST7735::initTableB(); }
+  static const uint8_t *init2(void) { return NULL; }
+  static constexpr uint16_t gramHeight(void) { return 162; }
+};
+
+/// ST7735R: the tables all tabs share, 162 GRAM rows. The tab-specific
+/// middle table only sets a window, which every draw sets anyway.
+template <>
+struct ST77xxController<ST77XX_PANEL_ST7735R> : ST77xxControllerMADCTL {
+  static const uint8_t *init1(void) {
+    return Adafruit_ST7735::initTableR(false);
+  }
+  static const uint8_t *init2(void) {
+    return Adafruit_ST7735::initTableR(true);
+  }
+  static constexpr uint16_t gramHeight(void) { return 162; }
+};
+
+/// ST7789: one init table, 320 GRAM rows
+template <>
+struct ST77xxController<ST77XX_PANEL_ST7789> : ST77xxControllerMADCTL {
+  static const uint8_t *init1(void) { return Adafruit_ST7789::initTable(); }
+  static const uint8_t *init2(void) { return NULL; }
+  static constexpr uint16_t gramHeight(void) { return 320; }
+};
+
+/// ST7796S: one init table, 480 GRAM rows, its own rotation bits
+template <> struct ST77xxController<ST77XX_PANEL_ST7796S> {
+  static const uint8_t *init1(void) { return Adafruit_ST7796S::initTable(); }
+  static const uint8_t *init2(void) { return NULL; }
+  static constexpr uint16_t gramHeight(void) { return 480; }
+  /*!
+    @brief  MADCTL direction bits for a rotation
+    @param  r  Rotation, 0-3
+    @return ST77XX_MADCTL_* bits
+  */
+  static constexpr uint8_t madctl(uint8_t r) {
+    return (r == 0)   ? ST77XX_MADCTL_MX
+           : (r == 1) ? ST77XX_MADCTL_MV
+           : (r == 2) ? ST77XX_MADCTL_MY
+                      : ST77XX_MADCTL_MX | ST77XX_MADCTL_MY | ST77XX_MADCTL_MV;
+  }
+};
+
+/// A ST77xx display whose controller, size, GRAM offsets and color order
+/// are fixed at compile time. Rotation sizes, offsets and MADCTL are
+/// constant expressions, init runs only this controller's tables, so a
+/// build for one panel carries no tables or tab logic for the others, and
+/// setAddrWindow() adds no offsets when they are the same in every
+/// rotation.
+///   Controller        ST77XX_PANEL_*
+///   Width, Height     Size in pixels at rotation 0
+///   ColStart, RowStart  GRAM column and row of the top left corner at
+///                     rotation 0
+///   Flags             ST77XX_PANEL_RGB or ST77XX_PANEL_BGR, plus
+///                     ST77XX_PANEL_INVERTED
+///   ColEnd, RowEnd    GRAM columns right of and rows below the panel at
+///                     rotation 0, where they differ from ColStart and
+///                     RowStart
+template <uint8_t Controller, uint16_t Width, uint16_t Height,
+          uint16_t ColStart = 0, uint16_t RowStart = 0,
+          uint8_t Flags = ST77XX_PANEL_RGB, uint16_t ColEnd = ColStart,
+          uint16_t RowEnd = RowStart>
+class Adafruit_ST77xxPanel : public Adafruit_ST77xx {
+  typedef ST77xxController<Controller> Chip;
+
+public:
+  /*!
+    @brief  Instantiate with software SPI
+    @param  cs    Chip select pin #
+    @param  dc    Data/Command pin #
+    @param  mosi  SPI MOSI pin #
+    @param  sclk  SPI Clock pin #
+    @param  rst   Reset pin # (optional, pass -1 if unused)
+  */
+  Adafruit_ST77xxPanel(int8_t cs, int8_t dc, int8_t mosi, int8_t sclk,
+                       int8_t rst = -1)
+      : Adafruit_ST77xx(Width, Height, cs, dc, mosi, sclk, rst) {}
+  /*!
+    @brief  Instantiate with hardware SPI
+    @param  cs   Chip select pin #
+    @param  dc   Data/Command pin #
+    @param  rst  Reset pin # (optional, pass -1 if unused)
+  */
+  Adafruit_ST77xxPanel(int8_t cs, int8_t dc, int8_t rst = -1)
+      : Adafruit_ST77xx(Width, Height, cs, dc, rst) {}
+#if !defined(ESP8266)
+  /*!
+    @brief  Instantiate with selectable hardware SPI
+    @param  spiClass  Pointer to an SPI device to use (e.g. &SPI1)
+    @param  cs        Chip select pin #
+    @param  dc        Data/Command pin #
+    @param  rst       Reset pin # (optional, pass -1 if unused)
+  */
+  Adafruit_ST77xxPanel(SPIClass *spiClass, int8_t cs, int8_t dc,
+                       int8_t rst = -1)
+      : Adafruit_ST77xx(Width, Height, spiClass, cs, dc, rst) {}
+#endif // end !ESP8266
+
+  /*!
+    @brief  Initialize the display
+    @param  mode  SPI data mode, SPI_MODE0 to SPI_MODE3
+  */
+  void init(uint8_t mode = SPI_MODE0) {
+    setup(mode);
+    commonInit(Chip::init1());
+    if (Chip::init2())
+      displayInit(Chip::init2());
+    initDone();
+  }
+  /*!
+    @brief  Start init() without waiting for it; poll() until isReady()
+    @param  mode  SPI data mode, SPI_MODE0 to SPI_MODE3
+  */
+  void initAsync(uint8_t mode = SPI_MODE0) {
+    setup(mode);
+    commonInitAsync(Chip::init1(), Chip::init2());
+  }
+
+  /*!
+    @brief  Set origin of (0,0) and orientation of the display
+    @param  m  The index for rotation, from 0-3 inclusive
+  */
+  void setRotation(uint8_t m) {
+    fence();
+    rotation = m & 3;
+    _xstart = xstart(rotation);
+    _ystart = ystart(rotation);
+    _width = (rotation & 1) ? Height : Width;
+    _height = (rotation & 1) ? Width : Height;
+    sendMADCTL(Chip::madctl(rotation) | (Flags & ST77XX_PANEL_BGR));
+  }
+
+  /*!
+    @brief  Set the address window, with the GRAM offset folded into a
+            constant when it is the same in every rotation
+    @param  x  Top left corner x coordinate
+    @param  y  Top left corner y coordinate
+    @param  w  Width of window
+    @param  h  Height of window
+  */
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if ((ColStart == RowStart) && (ColStart == ColEnd) &&
+        (ColStart == RowEnd))
+      openWindow(x, y, w, h, x + ColStart, y + ColStart);
+    else
+      openWindow(x, y, w, h, x + _xstart, y + _ystart);
+  }
+
+  /*!
+    @brief  GRAM column of the top left corner
+    @param  r  Rotation, 0-3
+    @return Column offset
+  */
+  static constexpr uint16_t xstart(uint8_t r) {
+    return (r == 0)   ? ColStart
+           : (r == 1) ? RowStart
+           : (r == 2) ? ColEnd
+                      : RowEnd;
+  }
+  /*!
+    @brief  GRAM row of the top left corner
+    @param  r  Rotation, 0-3
+    @return Row offset
+  */
+  static constexpr uint16_t ystart(uint8_t r) {
+    return (r == 0)   ? RowStart
+           : (r == 1) ? ColEnd
+           : (r == 2) ? RowEnd
+                      : ColStart;
+  }
+
+protected:
+  /*!
+    @brief  Set up inversion for the glass and rotation 0 once the init
+            tables have run
+  */
+  void initDone(void) {
+    if (Flags & ST77XX_PANEL_INVERTED) {
+      invertOnCommand = ST77XX_INVOFF;
+      invertOffCommand = ST77XX_INVON;
+    }
+    invertDisplay(false); // Skipped if the tables left it so
+    setRotation(0);
+  }
+
+private:
+  void setup(uint8_t mode) {
+    spiMode = mode;
+    _colstart = ColStart;
+    _rowstart = RowStart;
+    _gramHeight = Chip::gramHeight();
+  }
+};
+
+// Adafruit's displays
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7735R, 128, 160, 2, 1,
+                             ST77XX_PANEL_BGR>
+    Adafruit_ST7735_GreenTab;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7735R, 128, 160>
+    Adafruit_ST7735_BlackTab;
+// initR() can't select this one: INITR_REDTAB has INITR_144GREENTAB's code
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7735R, 128, 160, 0, 0,
+                             ST77XX_PANEL_BGR>
+    Adafruit_ST7735_RedTab;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7735R, 128, 128, 2, 3,
+                             ST77XX_PANEL_BGR, 2, 1>
+    Adafruit_ST7735_144GreenTab;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7735R, 80, 160, 24, 0>
+    Adafruit_ST7735_Mini160x80;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7735R, 80, 160, 26, 1,
+                             ST77XX_PANEL_BGR | ST77XX_PANEL_INVERTED>
+    Adafruit_ST7735_Mini160x80Plugin;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7789, 240, 320, 0, 0,
+                             ST77XX_PANEL_INVERTED>
+    Adafruit_ST7789_240x320;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7789, 240, 280, 0, 20,
+                             ST77XX_PANEL_INVERTED>
+    Adafruit_ST7789_240x280;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7789, 240, 240, 0, 80,
+                             ST77XX_PANEL_INVERTED, 0, 0>
+    Adafruit_ST7789_240x240;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7789, 170, 320, 35, 0,
+                             ST77XX_PANEL_INVERTED>
+    Adafruit_ST7789_170x320;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7789, 135, 240, 53, 40,
+                             ST77XX_PANEL_INVERTED, 52, 40>
+    Adafruit_ST7789_135x240;
+typedef Adafruit_ST77xxPanel<ST77XX_PANEL_ST7796S, 320, 480, 0, 0,
+                             ST77XX_PANEL_INVERTED>
+    Adafruit_ST7796S_320x480;
+
+#endif // _ADAFRUIT_ST77XXPANEL_H_
@@ -0,0 +1,183 @@
+#include "Adafruit_ST77xxStrip.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate a strip renderer for a display
+    @param  tft   Display the frames are pushed to
+    @param  rows  Strip height in rows. RAM use is 2 bytes x rows x the
+                  longer display side; taller strips mean fewer address
+                  windows and fewer passes over the render callback.
+*/
+/**************************************************************************/
+Adafruit_ST77xxStrip::Adafruit_ST77xxStrip(Adafruit_ST77xx &tft,
+                                           uint16_t rows)
+    : Adafruit_GFX(tft.width(), tft.height()), display(tft),
+      bufferRows(rows ? rows : 1) {}
+
+/**************************************************************************/
+/*!
+    @brief  Free the strip buffer
+*/
+/**************************************************************************/
+Adafruit_ST77xxStrip::~Adafruit_ST77xxStrip(void) {
+  if (buffer)
+    free(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Allocate the strip buffer. Call after the display's init(),
+            since some displays only know their size from then on.
+    @return true on success, false if the buffer could not be allocated
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxStrip::begin(void) {
+  // Sized for the longer side so any rotation fits
+  uint16_t w = display.width(), h = display.height();
+  uint32_t pixels = (uint32_t)((w > h) ? w : h) * bufferRows;
+  if (buffer && (pixels <= bufferPixels))
+    return true;
+  if (buffer)
+    free(buffer);
+  buffer = (uint16_t *)malloc(pixels * 2);
+  bufferPixels = buffer ? pixels : 0;
+  return buffer != NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Render a full frame strip by strip. For each strip the buffer is
+            cleared to the background color, the render callback draws the
+            frame (clipped to the strip) and the strip is pushed to the
+            display with one address window.
+    @param  render      Callback that draws the frame
+    @param  background  16-bit 5-6-5 color each strip starts from
+    @return Bus bytes sent, including address window overhead, or 0 if
+            begin() has not succeeded
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxStrip::draw(ST77xxRenderFunc render,
+                                    uint16_t background) {
+  // Follow the display's current rotation; coordinates are the display's
+  rotation = display.getRotation();
+  _width = display.width();
+  _height = display.height();
+  stripCount = 0;
+  if (!buffer || ((uint32_t)_width * bufferRows > bufferPixels))
+    return 0;
+
+  uint32_t bytes = 0;
+  for (stripTop = 0; stripTop < _height; stripTop += bufferRows) {
+    stripHeight = _height - stripTop;
+    if (stripHeight > (int16_t)bufferRows)
+      stripHeight = bufferRows;
+    uint32_t len = (uint32_t)_width * stripHeight;
+    for (uint32_t i = 0; i < len; i++)
+      buffer[i] = background;
+
+    render(*this);
+
+    display.startWrite();
+    display.setAddrWindow(0, stripTop, _width, stripHeight);
+    display.writePixels(buffer, len);
+    display.endWrite();
+    bytes += ST77XX_WINDOW_COST + display.pixelBytes(len);
+    stripCount++;
+  }
+  stripTop = stripHeight = 0;
+  return bytes;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a pixel, if it falls within the current strip
+    @param  x      x coordinate
+    @param  y      y coordinate
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxStrip::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  y -= stripTop;
+  if ((x < 0) || (x >= _width) || (y < 0) || (y >= stripHeight))
+    return;
+  buffer[(int32_t)y * _width + x] = color;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill the current strip with a color
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxStrip::fillScreen(uint16_t color) {
+  uint32_t len = (uint32_t)_width * stripHeight;
+  for (uint32_t i = 0; i < len; i++)
+    buffer[i] = color;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a vertical line, clipped to the current strip
+    @param  x      Top x coordinate
+    @param  y      Top y coordinate
+    @param  h      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxStrip::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                         uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a horizontal line, clipped to the current strip
+    @param  x      Left x coordinate
+    @param  y      Left y coordinate
+    @param  w      Length in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxStrip::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                         uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill a rectangle, clipped to the current strip
+    @param  x      Top left x coordinate
+    @param  y      Top left y coordinate
+    @param  w      Width in pixels
+    @param  h      Height in pixels
+    @param  color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void Adafruit_ST77xxStrip::fillRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  int16_t x1 = x + w, y0 = y - stripTop, y1 = y0 + h; // Exclusive ends
+  if (x < 0)
+    x = 0;
+  if (x1 > _width)
+    x1 = _width;
+  if (y0 < 0)
+    y0 = 0;
+  if (y1 > stripHeight)
+    y1 = stripHeight;
+  if ((x >= x1) || (y0 >= y1))
+    return;
+
+  for (int16_t row = y0; row < y1; row++) {
+    uint16_t *p = &buffer[(int32_t)row * _width + x];
+    for (int16_t i = x; i < x1; i++)
+      *p++ = color;
+  }
+}
@@ -0,0 +1,56 @@
+#ifndef _ADAFRUIT_ST77XXSTRIP_H_
+#define _ADAFRUIT_ST77XXSTRIP_H_
+
+#include "Adafruit_ST77xx.h"
+
+class Adafruit_ST77xxStrip;
+
+/// Callback that draws one whole frame. It is called once per strip; all
+/// drawing is clipped to the current strip, so it may simply draw everything.
+typedef void (*ST77xxRenderFunc)(Adafruit_ST77xxStrip &gfx);
+
+/// Banded renderer for displays whose framebuffer doesn't fit in RAM. A
+/// frame is drawn into a small buffer a few rows at a time, and each
+/// finished strip is pushed with a single address window, so every pixel is
+/// sent exactly once and the panel never shows a half-drawn frame region.
+class Adafruit_ST77xxStrip : public Adafruit_GFX {
+public:
+  Adafruit_ST77xxStrip(Adafruit_ST77xx &tft, uint16_t rows);
+  ~Adafruit_ST77xxStrip(void);
+
+  bool begin(void);
+  uint32_t draw(ST77xxRenderFunc render, uint16_t background = 0);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+  /*!
+    @brief  First display row of the strip being drawn, so a render callback
+            can skip work that falls entirely outside it
+    @return Row number in the display's current rotation
+  */
+  int16_t getStripTop(void) const { return stripTop; }
+  /*!
+    @brief  Height of the strip being drawn (the last strip may be shorter)
+    @return Row count
+  */
+  int16_t getStripHeight(void) const { return stripHeight; }
+  /*!
+    @brief  Number of strips the last draw() pushed
+    @return Strip count
+  */
+  uint16_t getStripCount(void) const { return stripCount; }
+
+private:
+  Adafruit_ST77xx &display;
+  uint16_t *buffer = NULL;
+  uint16_t bufferRows;
+  uint32_t bufferPixels = 0;
+  int16_t stripTop = 0, stripHeight = 0;
+  uint16_t stripCount = 0;
+};
+
+#endif // _ADAFRUIT_ST77XXSTRIP_H_
@@ -0,0 +1,225 @@
+#include "Adafruit_ST77xxVSync.h"
+
+// TE interrupt state. Interrupt handlers take no argument, so only one TE
+// pin can be followed at a time.
+static volatile uint32_t teCount = 0;  // Rising edges seen
+static volatile uint32_t teLastUs = 0; // micros() at the last edge
+static volatile uint32_t tePeriodUs = 0;
+
+static void teISR(void) {
+  uint32_t now = micros();
+  if (teCount)
+    tePeriodUs = now - teLastUs;
+  teLastUs = now;
+  teCount++;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Instantiate tearing-effect synchronization for a display
+    @param  tft    Display to synchronize with
+    @param  tePin  Pin wired to the display's TE output, or -1 to poll the
+                   scanline over SPI instead
+*/
+/**************************************************************************/
+Adafruit_ST77xxVSync::Adafruit_ST77xxVSync(Adafruit_ST77xx &tft, int8_t tePin)
+    : display(tft), te(tePin) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Detach the TE interrupt
+*/
+/**************************************************************************/
+Adafruit_ST77xxVSync::~Adafruit_ST77xxVSync(void) {
+  if (te >= 0)
+    detachInterrupt(digitalPinToInterrupt(te));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Turn on the TE output, attach its interrupt and measure the
+            refresh period. Call after the display's init().
+    @return true if the display's refresh could be followed, false if no
+            blanking period was seen (TE not wired, or MISO not connected)
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxVSync::begin(void) {
+  // Scanlines count GRAM rows, whatever the rotation, and a panel smaller
+  // than GRAM shows only a band of them
+  firstLine = display.getVisibleScanStart();
+  endLine = firstLine + ((display.getRotation() & 1) ? display.width()
+                                                     : display.height());
+  display.enableTearing(true);
+  if (te >= 0) {
+    pinMode(te, INPUT);
+    attachInterrupt(digitalPinToInterrupt(te), teISR, RISING);
+  }
+  resetStats();
+  return measure(1) != 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Detach the TE interrupt and turn the TE output off
+*/
+/**************************************************************************/
+void Adafruit_ST77xxVSync::end(void) {
+  if (te >= 0)
+    detachInterrupt(digitalPinToInterrupt(te));
+  display.enableTearing(false);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Wait for the start of the next vertical blanking period
+    @param  timeout  Give up after this many milliseconds
+    @return true on success, false on timeout
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxVSync::waitVBlank(uint16_t timeout) {
+  uint32_t t0 = millis();
+  if (te >= 0) {
+    uint32_t n = teCount;
+    while (teCount == n) {
+      if ((millis() - t0) > timeout)
+        return false;
+      yield();
+    }
+    lastVBlankUs = teLastUs;
+    if (tePeriodUs)
+      stats.framePeriodUs = tePeriodUs;
+    return true;
+  }
+
+  // Blanking, as far as the glass goes, starts when the scan moves past the
+  // last visible line; if it is already there, wait for the next frame's.
+  // Rows scanned outside the panel count as blanking.
+  bool scanning = false;
+  for (;;) {
+    uint16_t line = display.readScanline();
+    if ((line >= firstLine) && (line < endLine))
+      scanning = true;
+    else if (scanning)
+      break;
+    if ((millis() - t0) > timeout)
+      return false;
+    yield();
+  }
+  lastVBlankUs = micros();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Time the panel's refresh over a few frames, e.g. after changing
+            its frame rate, and keep the result as the refresh period
+    @param  frames  Frames to average over
+    @return Measured frame period in microseconds, 0 if no blanking period
+            was seen
+*/
+/**************************************************************************/
+uint32_t Adafruit_ST77xxVSync::measure(uint8_t frames) {
+  if (!frames || !waitVBlank())
+    return 0;
+  uint32_t t0 = lastVBlankUs;
+  for (uint8_t i = 0; i < frames; i++) {
+    if (!waitVBlank())
+      return 0;
+  }
+  stats.framePeriodUs = (lastVBlankUs - t0 + frames / 2) / frames;
+  return stats.framePeriodUs;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Wait until the panel starts scanning a new frame from the top
+    @param  timeout  Give up after this many milliseconds
+    @return true on success, false on timeout
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxVSync::waitScanStart(uint16_t timeout) {
+  uint32_t t0 = millis();
+  for (;;) {
+    if (te >= 0) {
+      if (!digitalRead(te)) {
+        // TE falls at GRAM row 0; wait for the scan to reach the panel's
+        // first row. Ignoring the porch lines errs late, behind the scan.
+        uint16_t rows = display.getGramHeight();
+        if (firstLine && rows)
+          delayMicroseconds(stats.framePeriodUs * firstLine / rows);
+        return true;
+      }
+    } else {
+      uint16_t line = display.readScanline();
+      if ((line >= firstLine) && (line < endLine))
+        return true;
+    }
+    if ((millis() - t0) > timeout)
+      return false;
+    yield();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Present a frame without tearing. A flush that fits in one
+            refresh period is started at the beginning of blanking, so it
+            stays ahead of the scan. A longer one is started as the scan
+            leaves the top of the panel, so it stays behind it instead.
+    @param  flush    Function that sends the frame to the display
+    @param  arg      Passed to flush
+    @param  timeout  Milliseconds to wait for sync before giving up
+    @return true if the frame was presented, false on sync timeout
+*/
+/**************************************************************************/
+bool Adafruit_ST77xxVSync::present(ST77xxPresentFunc flush, void *arg,
+                                   uint16_t timeout) {
+  uint32_t start = micros(), prev = lastVBlankUs;
+  if (!waitVBlank(timeout))
+    return false;
+  uint32_t period = stats.framePeriodUs;
+  if (period && (stats.lastFlushUs > period) && !waitScanStart(timeout))
+    return false;
+  stats.lastWaitUs = micros() - start;
+
+  if (stats.frames && period) {
+    uint32_t periods = (lastVBlankUs - prev + period / 2) / period;
+    if (periods > 1)
+      stats.missedVBlanks += periods - 1;
+    else if ((te < 0) && (periods == 1))
+      stats.framePeriodUs = lastVBlankUs - prev; // Track drift when polling
+  }
+
+  uint32_t t = micros();
+  flush(arg);
+  stats.lastFlushUs = micros() - t;
+  if (stats.lastFlushUs > stats.maxFlushUs)
+    stats.maxFlushUs = stats.lastFlushUs;
+  if (period && (stats.lastFlushUs > period))
+    stats.overruns++;
+  stats.frames++;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read the line the panel is refreshing right now
+    @return Scanline, a GRAM row; see Adafruit_ST77xx::readScanline()
+*/
+/**************************************************************************/
+uint16_t Adafruit_ST77xxVSync::getScanline(void) {
+  return display.readScanline();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Zero the statistics, keeping the measured refresh period
+*/
+/**************************************************************************/
+void Adafruit_ST77xxVSync::resetStats(void) {
+  uint32_t period = stats.framePeriodUs;
+  memset(&stats, 0, sizeof(stats));
+  stats.framePeriodUs = period;
+}
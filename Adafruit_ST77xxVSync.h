@@ -0,0 +1,58 @@
+#ifndef _ADAFRUIT_ST77XXVSYNC_H_
+#define _ADAFRUIT_ST77XXVSYNC_H_
+
+#include "Adafruit_ST77xx.h"
+
+/// Draws one frame's worth of updates; called by Adafruit_ST77xxVSync
+typedef void (*ST77xxPresentFunc)(void *arg);
+
+/// Frame timing statistics kept by Adafruit_ST77xxVSync
+typedef struct {
+  uint32_t frames;        ///< Frames presented
+  uint32_t missedVBlanks; ///< Blanking periods that passed with no present
+  uint32_t overruns;      ///< Flushes longer than a refresh period
+  uint32_t framePeriodUs; ///< Measured panel refresh period
+  uint32_t lastFlushUs;   ///< Duration of the last flush
+  uint32_t maxFlushUs;    ///< Longest flush so far
+  uint32_t lastWaitUs;    ///< Time the last present spent waiting for sync
+} ST77xxFrameStats;
+
+/// Tearing-effect synchronized presentation. Each frame is started at a
+/// point in the panel's refresh where the write can stay clear of the
+/// line being scanned out. The refresh is followed either with the TE pin
+/// (interrupt) or, without one, by polling the current scanline (GSCAN),
+/// which needs MISO connected. Only the GRAM rows the panel shows count as
+/// visible. The write has to run down GRAM as the scan does, which on the
+/// Adafruit boards is rotation 2; rotation 0 mirrors the rows (MADCTL MY).
+class Adafruit_ST77xxVSync {
+public:
+  Adafruit_ST77xxVSync(Adafruit_ST77xx &tft, int8_t tePin = -1);
+  ~Adafruit_ST77xxVSync(void);
+
+  bool begin(void);
+  void end(void);
+  bool waitVBlank(uint16_t timeout = 100);
+  uint32_t measure(uint8_t frames = 8);
+  bool present(ST77xxPresentFunc flush, void *arg = NULL,
+               uint16_t timeout = 100);
+  uint16_t getScanline(void);
+
+  /*!
+    @brief  Frame timing statistics
+    @return Counters since begin() or resetStats()
+  */
+  const ST77xxFrameStats &getStats(void) const { return stats; }
+  void resetStats(void);
+
+private:
+  bool waitScanStart(uint16_t timeout);
+
+  Adafruit_ST77xx &display;
+  int8_t te;
+  uint16_t firstLine = 0; // Scan lines the panel shows: firstLine up to,
+  uint16_t endLine = 0;   // not including, endLine
+  uint32_t lastVBlankUs = 0; // micros() at the last blanking start seen
+  ST77xxFrameStats stats;
+};
+
+#endif // _ADAFRUIT_ST77XXVSYNC_H_
@@ -0,0 +1,46 @@
+// Static dashboard on a 1.8" ST7735 that drops into idle (8-color, low
+// frame rate) mode when nothing has been drawn for a few seconds, and
+// wakes up by itself on the next update.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7735.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+
+#define IDLE_AFTER_MS 3000
+#define UPDATE_EVERY_MS 10000
+
+Adafruit_ST7735 tft(TFT_CS, TFT_DC, TFT_RST);
+
+uint32_t lastUpdate = 0;
+
+void drawDashboard(void) {
+  tft.fillRect(0, 40, tft.width(), 40, ST77XX_BLACK);
+  tft.setCursor(10, 50);
+  tft.setTextSize(2);
+  tft.setTextColor(ST77XX_GREEN);
+  tft.print(millis() / 1000);
+  tft.print(F(" s"));
+}
+
+void setup(void) {
+  tft.initR(INITR_BLACKTAB);
+  tft.fillScreen(ST77XX_BLACK);
+  // Pure colors look the same in idle mode
+  tft.fillRect(0, 0, tft.width(), 20, ST77XX_BLUE);
+  tft.setCursor(4, 6);
+  tft.setTextColor(ST77XX_WHITE);
+  tft.print(F("Uptime"));
+  drawDashboard();
+  tft.setIdleTimeout(IDLE_AFTER_MS);
+}
+
+void loop() {
+  if ((millis() - lastUpdate) >= UPDATE_EVERY_MS) {
+    lastUpdate = millis();
+    drawDashboard(); // Leaves idle mode
+  }
+  tft.checkIdle(); // Never blocks; enters idle mode when it's time
+}
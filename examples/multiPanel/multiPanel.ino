@@ -0,0 +1,54 @@
+// Two 1.8" displays side by side on one SPI bus, drawn as one 320x128
+// canvas. Adafruit_ST77xxGroup queues the drawing and flush() sends each
+// display's part in a single transaction, instead of switching chip select
+// for every line and rectangle.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST77xxGroup.h>
+
+#define TFT_CS_LEFT   10
+#define TFT_CS_RIGHT   7
+#define TFT_RST        9 // Shared, or set to -1 and connect to Arduino RESET
+#define TFT_DC         8 // Shared
+
+Adafruit_ST7735 left(TFT_CS_LEFT, TFT_DC, TFT_RST);
+Adafruit_ST7735 right(TFT_CS_RIGHT, TFT_DC, -1);
+Adafruit_ST77xxGroup group(320, 128);
+
+int16_t ballX = 40, dx = 4;
+
+void setup(void) {
+  Serial.begin(9600);
+  left.initR(INITR_BLACKTAB); // Also resets the right display
+  right.initR(INITR_BLACKTAB);
+  left.setRotation(1);
+  right.setRotation(1);
+  group.addPanel(left, 0, 0);
+  group.addPanel(right, 160, 0);
+  if (!group.begin())
+    Serial.println(F("No RAM for a queue, drawing directly"));
+  group.fillScreen(ST77XX_BLACK);
+  group.flush();
+}
+
+void loop() {
+  group.fillRect(ballX - 12, 52, 24, 24, ST77XX_BLACK);
+  ballX += dx;
+  if ((ballX < 12) || (ballX > group.width() - 12))
+    dx = -dx;
+  group.fillCircle(ballX, 64, 12, ST77XX_YELLOW);
+  group.setCursor(130, 4);
+  group.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+  group.print(millis() / 1000);
+  group.flush();
+
+  Serial.print(F("Bus "));
+  Serial.print(group.getBusUtilization());
+  Serial.print(F("% busy, latency "));
+  Serial.print(group.getLatency(0));
+  Serial.print(F(" / "));
+  Serial.print(group.getLatency(1));
+  Serial.println(F(" us"));
+  delay(20);
+}
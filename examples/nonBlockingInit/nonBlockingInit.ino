@@ -0,0 +1,51 @@
+// Bring up a 1.8" ST7735 without stalling setup(): the display resets and
+// runs its init commands from loop() while the rest of the sketch starts.
+// Every minute the panel sleeps for ten seconds, also without blocking.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7735.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+
+Adafruit_ST7735 tft(TFT_CS, TFT_DC, TFT_RST);
+
+bool drawn = false, asleep = false;
+uint32_t stateSince = 0;
+
+void setup(void) {
+  Serial.begin(9600);
+  tft.setFastBoot(true); // Datasheet minimum delays (optional)
+  tft.initRAsync(INITR_BLACKTAB);
+  // Sensors, networking etc. would start here while the display boots
+  Serial.println(F("setup() done"));
+}
+
+void loop() {
+  if (!tft.poll()) // Sends whatever init or sleep command is due
+    return;        // ...and there's time for other work meanwhile
+
+  if (!drawn) {
+    Serial.print(F("Display ready after "));
+    Serial.print(millis());
+    Serial.println(F(" ms"));
+    tft.fillScreen(ST77XX_BLACK);
+    tft.setCursor(10, 10);
+    tft.setTextColor(ST77XX_WHITE);
+    tft.print(F("Hello!"));
+    drawn = true;
+    stateSince = millis();
+  }
+
+  uint32_t t = millis() - stateSince;
+  if (!asleep && (t >= 60000)) {
+    tft.enableSleepAsync(true);
+    asleep = true;
+    stateSince = millis();
+  } else if (asleep && (t >= 10000)) {
+    tft.enableSleepAsync(false); // GRAM is kept while asleep
+    asleep = false;
+    stateSince = millis();
+  }
+}
@@ -0,0 +1,47 @@
+// Full-screen buffered rendering on a 240x320 ST7789 in a quarter of the
+// RAM of a 16-bit canvas: a 4-bit indexed canvas (38 KB). The rings are
+// drawn once; afterwards only the palette changes, which makes them cycle.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxIndexedCanvas.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+
+#define RINGS 14 // Palette entries 1-14 cycle; 0 and 15 stay put
+
+Adafruit_ST7789 tft(TFT_CS, TFT_DC, TFT_RST);
+Adafruit_ST77xxIndexedCanvas canvas(240, 320, 4);
+
+void setup(void) {
+  Serial.begin(9600);
+  tft.init(240, 320);
+  if (!canvas.begin()) {
+    Serial.println(F("Not enough RAM for the canvas"));
+    while (1)
+      yield();
+  }
+
+  // Palette: black, a hue ramp, white
+  canvas.setPaletteColor(0, ST77XX_BLACK);
+  for (uint8_t i = 0; i < RINGS; i++) {
+    uint8_t r = (i < 7) ? 255 - i * 36 : 0, b = (i < 7) ? i * 36 : 255;
+    canvas.setPaletteColor(1 + i, tft.color565(r, i * 18, b));
+  }
+  canvas.setPaletteColor(15, ST77XX_WHITE);
+
+  canvas.fillScreen(0);
+  for (uint8_t i = 0; i < RINGS; i++)
+    canvas.fillCircle(120, 160, 112 - i * 8, 1 + i);
+  canvas.setCursor(92, 156);
+  canvas.setTextColor(15);
+  canvas.print(F("Cycling"));
+}
+
+void loop() {
+  canvas.rotatePalette(1, RINGS); // Recolors every ring, no redraw
+  canvas.flush(tft);
+  delay(50);
+}
@@ -0,0 +1,74 @@
+// Load BMP images from an SD card with the next rows being read while the
+// previous ones go out to the display, instead of reading a row and then
+// writing it. Adafruit_ST77xxImageLoader streams the file through the
+// double buffers of an Adafruit_ST77xxAsync pipeline, a band of rows at a
+// time, so a full-screen image needs no full-size buffer.
+//
+// Reads overlap transfers only where the core sends pixels by DMA and the
+// card is not on the display's SPI bus (e.g. an SDIO slot or a second SPI
+// port). Here the card shares the display's bus, as on Adafruit's
+// breakouts, so the loader is told so: it finishes each band and deselects
+// the display before reading the card. Images load correctly, just without
+// the overlap. Pass false as the loader's third argument only for storage
+// on its own bus.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxImageLoader.h>
+#include <SD.h>
+#include <SPI.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+#define SD_CS          4
+
+#define BAND_ROWS     16 // 2 x 240 x 16 x 2 bytes = 15 KB of buffers
+
+Adafruit_ST7789 tft(TFT_CS, TFT_DC, TFT_RST);
+Adafruit_ST77xxAsync pipeline(tft, 240 * BAND_ROWS);
+Adafruit_ST77xxImageLoader loader(pipeline, 512, true); // Shared bus
+
+void setup(void) {
+  Serial.begin(9600);
+  tft.init(240, 320);
+  tft.fillScreen(ST77XX_BLACK);
+  if (!pipeline.begin() || !loader.begin()) {
+    Serial.println(F("Not enough RAM for the buffers"));
+    while (1)
+      delay(10);
+  }
+  if (!SD.begin(SD_CS)) {
+    Serial.println(F("SD card failed"));
+    while (1)
+      delay(10);
+  }
+}
+
+void loop() {
+  File file = SD.open("/photo.bmp");
+  if (!file) {
+    Serial.println(F("photo.bmp not found"));
+    delay(1000);
+    return;
+  }
+  uint32_t t = millis();
+  bool ok = loader.drawBMP(file, 0, 0);
+  pipeline.wait(); // Only needed for storage on a bus of its own
+  t = millis() - t;
+  file.close();
+
+  if (ok) {
+    Serial.print(loader.getWidth());
+    Serial.print('x');
+    Serial.print(loader.getHeight());
+    Serial.print(F(" loaded in "));
+    Serial.print(t);
+    Serial.print(F(" ms, "));
+    Serial.print(pipeline.getStalls());
+    Serial.println(F(" waits for the display"));
+  } else {
+    Serial.println(F("Unsupported or damaged BMP"));
+  }
+  delay(5000);
+}
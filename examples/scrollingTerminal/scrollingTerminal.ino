@@ -0,0 +1,52 @@
+// Scrolling text log on an ST7789 using the controller's hardware vertical
+// scrolling. Adding a line moves the scroll offset and clears just the new
+// line, a few hundred bytes over SPI instead of repainting the whole log.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7789.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+
+#define HEADER 16 // Fixed title bar at the top
+#define FOOTER 0
+#define LINE 10   // Text line height
+
+Adafruit_ST7789 tft(TFT_CS, TFT_DC, TFT_RST);
+
+int16_t nextY = HEADER; // Where the next line goes until the log is full
+uint32_t count = 0;
+
+void logLine(const char *text) {
+  int16_t y;
+  if (nextY + LINE <= tft.height() - FOOTER) {
+    y = nextY;
+    nextY += LINE;
+  } else {
+    y = tft.scrollLines(LINE, ST77XX_BLACK);
+  }
+  tft.setCursor(2, y + 1);
+  tft.print(text);
+}
+
+void setup(void) {
+  tft.init(240, 320);
+  tft.fillScreen(ST77XX_BLACK);
+  tft.fillRect(0, 0, tft.width(), HEADER, ST77XX_BLUE);
+  tft.setTextColor(ST77XX_WHITE);
+  tft.setCursor(4, 4);
+  tft.print(F("Event log"));
+
+  // The scroll area holds a whole number of text lines
+  tft.setScrollMargins(HEADER, (tft.height() - HEADER - FOOTER) % LINE + FOOTER);
+  tft.setTextColor(ST77XX_GREEN);
+}
+
+void loop() {
+  char text[32];
+  snprintf(text, sizeof(text), "%lu: millis %lu", (unsigned long)count++,
+           (unsigned long)millis());
+  logLine(text);
+  delay(250);
+}
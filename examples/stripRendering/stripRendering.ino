@@ -0,0 +1,62 @@
+// Full-frame, overdraw-free updates without a full framebuffer.
+// Adafruit_ST77xxStrip draws the frame a few rows at a time into a small
+// buffer and pushes each strip with a single address window. A 320x480
+// frame needs 300 KB as a canvas; with 16-row strips it needs 10 KB.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7796S.h>
+#include <Adafruit_ST77xxStrip.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+
+#if defined(__AVR__)
+#define STRIP_ROWS 2   // 1.25 KB
+#else
+#define STRIP_ROWS 16  // 10 KB
+#endif
+
+Adafruit_ST7796S tft(TFT_CS, TFT_DC, TFT_RST);
+Adafruit_ST77xxStrip strip(tft, STRIP_ROWS);
+
+int16_t ballX = 40, ballY = 40, dx = 3, dy = 2;
+
+// Draws the whole frame. It runs once per strip and everything is clipped
+// to the current strip, so it never has to know about strips at all.
+void drawFrame(Adafruit_ST77xxStrip &gfx) {
+  gfx.fillRect(0, 0, gfx.width(), 40, ST77XX_BLUE);
+  gfx.setCursor(10, 12);
+  gfx.setTextColor(ST77XX_WHITE);
+  gfx.setTextSize(2);
+  gfx.print(millis() / 1000);
+  gfx.print(" s");
+  gfx.fillCircle(ballX, ballY, 20, ST77XX_RED);
+  gfx.drawRect(0, 40, gfx.width(), gfx.height() - 40, ST77XX_GREEN);
+}
+
+void setup(void) {
+  Serial.begin(9600);
+  tft.init(320, 480, 0, 0, ST7796S_RGB);
+  if (!strip.begin()) {
+    Serial.println(F("Not enough RAM for strip buffer"));
+    while (1)
+      delay(10);
+  }
+}
+
+void loop() {
+  ballX += dx;
+  ballY += dy;
+  if ((ballX < 20) || (ballX > tft.width() - 20))
+    dx = -dx;
+  if ((ballY < 60) || (ballY > tft.height() - 20))
+    dy = -dy;
+
+  uint32_t t = millis();
+  strip.draw(drawFrame, ST77XX_BLACK);
+  Serial.print(strip.getStripCount());
+  Serial.print(F(" strips in "));
+  Serial.print(millis() - t);
+  Serial.println(F(" ms"));
+}
@@ -0,0 +1,54 @@
+// Tear-free animation on an ST7789 using the display's TE (tearing effect)
+// output. Each frame is sent at a point in the panel's refresh where the
+// write doesn't cross the line being scanned out. Without a TE wire, pass
+// -1 as the pin and connect MISO instead; the scanline is then polled.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxVSync.h>
+
+#define TFT_CS        10
+#define TFT_RST        9 // Or set to -1 and connect to Arduino RESET pin
+#define TFT_DC         8
+#define TFT_TE         2 // Must be an interrupt-capable pin
+
+Adafruit_ST7789 tft(TFT_CS, TFT_DC, TFT_RST);
+Adafruit_ST77xxVSync vsync(tft, TFT_TE);
+
+int16_t barX = 0;
+
+// Moves a full-height bar; tearing would show as a kink in it
+void drawFrame(void *arg) {
+  (void)arg;
+  tft.fillRect(barX, 0, 4, tft.height(), ST77XX_BLACK);
+  barX = (barX + 4) % tft.width();
+  tft.fillRect(barX, 0, 4, tft.height(), ST77XX_WHITE);
+}
+
+void setup(void) {
+  Serial.begin(9600);
+  tft.init(240, 320);
+  tft.fillScreen(ST77XX_BLACK);
+  if (!vsync.begin()) {
+    Serial.println(F("No TE signal"));
+    while (1)
+      delay(10);
+  }
+  Serial.print(F("Refresh period: "));
+  Serial.print(vsync.getStats().framePeriodUs);
+  Serial.println(F(" us"));
+}
+
+void loop() {
+  vsync.present(drawFrame);
+
+  const ST77xxFrameStats &s = vsync.getStats();
+  if ((s.frames % 60) == 0) {
+    Serial.print(F("flush "));
+    Serial.print(s.lastFlushUs);
+    Serial.print(F(" us, missed vblanks "));
+    Serial.print(s.missedVBlanks);
+    Serial.print(F(", overruns "));
+    Serial.println(s.overruns);
+  }
+}
@@ -0,0 +1,974 @@
+/*!
+ * @file ST77xxEmulator.cpp
+ *
+ * Host-side model of the ST7735 / ST7789 / ST7796S display controllers.
+ * See ST77xxEmulator.h for an overview.
+ */
+
+#include "ST77xxEmulator.h"
+#include <string.h>
+
+// Opcodes the model interprets. Kept local so the emulator does not depend
+// on the Arduino headers that Adafruit_ST77xx.h pulls in.
+#define CMD_SWRESET 0x01
+#define CMD_RDDID 0x04
+#define CMD_RDDPM 0x0A
+#define CMD_SLPIN 0x10
+#define CMD_SLPOUT 0x11
+#define CMD_PTLON 0x12
+#define CMD_NORON 0x13
+#define CMD_INVOFF 0x20
+#define CMD_INVON 0x21
+#define CMD_DISPOFF 0x28
+#define CMD_DISPON 0x29
+#define CMD_CASET 0x2A
+#define CMD_RASET 0x2B
+#define CMD_RAMWR 0x2C
+#define CMD_RAMRD 0x2E
+#define CMD_PTLAR 0x30
+#define CMD_VSCRDEF 0x33
+#define CMD_TEOFF 0x34
+#define CMD_TEON 0x35
+#define CMD_MADCTL 0x36
+#define CMD_VSCSAD 0x37
+#define CMD_IDMOFF 0x38
+#define CMD_IDMON 0x39
+#define CMD_COLMOD 0x3A
+#define CMD_GSCAN 0x45
+#define CMD_FRMCTR1 0xB1 // ST7735; RGBCTRL on the ST7789
+#define CMD_PORCTRL 0xB2 // ST7789; FRMCTR2 on the ST7735
+#define CMD_FRCTRL2 0xC6 // ST7789
+#define CMD_RDID1 0xDA
+#define CMD_RDID2 0xDB
+#define CMD_RDID3 0xDC
+
+#define MADCTL_MY 0x80
+#define MADCTL_MX 0x40
+#define MADCTL_MV 0x20
+#define MADCTL_BGR 0x08
+
+static uint64_t noClock(void) { return 0; }
+
+/*!
+    @brief  Build a panel description from the driver's rotation-0 offsets
+    @param  gramWidth   GRAM columns
+    @param  gramHeight  GRAM rows
+    @param  width       Panel width at rotation 0
+    @param  height      Panel height at rotation 0
+    @param  colstart    Driver _colstart at rotation 0
+    @param  rowstart    Driver _rowstart at rotation 0
+    @param  mx          Rotation-0 MADCTL has MX set
+    @param  my          Rotation-0 MADCTL has MY set
+    @param  bgr         Glass is wired BGR
+    @param  inverted    Glass is normally-black
+    @return Panel description whose rotation 0 renders upright
+*/
+ST77xxEmulator::Panel
+ST77xxEmulator::Panel::fromOffsets(uint16_t gramWidth, uint16_t gramHeight,
+                                   uint16_t width, uint16_t height,
+                                   uint16_t colstart, uint16_t rowstart,
+                                   bool mx, bool my, bool bgr, bool inverted) {
+  Panel p;
+  p.gramWidth = gramWidth;
+  p.gramHeight = gramHeight;
+  p.width = width;
+  p.height = height;
+  // A mirrored axis lands the driver's offset at the far end of GRAM
+  p.x = mx ? (gramWidth - width - colstart) : colstart;
+  p.y = my ? (gramHeight - height - rowstart) : rowstart;
+  p.flipX = mx;
+  p.flipY = my;
+  p.bgr = bgr;
+  p.inverted = inverted;
+  return p;
+}
+
+/*!
+    @brief  Panel matching what the Adafruit driver sets up for a controller
+    @param  controller  Controller flavour
+    @param  width       Panel width at rotation 0 (0 = controller default)
+    @param  height      Panel height at rotation 0 (0 = controller default)
+    @return Panel description
+*/
+ST77xxEmulator::Panel ST77xxEmulator::defaultPanel(Controller controller,
+                                                   uint16_t width,
+                                                   uint16_t height) {
+  switch (controller) {
+  case ST7735:
+    // 1.8" green tab: 132x162 GRAM, offsets 2/1, BGR glass
+    if (!width)
+      width = 128;
+    if (!height)
+      height = 160;
+    return Panel::fromOffsets(132, 162, width, height, 2, 1, true, true, true);
+  case ST7789: {
+    if (!width)
+      width = 240;
+    if (!height)
+      height = 320;
+    // Same offset math as Adafruit_ST7789::init()
+    uint16_t colstart, rowstart;
+    if (width == 240 && height == 240) {
+      colstart = 0;
+      rowstart = 80;
+    } else if (width == 135 && height == 240) {
+      colstart = (240 - width + 1) / 2;
+      rowstart = (320 - height) / 2;
+    } else {
+      colstart = (240 - width) / 2;
+      rowstart = (320 - height) / 2;
+    }
+    return Panel::fromOffsets(240, 320, width, height, colstart, rowstart,
+                              true, true, false, true);
+  }
+  case ST7796S:
+  default:
+    if (!width)
+      width = 320;
+    if (!height)
+      height = 480;
+    // Adafruit_ST7796S uses MX only at rotation 0, and INVON is its "off"
+    return Panel::fromOffsets(320, 480, width, height, 0, 0, true, false,
+                              false, true);
+  }
+}
+
+/*!
+    @brief  Mnemonic for a command byte, for traces
+    @param  cmd  Opcode
+    @return Static string, "?" when unknown
+*/
+const char *ST77xxEmulator::commandName(uint8_t cmd) {
+  switch (cmd) {
+  case 0x00:
+    return "NOP";
+  case CMD_SWRESET:
+    return "SWRESET";
+  case CMD_RDDID:
+    return "RDDID";
+  case 0x09:
+    return "RDDST";
+  case CMD_RDDPM:
+    return "RDDPM";
+  case CMD_SLPIN:
+    return "SLPIN";
+  case CMD_SLPOUT:
+    return "SLPOUT";
+  case CMD_PTLON:
+    return "PTLON";
+  case CMD_NORON:
+    return "NORON";
+  case CMD_INVOFF:
+    return "INVOFF";
+  case CMD_INVON:
+    return "INVON";
+  case CMD_DISPOFF:
+    return "DISPOFF";
+  case CMD_DISPON:
+    return "DISPON";
+  case CMD_CASET:
+    return "CASET";
+  case CMD_RASET:
+    return "RASET";
+  case CMD_RAMWR:
+    return "RAMWR";
+  case CMD_RAMRD:
+    return "RAMRD";
+  case CMD_PTLAR:
+    return "PTLAR";
+  case CMD_VSCRDEF:
+    return "VSCRDEF";
+  case CMD_TEOFF:
+    return "TEOFF";
+  case CMD_TEON:
+    return "TEON";
+  case CMD_MADCTL:
+    return "MADCTL";
+  case CMD_VSCSAD:
+    return "VSCSAD";
+  case CMD_IDMOFF:
+    return "IDMOFF";
+  case CMD_IDMON:
+    return "IDMON";
+  case CMD_COLMOD:
+    return "COLMOD";
+  case CMD_GSCAN:
+    return "GSCAN";
+  default:
+    return "?";
+  }
+}
+
+/*!
+    @brief  Create a controller in its post-reset state
+    @param  controller  Controller flavour
+    @param  panel       Visible GRAM area, see Panel
+*/
+ST77xxEmulator::ST77xxEmulator(Controller controller, const Panel &panel)
+    : _controller(controller), _panel(panel),
+      _gram((size_t)panel.gramWidth * panel.gramHeight, 0), _now(noClock),
+      _cs(true), _dc(true), _rst(true), _readyAt(0), _slpoutOkAt(0),
+      _slpinOkAt(0), _slpoutAt(0), _resetLowAt(0), _framePeriod(16666667),
+      _porchLines(16), _refreshLines(0), _refreshRem(0), _refreshMark(0),
+      _oscPpm(0), _capturing(false) {
+  memset(&_stats, 0, sizeof(_stats));
+  // Frame rate register defaults, used until they are written
+  _rtna = (controller == ST7735) ? 0x01 : 0x0F;
+  _fpa = (controller == ST7735) ? 0x2C : 0x0C;
+  _bpa = (controller == ST7735) ? 0x2D : 0x0C;
+  softwareReset();
+}
+
+/*!
+    @brief  Supply the clock used to timestamp captured events
+    @param  now  Function returning nanoseconds
+*/
+void ST77xxEmulator::setTimeSource(uint64_t (*now)(void)) {
+  settleRefresh();
+  _now = now ? now : noClock;
+  _refreshMark = _now();
+}
+
+/*!
+    @brief  Subtract an earlier snapshot from this one
+    @param  before  Snapshot taken earlier
+    @return Counters accumulated in between
+*/
+ST77xxEmulator::Stats
+ST77xxEmulator::Stats::since(const Stats &before) const {
+  Stats d;
+  d.commands = commands - before.commands;
+  d.dataBytes = dataBytes - before.dataBytes;
+  d.pixelBytes = pixelBytes - before.pixelBytes;
+  d.pixels = pixels - before.pixels;
+  d.readBytes = readBytes - before.readBytes;
+  d.csAssertions = csAssertions - before.csAssertions;
+  d.dcToggles = dcToggles - before.dcToggles;
+  d.resets = resets - before.resets;
+  d.violations = violations - before.violations;
+  for (int i = 0; i < 256; i++)
+    d.opcodes[i] = opcodes[i] - before.opcodes[i];
+  return d;
+}
+
+/*!
+    @brief  Zero all bus counters
+*/
+void ST77xxEmulator::resetStats(void) { memset(&_stats, 0, sizeof(_stats)); }
+
+void ST77xxEmulator::record(uint8_t type, uint8_t value) {
+  if (_capturing) {
+    Event e;
+    e.ns = _now();
+    e.type = type;
+    e.value = value;
+    _capture.push_back(e);
+  }
+}
+
+/*!
+    @brief  Chip select line changed
+    @param  level  New level (false = asserted)
+*/
+void ST77xxEmulator::setCS(bool level) {
+  if (level == _cs)
+    return;
+  _cs = level;
+  if (!level)
+    _stats.csAssertions++;
+  record(level ? EVENT_CS_HIGH : EVENT_CS_LOW, level);
+}
+
+/*!
+    @brief  Data/command line changed
+    @param  level  New level (false = command)
+*/
+void ST77xxEmulator::setDC(bool level) {
+  if (level == _dc)
+    return;
+  _dc = level;
+  _stats.dcToggles++;
+  record(EVENT_DC, level);
+}
+
+/*!
+    @brief  Reset line changed; the rising edge completes a hardware reset
+    @param  level  New level (false = held in reset)
+*/
+void ST77xxEmulator::setReset(bool level) {
+  if (level == _rst)
+    return;
+  _rst = level;
+  settleRefresh();
+  uint64_t now = _now();
+  if (!level) {
+    _resetLowAt = now;
+    return;
+  }
+  if (now - _resetLowAt < 10000)
+    _stats.violations++; // Pulse shorter than 10 us
+  record(EVENT_RESET, 1);
+  // Recovery takes 120 ms instead of 5 when reset out of sleep
+  _readyAt = now + (_sleeping ? 5000000ULL : 120000000ULL);
+  softwareReset();
+}
+
+/*!
+    @brief  Clock one byte through the serial interface
+    @param  mosi  Byte from the host
+    @return Byte the controller drives on MISO (0 when not reading)
+*/
+uint8_t ST77xxEmulator::transfer(uint8_t mosi) {
+  if (_cs || !_rst)
+    return 0;
+  if (!_dc) {
+    beginCommand(mosi);
+    return 0;
+  }
+  if (_readPos < _readQueue.size())
+    return readByte();
+  commandData(mosi);
+  return 0;
+}
+
+/*!
+    @brief  Byte the next transfer() will drive on MISO, without clocking it
+    @return Pending read byte, or 0
+*/
+uint8_t ST77xxEmulator::misoByte(void) const {
+  if (_cs || !_dc || (_readPos >= _readQueue.size()))
+    return 0;
+  return _readQueue[_readPos];
+}
+
+void ST77xxEmulator::softwareReset(void) {
+  _stats.resets++;
+  _cmd = 0;
+  _argCount = 0;
+  _pixelFill = 0;
+  _readQueue.clear();
+  _readPos = 0;
+  _xs = _ys = 0;
+  _col = _row = 0;
+  // The column counter spans GRAM width until MADCTL says otherwise
+  _xe = _panel.gramWidth - 1;
+  _ye = _panel.gramHeight - 1;
+  _madctl = 0;
+  // 18 bits/pixel is the power-on format on all three parts
+  _colmod = (_controller == ST7735) ? 0x06 : 0x66;
+  _inverted = false;
+  _displayOn = false;
+  _sleeping = true;
+  _tearing = false;
+  _scrolling = false;
+  _idle = false;
+  _tfa = _bfa = _ssa = 0;
+  _vsa = _panel.gramHeight;
+  _partial = false;
+  _psl = 0;
+  _pel = _panel.gramHeight - 1;
+}
+
+// Count commands that come sooner than the datasheet minimums allow, and
+// start the waits that the reset and sleep commands impose
+void ST77xxEmulator::checkTiming(uint8_t cmd) {
+  uint64_t now = _now();
+  if ((now < _readyAt) || ((cmd == CMD_SLPOUT) && (now < _slpoutOkAt)) ||
+      ((cmd == CMD_SLPIN) && (now < _slpinOkAt)))
+    _stats.violations++;
+  switch (cmd) {
+  case CMD_SWRESET:
+    _readyAt = now + 5000000ULL;
+    if (!_sleeping) // Loading defaults from sleep out takes longer
+      _slpoutOkAt = now + 120000000ULL;
+    break;
+  case CMD_SLPOUT:
+    if (_sleeping) {
+      _slpoutAt = now;
+      _slpinOkAt = now + 120000000ULL;
+    }
+    _readyAt = now + 5000000ULL;
+    break;
+  case CMD_SLPIN:
+    _readyAt = now + 5000000ULL;
+    break;
+  }
+}
+
+/*!
+    @brief  Whether the booster has come up since the last SLPOUT. It is
+            modelled as taking 10 ms.
+    @return true once the booster is running
+*/
+bool ST77xxEmulator::boosterOn(void) const {
+  return !_sleeping && (_now() - _slpoutAt >= 10000000ULL);
+}
+
+void ST77xxEmulator::beginCommand(uint8_t cmd) {
+  _cmd = cmd;
+  _argCount = 0;
+  _pixelFill = 0;
+  _readQueue.clear();
+  _readPos = 0;
+  _regs[cmd].clear();
+  settleRefresh();
+  _stats.commands++;
+  checkTiming(cmd);
+  _stats.opcodes[cmd]++;
+  record(EVENT_COMMAND, cmd);
+
+  switch (cmd) {
+  case CMD_SWRESET:
+    softwareReset();
+    break;
+  case CMD_SLPIN:
+    _sleeping = true;
+    break;
+  case CMD_SLPOUT:
+    _sleeping = false;
+    break;
+  case CMD_INVOFF:
+    _inverted = false;
+    break;
+  case CMD_INVON:
+    _inverted = true;
+    break;
+  case CMD_DISPOFF:
+    _displayOn = false;
+    break;
+  case CMD_DISPON:
+    _displayOn = true;
+    break;
+  case CMD_PTLON:
+  case CMD_NORON:
+    _partial = (cmd == CMD_PTLON);
+    _scrolling = false; // Either one ends vertical scroll mode
+    break;
+  case CMD_IDMOFF:
+    _idle = false;
+    break;
+  case CMD_IDMON:
+    _idle = true;
+    break;
+  case CMD_TEOFF:
+    _tearing = false;
+    break;
+  case CMD_TEON:
+    _tearing = true; // V-blank only, whatever the (optional) mode argument
+    break;
+  case CMD_GSCAN: {
+    // Serial reads of GSCAN return the two-byte line number directly
+    uint16_t line = scanline(_now());
+    _readQueue.push_back(line >> 8);
+    _readQueue.push_back(line & 0xFF);
+    break;
+  }
+  case CMD_RAMWR:
+    _col = _xs;
+    _row = _ys;
+    break;
+  case CMD_RAMRD:
+    // Serial reads start with a dummy byte, then come in the 18-bit format
+    // whatever COLMOD says; pixels are queued one at a time as they go out
+    _col = _xs;
+    _row = _ys;
+    _readQueue.push_back(0);
+    break;
+  case CMD_RDDPM: {
+    // One byte, no dummy clock
+    uint8_t pm = (_idle ? 0x40 : 0) | (_partial ? 0x20 : 0x08) |
+                 (_displayOn ? 0x04 : 0);
+    if (!_sleeping)
+      pm |= 0x10 | (boosterOn() ? 0x80 : 0);
+    _readQueue.push_back(pm);
+    break;
+  }
+  case CMD_RDDID:
+  case CMD_RDID1:
+  case CMD_RDID2:
+  case CMD_RDID3: {
+    static const uint8_t ids[][3] = {
+        {0x7C, 0x89, 0xF0}, {0x85, 0x85, 0x52}, {0x00, 0x77, 0x96}};
+    const uint8_t *id = ids[_controller];
+    if (cmd == CMD_RDDID) {
+      // 24-bit ID preceded by one dummy clock
+      uint32_t bits = ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+      _readQueue.push_back(bits >> 17);
+      _readQueue.push_back(bits >> 9);
+      _readQueue.push_back(bits >> 1);
+      _readQueue.push_back(bits << 7);
+    } else {
+      _readQueue.push_back(id[cmd - CMD_RDID1]);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+uint8_t ST77xxEmulator::readByte(void) {
+  uint8_t b = _readQueue[_readPos++];
+  _stats.readBytes++;
+  record(EVENT_READ, b);
+  if ((_cmd == CMD_RAMRD) && (_readPos >= _readQueue.size()))
+    queueReadPixel();
+  return b;
+}
+
+// Queue the pixel at the address counters for RAMRD, one byte per channel
+// with the 6 bits left aligned, and move on to the next
+void ST77xxEmulator::queueReadPixel(void) {
+  uint32_t index, p = 0;
+  if (mapAddress(_col, _row, index))
+    p = _gram[index];
+  _readQueue.clear();
+  _readPos = 0;
+  _readQueue.push_back(((p >> 16) & 0x3F) << 2);
+  _readQueue.push_back(((p >> 8) & 0x3F) << 2);
+  _readQueue.push_back((p & 0x3F) << 2);
+  advanceAddress();
+}
+
+void ST77xxEmulator::commandData(uint8_t b) {
+  _stats.dataBytes++;
+  record(EVENT_DATA, b);
+
+  if (_cmd == CMD_RAMWR) {
+    _stats.pixelBytes++;
+    _pixelBytes[_pixelFill++] = b;
+    if ((_colmod & 7) == 5) { // 16 bits/pixel, RGB565
+      if (_pixelFill == 2) {
+        uint16_t c = ((uint16_t)_pixelBytes[0] << 8) | _pixelBytes[1];
+        uint32_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, bl = c & 0x1F;
+        // 5-bit channels widen to 6 by repeating the MSB into the LSB
+        storePixel((((r << 1) | (r >> 4)) << 16) | (g << 8) |
+                   ((bl << 1) | (bl >> 4)));
+        _pixelFill = 0;
+      }
+    } else if ((_colmod & 7) == 3) { // 12 bits/pixel, two pixels in 3 bytes
+      // Each pixel is stored as soon as its 12 bits are in, so a trailing
+      // half byte after an odd pixel count is simply dropped
+      uint16_t c;
+      if (_pixelFill == 2) {
+        c = ((uint16_t)_pixelBytes[0] << 4) | (_pixelBytes[1] >> 4);
+      } else if (_pixelFill == 3) {
+        c = ((uint16_t)(_pixelBytes[1] & 0xF) << 8) | _pixelBytes[2];
+        _pixelFill = 0;
+      } else {
+        return;
+      }
+      uint32_t r = (c >> 8) & 0xF, g = (c >> 4) & 0xF, bl = c & 0xF;
+      // 4-bit channels widen to 6 by repeating the top bits
+      storePixel((((r << 2) | (r >> 2)) << 16) | (((g << 2) | (g >> 2)) << 8) |
+                 ((bl << 2) | (bl >> 2)));
+    } else if (_pixelFill == 3) { // 18 bits/pixel, one byte per channel
+      storePixel(((uint32_t)(_pixelBytes[0] >> 2) << 16) |
+                 ((uint32_t)(_pixelBytes[1] >> 2) << 8) | (_pixelBytes[2] >> 2));
+      _pixelFill = 0;
+    }
+    return;
+  }
+
+  uint16_t n = _argCount++;
+  _regs[_cmd].push_back(b);
+  switch (_cmd) {
+  case CMD_CASET:
+    if (n == 1)
+      _xs = (_regs[_cmd][0] << 8) | b;
+    else if (n == 3)
+      _xe = (_regs[_cmd][2] << 8) | b;
+    break;
+  case CMD_RASET:
+    if (n == 1)
+      _ys = (_regs[_cmd][0] << 8) | b;
+    else if (n == 3)
+      _ye = (_regs[_cmd][2] << 8) | b;
+    break;
+  case CMD_MADCTL:
+    if (n == 0)
+      _madctl = b;
+    break;
+  case CMD_COLMOD:
+    if (n == 0)
+      _colmod = b;
+    break;
+  case CMD_PTLAR:
+    if (n == 3) {
+      settleRefresh();
+      _psl = (_regs[_cmd][0] << 8) | _regs[_cmd][1];
+      _pel = (_regs[_cmd][2] << 8) | b;
+    }
+    break;
+  case CMD_VSCRDEF:
+    if (n == 1)
+      _tfa = (_regs[_cmd][0] << 8) | b;
+    else if (n == 3)
+      _vsa = (_regs[_cmd][2] << 8) | b;
+    else if (n == 5)
+      _bfa = (_regs[_cmd][4] << 8) | b;
+    break;
+  case CMD_VSCSAD:
+    if (n == 1) {
+      _ssa = (_regs[_cmd][0] << 8) | b;
+      _scrolling = true;
+    }
+    break;
+  case CMD_FRMCTR1:
+    if ((_controller == ST7735) && (n == 2)) {
+      _rtna = _regs[_cmd][0] & 0x0F;
+      _fpa = _regs[_cmd][1] & 0x3F;
+      _bpa = b & 0x3F;
+      frameTiming();
+    }
+    break;
+  case CMD_PORCTRL:
+    if ((_controller == ST7789) && (n == 1)) {
+      _bpa = _regs[_cmd][0] & 0x7F;
+      _fpa = b & 0x7F;
+      frameTiming();
+    }
+    break;
+  case CMD_FRCTRL2:
+    if ((_controller == ST7789) && (n == 0)) {
+      _rtna = b & 0x1F;
+      frameTiming();
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/*!
+    @brief  Line the panel is scanning at a given time
+    @param  ns  Host clock
+    @return 0 to gramHeight - 1 while scanning GRAM, higher in the porch
+*/
+uint16_t ST77xxEmulator::scanline(uint64_t ns) const {
+  return (uint16_t)((ns % _framePeriod) * scanLines() / _framePeriod);
+}
+
+/*!
+    @brief  Set the panel refresh period
+    @param  ns  Time for one frame, blanking included
+*/
+void ST77xxEmulator::setFramePeriod(uint64_t ns) {
+  settleRefresh();
+  _framePeriod = ns ? ns : 1;
+  _refreshRem = 0;
+}
+
+// Frame period and porch lines from the frame rate registers:
+// ST7735 (R/S)  fosc 850 kHz, (RTNA x 2 + 40) x (LINE + FPA + BPA + 2)
+// ST7789        fosc 10 MHz, (LINE + FPA + BPA) x (250 + RTNA x 16)
+void ST77xxEmulator::frameTiming(void) {
+  double fosc, clocks;
+  if (_controller == ST7735) {
+    fosc = 850e3;
+    _porchLines = _fpa + _bpa + 2;
+    clocks = (_rtna * 2 + 40) * (double)(_panel.gramHeight + _porchLines);
+  } else {
+    fosc = 10e6;
+    _porchLines = _fpa + _bpa;
+    clocks = (_panel.gramHeight + _porchLines) * (250 + _rtna * 16.0);
+  }
+  setFramePeriod((uint64_t)(clocks * 1e9 / (fosc * (1 + _oscPpm * 1e-6))));
+}
+
+/*!
+    @brief  GRAM rows driven with image data in each frame right now
+    @return Row count
+*/
+uint16_t ST77xxEmulator::drivenLines(void) const {
+  if (!_displayOn || _sleeping)
+    return 0;
+  if (!_partial)
+    return _panel.gramHeight;
+  if (_psl <= _pel)
+    return (_pel < _panel.gramHeight) ? _pel - _psl + 1
+                                      : _panel.gramHeight - _psl;
+  return _panel.gramHeight - _psl + _pel + 1;
+}
+
+/*!
+    @brief  Rows driven with image data since construction
+    @return Running total, in rows (a full frame counts gramHeight)
+*/
+uint64_t ST77xxEmulator::refreshedLines(void) const {
+  uint64_t work = _refreshRem + (_now() - _refreshMark) * drivenLines();
+  return _refreshLines + work / _framePeriod;
+}
+
+// Fold the refresh work done so far into the total, before a change to the
+// state that determines it
+void ST77xxEmulator::settleRefresh(void) {
+  uint64_t now = _now();
+  uint64_t work = _refreshRem + (now - _refreshMark) * drivenLines();
+  _refreshLines += work / _framePeriod;
+  _refreshRem = work % _framePeriod;
+  _refreshMark = now;
+}
+
+/*!
+    @brief  Level of the TE output at a given time
+    @param  ns  Host clock
+    @return true during vertical blanking, if TEON is in effect
+*/
+bool ST77xxEmulator::tearingLevel(uint64_t ns) const {
+  return tearingEnabled() && (scanline(ns) >= _panel.gramHeight);
+}
+
+/*!
+    @brief  Time of the next TE edge, assuming the TE state does not change
+    @param  after   Host clock to search from (exclusive)
+    @param  rising  true for the start of blanking, false for its end
+    @return Host clock of the edge, or UINT64_MAX if TE is off
+*/
+uint64_t ST77xxEmulator::nextTearingEdge(uint64_t after, bool rising) const {
+  if (!tearingEnabled())
+    return UINT64_MAX;
+  // Blanking starts at the first line past GRAM; it ends with the frame
+  uint64_t offset =
+      rising ? (_framePeriod * _panel.gramHeight + scanLines() - 1) /
+                   scanLines()
+             : 0;
+  uint64_t frame = after / _framePeriod;
+  uint64_t edge = frame * _framePeriod + offset;
+  if (edge <= after)
+    edge += _framePeriod;
+  return edge;
+}
+
+/*!
+    @brief  Translate a logical (post-MADCTL) address to a GRAM index
+    @param  col    Column address counter
+    @param  row    Row address counter
+    @param  index  Receives the GRAM index
+    @return false if the address falls outside GRAM
+*/
+bool ST77xxEmulator::mapAddress(uint16_t col, uint16_t row,
+                                uint32_t &index) const {
+  // MV exchanges the counters, then MX/MY mirror the physical axes
+  uint32_t x = (_madctl & MADCTL_MV) ? row : col;
+  uint32_t y = (_madctl & MADCTL_MV) ? col : row;
+  if ((x >= _panel.gramWidth) || (y >= _panel.gramHeight))
+    return false;
+  if (_madctl & MADCTL_MX)
+    x = _panel.gramWidth - 1 - x;
+  if (_madctl & MADCTL_MY)
+    y = _panel.gramHeight - 1 - y;
+  index = y * _panel.gramWidth + x;
+  return true;
+}
+
+void ST77xxEmulator::storePixel(uint32_t rgb666) {
+  uint32_t index;
+  if (mapAddress(_col, _row, index)) {
+    _gram[index] = rgb666;
+    _stats.pixels++;
+  }
+  advanceAddress();
+}
+
+// Column counter wraps inside the window, then the row counter
+void ST77xxEmulator::advanceAddress(void) {
+  if (_col >= _xe) {
+    _col = _xs;
+    _row = (_row >= _ye) ? _ys : (_row + 1);
+  } else {
+    _col++;
+  }
+}
+
+/*!
+    @brief  Read raw GRAM
+    @param  x  Physical GRAM column
+    @param  y  Physical GRAM row
+    @return 0x00RRGGBB with 6 significant bits per channel
+*/
+uint32_t ST77xxEmulator::gramPixel(uint16_t x, uint16_t y) const {
+  if ((x >= _panel.gramWidth) || (y >= _panel.gramHeight))
+    return 0;
+  return _gram[(uint32_t)y * _panel.gramWidth + x];
+}
+
+/*!
+    @brief  What the glass shows at a viewer coordinate
+    @param  vx  Column as seen by the viewer
+    @param  vy  Row as seen by the viewer
+    @return 0x00RRGGBB, 8 bits per channel
+*/
+uint32_t ST77xxEmulator::viewPixel(uint16_t vx, uint16_t vy) const {
+  if (!_displayOn || _sleeping)
+    return 0;
+  uint16_t gx = _panel.x + (_panel.flipX ? (_panel.width - 1 - vx) : vx);
+  uint16_t gy = _panel.y + (_panel.flipY ? (_panel.height - 1 - vy) : vy);
+  if (!lineDriven(gy))
+    return 0; // Non-display area of partial mode
+  uint32_t p = gramPixel(gx, scannedRow(gy));
+  if (_inverted != _panel.inverted)
+    p ^= 0x3F3F3F;
+  if (_idle) // 8 colors: only the top bit of each channel is shown
+    p = ((p & 0x202020) >> 5) * 0x3F;
+  uint32_t r = (p >> 16) & 0x3F, g = (p >> 8) & 0x3F, b = p & 0x3F;
+  if ((((_madctl & MADCTL_BGR) != 0) != _panel.bgr)) {
+    uint32_t t = r;
+    r = b;
+    b = t;
+  }
+  r = (r << 2) | (r >> 4);
+  g = (g << 2) | (g >> 4);
+  b = (b << 2) | (b >> 4);
+  return (r << 16) | (g << 8) | b;
+}
+
+/*!
+    @brief  Whether a scan line is driven with image data
+    @param  line  Scan line
+    @return false outside the partial area in partial mode
+*/
+bool ST77xxEmulator::lineDriven(uint16_t line) const {
+  if (!_partial)
+    return true;
+  if (_psl <= _pel)
+    return (line >= _psl) && (line <= _pel);
+  return (line >= _psl) || (line <= _pel); // Area wraps past the last row
+}
+
+/*!
+    @brief  GRAM row the panel shows on a scan line, after vertical scroll
+    @param  line  Scan line (GRAM row when not scrolling)
+    @return GRAM row
+*/
+uint16_t ST77xxEmulator::scannedRow(uint16_t line) const {
+  // An inconsistent definition leaves the picture unscrolled
+  if (!_scrolling || !_vsa ||
+      ((uint32_t)_tfa + _vsa + _bfa != _panel.gramHeight))
+    return line;
+  if ((line < _tfa) || (line >= _tfa + _vsa))
+    return line;
+  return _tfa + (((_ssa >= _tfa) ? (_ssa - _tfa) : 0) + (line - _tfa)) % _vsa;
+}
+
+/*!
+    @brief  Render the visible panel as the viewer sees it
+    @param  rgb  Receives width * height * 3 bytes, row-major
+*/
+void ST77xxEmulator::render(std::vector<uint8_t> &rgb) const {
+  rgb.resize((size_t)_panel.width * _panel.height * 3);
+  size_t i = 0;
+  for (uint16_t y = 0; y < _panel.height; y++) {
+    for (uint16_t x = 0; x < _panel.width; x++) {
+      uint32_t p = viewPixel(x, y);
+      rgb[i++] = p >> 16;
+      rgb[i++] = p >> 8;
+      rgb[i++] = p;
+    }
+  }
+}
+
+/*!
+    @brief  Write the visible panel to a binary PPM (P6) file
+    @param  path  Output file name
+    @return true on success
+*/
+bool ST77xxEmulator::writePPM(const char *path) const {
+  std::vector<uint8_t> rgb;
+  render(rgb);
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  fprintf(f, "P6\n%u %u\n255\n", _panel.width, _panel.height);
+  bool ok = fwrite(rgb.data(), 1, rgb.size(), f) == rgb.size();
+  return (fclose(f) == 0) && ok;
+}
+
+/*!
+    @brief  Load a binary PPM (P6, maxval 255) file
+    @param  path    Input file name
+    @param  rgb     Receives pixel data
+    @param  width   Receives image width
+    @param  height  Receives image height
+    @return true on success
+*/
+bool ST77xxEmulator::readPPM(const char *path, std::vector<uint8_t> &rgb,
+                             uint16_t &width, uint16_t &height) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  unsigned w, h, maxval;
+  bool ok = (fscanf(f, "P6 %u %u %u", &w, &h, &maxval) == 3) &&
+            (maxval == 255) && (fgetc(f) != EOF);
+  if (ok) {
+    rgb.resize((size_t)w * h * 3);
+    ok = fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+    width = w;
+    height = h;
+  }
+  fclose(f);
+  return ok;
+}
+
+/*!
+    @brief  Compare two rendered frames of the same size
+    @param  a     First frame (RGB888)
+    @param  b     Second frame (RGB888)
+    @param  diff  Optional; receives a frame with differing pixels in red
+                  over a dimmed copy of a
+    @return Number of differing pixels (all of them if sizes differ)
+*/
+uint32_t ST77xxEmulator::diffImages(const std::vector<uint8_t> &a,
+                                    const std::vector<uint8_t> &b,
+                                    std::vector<uint8_t> *diff) {
+  if (a.size() != b.size())
+    return (uint32_t)(((a.size() > b.size()) ? a.size() : b.size()) / 3);
+  uint32_t count = 0;
+  if (diff)
+    diff->resize(a.size());
+  for (size_t i = 0; i < a.size(); i += 3) {
+    bool differs = (a[i] != b[i]) || (a[i + 1] != b[i + 1]) ||
+                   (a[i + 2] != b[i + 2]);
+    count += differs;
+    if (diff) {
+      (*diff)[i] = differs ? 255 : (a[i] >> 2);
+      (*diff)[i + 1] = differs ? 0 : (a[i + 1] >> 2);
+      (*diff)[i + 2] = differs ? 0 : (a[i + 2] >> 2);
+    }
+  }
+  return count;
+}
+
+/*!
+    @brief  Dump the captured events as text, one per line
+    @param  out  Destination stream
+*/
+void ST77xxEmulator::writeTrace(FILE *out) const {
+  for (size_t i = 0; i < _capture.size(); i++) {
+    const Event &e = _capture[i];
+    fprintf(out, "%12llu ", (unsigned long long)e.ns);
+    switch (e.type) {
+    case EVENT_CS_LOW:
+      fprintf(out, "CS   low\n");
+      break;
+    case EVENT_CS_HIGH:
+      fprintf(out, "CS   high\n");
+      break;
+    case EVENT_DC:
+      fprintf(out, "DC   %s\n", e.value ? "data" : "command");
+      break;
+    case EVENT_COMMAND:
+      fprintf(out, "CMD  0x%02X %s\n", e.value, commandName(e.value));
+      break;
+    case EVENT_DATA:
+      fprintf(out, "DATA 0x%02X\n", e.value);
+      break;
+    case EVENT_READ:
+      fprintf(out, "READ 0x%02X\n", e.value);
+      break;
+    case EVENT_RESET:
+      fprintf(out, "RST\n");
+      break;
+    }
+  }
+}
@@ -0,0 +1,225 @@
+/*!
+ * @file ST77xxEmulator.h
+ *
+ * Host-side model of the ST7735 / ST7789 / ST7796S display controllers.
+ *
+ * The emulator sits on the far side of the stand-in SPI/GPIO layer used by
+ * the Linux build (see ST77xxHost.h). It decodes the byte stream exactly as
+ * the controller would -- commands on DC low, parameters and pixel data on
+ * DC high, framing by CS -- and keeps an emulated GRAM plus the registers
+ * that affect how GRAM is addressed and shown. Every byte, DC change and CS
+ * assertion is counted (and optionally captured with a timestamp), which
+ * makes it possible to profile the bus traffic of individual draw calls
+ * and to diff rendered frames without hardware.
+ *
+ * This file is host-only and is not compiled by the Arduino IDE.
+ */
+
+#ifndef _ST77XX_EMULATOR_H_
+#define _ST77XX_EMULATOR_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/*!
+ * @brief Emulated ST77xx controller with GRAM, register model and bus
+ *        capture.
+ */
+class ST77xxEmulator {
+public:
+  /*! Controller flavours; they differ in GRAM size and reset defaults. */
+  enum Controller { ST7735, ST7789, ST7796S };
+
+  /*!
+   * @brief Describes which part of GRAM the glass actually shows, and how.
+   *
+   * Panels rarely use the whole GRAM; the Adafruit driver compensates with
+   * _colstart/_rowstart. Use fromOffsets() to derive the visible area from
+   * the same offsets the driver uses at rotation 0.
+   */
+  struct Panel {
+    uint16_t gramWidth;  ///< GRAM columns (physical)
+    uint16_t gramHeight; ///< GRAM rows (physical)
+    uint16_t x;          ///< First visible GRAM column
+    uint16_t y;          ///< First visible GRAM row
+    uint16_t width;      ///< Visible columns
+    uint16_t height;     ///< Visible rows
+    bool flipX;          ///< Glass scans columns right-to-left
+    bool flipY;          ///< Glass scans rows bottom-to-top
+    bool bgr;            ///< Glass is wired BGR (MADCTL BGR compensates)
+    bool inverted;       ///< Glass is normally-black (INVON compensates)
+
+    static Panel fromOffsets(uint16_t gramWidth, uint16_t gramHeight,
+                             uint16_t width, uint16_t height,
+                             uint16_t colstart, uint16_t rowstart, bool mx,
+                             bool my, bool bgr = false, bool inverted = false);
+  };
+
+  /*! Kinds of captured bus events. */
+  enum EventType {
+    EVENT_CS_LOW,  ///< Chip select asserted
+    EVENT_CS_HIGH, ///< Chip select released
+    EVENT_DC,      ///< DC line changed, value is new level
+    EVENT_COMMAND, ///< Command byte, value is opcode
+    EVENT_DATA,    ///< Parameter or pixel byte written
+    EVENT_READ,    ///< Byte driven back on MISO
+    EVENT_RESET    ///< Hardware reset pulse
+  };
+
+  /*! One captured bus event. */
+  struct Event {
+    uint64_t ns;   ///< Host clock when the event happened
+    uint8_t type;  ///< One of EventType
+    uint8_t value; ///< Byte value or line level
+  };
+
+  /*! Running bus counters; subtract two snapshots to profile a call. */
+  struct Stats {
+    uint32_t commands;     ///< Command bytes
+    uint32_t dataBytes;    ///< Parameter and pixel bytes written
+    uint32_t pixelBytes;   ///< Subset of dataBytes sent after RAMWR
+    uint32_t pixels;       ///< Complete pixels stored to GRAM
+    uint32_t readBytes;    ///< Bytes clocked out on MISO
+    uint32_t csAssertions; ///< CS high-to-low transitions
+    uint32_t dcToggles;    ///< DC level changes
+    uint32_t resets;       ///< Hardware and software resets
+    uint32_t violations;   ///< Commands sent sooner than the datasheet allows
+    uint32_t opcodes[256]; ///< Per-opcode command counts
+
+    Stats since(const Stats &before) const;
+    uint32_t busBytes(void) const { return commands + dataBytes + readBytes; }
+  };
+
+  ST77xxEmulator(Controller controller, const Panel &panel);
+
+  static Panel defaultPanel(Controller controller, uint16_t width = 0,
+                            uint16_t height = 0);
+  static const char *commandName(uint8_t cmd);
+
+  void setTimeSource(uint64_t (*now)(void));
+
+  // Pin-level interface, driven by the host SPI/GPIO layer
+  void setCS(bool level);
+  void setDC(bool level);
+  void setReset(bool level);
+  uint8_t transfer(uint8_t mosi);
+  uint8_t misoByte(void) const;
+  bool selected(void) const { return !_cs; }
+
+  // Bus capture and counters
+  const Stats &stats(void) const { return _stats; }
+  void resetStats(void);
+  void setCapture(bool enable) { _capturing = enable; }
+  const std::vector<Event> &capture(void) const { return _capture; }
+  void clearCapture(void) { _capture.clear(); }
+  void writeTrace(FILE *out) const;
+
+  // Controller state
+  Controller controller(void) const { return _controller; }
+  const Panel &panel(void) const { return _panel; }
+  uint8_t madctl(void) const { return _madctl; }
+  uint8_t colmod(void) const { return _colmod; }
+  bool inverted(void) const { return _inverted; }
+  bool displayOn(void) const { return _displayOn; }
+  bool sleeping(void) const { return _sleeping; }
+  bool scrolling(void) const { return _scrolling; }
+  bool partialMode(void) const { return _partial; }
+  bool idleMode(void) const { return _idle; }
+  bool boosterOn(void) const;
+  const std::vector<uint8_t> &registerValue(uint8_t cmd) const {
+    return _regs[cmd];
+  }
+  uint32_t gramPixel(uint16_t x, uint16_t y) const;
+
+  // Refresh timing. The panel scans GRAM rows top to bottom, followed by a
+  // few porch lines of vertical blanking, continuously from time zero.
+  // Writing the frame rate registers (FRMCTR1 on the ST7735, PORCTRL and
+  // FRCTRL2 on the ST7789) sets both from the datasheet formula, at the
+  // typical oscillator frequency plus the oscillator error.
+  void setFramePeriod(uint64_t ns);
+  void setOscillatorError(int32_t ppm) { _oscPpm = ppm; }
+  uint64_t framePeriod(void) const { return _framePeriod; }
+  uint16_t scanLines(void) const { return _panel.gramHeight + _porchLines; }
+  uint16_t scanline(uint64_t ns) const;
+  bool tearingEnabled(void) const { return _tearing && !_sleeping; }
+  bool tearingLevel(uint64_t ns) const;
+  uint64_t nextTearingEdge(uint64_t after, bool rising) const;
+
+  // Refresh work: GRAM rows the panel drives with image data each frame
+  // (none when off or asleep, the partial area in partial mode), and their
+  // running total since construction, a proxy for panel drive power.
+  uint16_t drivenLines(void) const;
+  uint64_t refreshedLines(void) const;
+
+  // Rendered output
+  void render(std::vector<uint8_t> &rgb) const;
+  bool writePPM(const char *path) const;
+  static bool readPPM(const char *path, std::vector<uint8_t> &rgb,
+                      uint16_t &width, uint16_t &height);
+  static uint32_t diffImages(const std::vector<uint8_t> &a,
+                             const std::vector<uint8_t> &b,
+                             std::vector<uint8_t> *diff = NULL);
+
+private:
+  void record(uint8_t type, uint8_t value);
+  void softwareReset(void);
+  void checkTiming(uint8_t cmd);
+  void beginCommand(uint8_t cmd);
+  void commandData(uint8_t b);
+  uint8_t readByte(void);
+  void queueReadPixel(void);
+  void storePixel(uint32_t rgb666);
+  void advanceAddress(void);
+  bool mapAddress(uint16_t col, uint16_t row, uint32_t &index) const;
+  uint32_t viewPixel(uint16_t vx, uint16_t vy) const;
+  uint16_t scannedRow(uint16_t line) const;
+  bool lineDriven(uint16_t line) const;
+  void settleRefresh(void);
+  void frameTiming(void);
+
+  Controller _controller;
+  Panel _panel;
+  std::vector<uint32_t> _gram; // 0x00RRGGBB, 6 significant bits per channel
+  std::vector<uint8_t> _regs[256];
+  uint64_t (*_now)(void);
+
+  // Interface state
+  bool _cs, _dc, _rst;
+  uint8_t _cmd;
+  uint16_t _argCount;
+  uint8_t _pixelBytes[3];
+  uint8_t _pixelFill;
+  std::vector<uint8_t> _readQueue;
+  size_t _readPos;
+
+  // Registers
+  uint16_t _xs, _xe, _ys, _ye;
+  uint16_t _col, _row;
+  uint8_t _madctl, _colmod;
+  bool _inverted, _displayOn, _sleeping, _tearing;
+  bool _scrolling, _idle;
+  uint16_t _tfa, _vsa, _bfa, _ssa; // Vertical scroll definition and start
+  bool _partial;
+  uint16_t _psl, _pel; // Partial area start and end rows
+
+  // Reset and sleep timing: host clock before which a command, SLPOUT or
+  // SLPIN would break a datasheet minimum
+  uint64_t _readyAt, _slpoutOkAt, _slpinOkAt, _slpoutAt;
+  uint64_t _resetLowAt;
+
+  // Refresh timing
+  uint64_t _framePeriod;
+  uint16_t _porchLines;
+  uint64_t _refreshLines; // Lines driven up to _refreshMark
+  uint64_t _refreshRem;   // Fraction of a line, in line-ns
+  uint64_t _refreshMark;
+  uint8_t _rtna, _fpa, _bpa; // Line period and porches, register values
+  int32_t _oscPpm;           // Oscillator error, parts per million
+
+  Stats _stats;
+  bool _capturing;
+  std::vector<Event> _capture;
+};
+
+#endif // _ST77XX_EMULATOR_H_
@@ -0,0 +1,48 @@
+/*!
+ * @file ST77xxHost.h
+ *
+ * Wiring between the stand-in Arduino core used for Linux builds and one or
+ * more ST77xxEmulator instances.
+ *
+ * The host core keeps a virtual clock instead of reading the wall clock:
+ * delay() advances it by the requested amount and every SPI byte advances
+ * it by the time the byte would occupy the bus at the current SPISettings
+ * clock. millis()/micros() report this clock, so timings measured on the
+ * host are reproducible and reflect bus cost rather than host CPU speed.
+ * yield() advances it by one microsecond, so busy-wait loops that yield
+ * (as they should on Arduino) make progress. Interrupts attached to an
+ * emulator's TE pin fire at the virtual time of each edge.
+ *
+ * This file is host-only and is not compiled by the Arduino IDE.
+ */
+
+#ifndef _ST77XX_HOST_H_
+#define _ST77XX_HOST_H_
+
+#include "ST77xxEmulator.h"
+#include <stdint.h>
+
+namespace ST77xxHost {
+
+/*!
+    @brief  Connect an emulated controller to the stand-in GPIO/SPI layer
+    @param  emu   Controller model
+    @param  cs    Chip select pin (-1 if tied low)
+    @param  dc    Data/command pin
+    @param  rst   Reset pin (-1 if unused)
+    @param  mosi  Software SPI data pin (-1 for hardware SPI)
+    @param  sclk  Software SPI clock pin (-1 for hardware SPI)
+    @param  miso  Software SPI read pin (-1 if not wired)
+*/
+void attach(ST77xxEmulator *emu, int8_t cs, int8_t dc, int8_t rst = -1,
+            int8_t mosi = -1, int8_t sclk = -1, int8_t miso = -1);
+void attachTearing(ST77xxEmulator *emu, int8_t te);
+void detachAll(void);
+
+uint64_t nanos(void);
+void advance(uint64_t ns);
+void reset(void);
+
+} // namespace ST77xxHost
+
+#endif // _ST77XX_HOST_H_
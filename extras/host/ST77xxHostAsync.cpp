@@ -0,0 +1,75 @@
+/*!
+ * @file ST77xxHostAsync.cpp
+ *
+ * Worker-thread transfer for Adafruit_ST77xxAsync. See ST77xxHostAsync.h.
+ */
+
+#include "ST77xxHostAsync.h"
+
+/*!
+    @brief  Create the pipeline and start its worker thread
+    @param  tft     Display the buffers are pushed to
+    @param  pixels  Size of each of the two buffers
+*/
+ST77xxHostAsync::ST77xxHostAsync(Adafruit_ST77xx &tft, uint32_t pixels)
+    : Adafruit_ST77xxAsync(tft, pixels), worker(&ST77xxHostAsync::run, this) {}
+
+/*!
+    @brief  Finish any transfer in flight and stop the worker thread
+*/
+ST77xxHostAsync::~ST77xxHostAsync(void) {
+  wait();
+  {
+    std::lock_guard<std::mutex> g(lock);
+    quit = true;
+  }
+  wake.notify_one();
+  worker.join();
+}
+
+/*!
+    @brief  Hand a buffer to the worker thread and return immediately
+    @param  pixels  Pixels to send
+    @param  len     Pixel count
+*/
+void ST77xxHostAsync::startTransfer(uint16_t *pixels, uint32_t len) {
+  {
+    std::lock_guard<std::mutex> g(lock);
+    jobPixels = pixels;
+    jobLen = len;
+    pending = true;
+  }
+  wake.notify_one();
+}
+
+/*!
+    @brief  Check whether the worker thread is still sending
+    @return true if it is
+*/
+bool ST77xxHostAsync::transferBusy(void) {
+  std::lock_guard<std::mutex> g(lock);
+  return pending;
+}
+
+/*!
+    @brief  Block until the worker thread has sent the last buffer
+*/
+void ST77xxHostAsync::waitTransfer(void) {
+  std::unique_lock<std::mutex> g(lock);
+  idle.wait(g, [this] { return !pending; });
+}
+
+// Worker thread: the blocking writePixels() plays the part of the DMA engine
+void ST77xxHostAsync::run(void) {
+  std::unique_lock<std::mutex> g(lock);
+  for (;;) {
+    wake.wait(g, [this] { return pending || quit; });
+    if (quit)
+      return;
+    g.unlock();
+    display.writePixels(jobPixels, jobLen);
+    g.lock();
+    pending = false;
+    idle.notify_all();
+  }
+}
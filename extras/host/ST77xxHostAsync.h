@@ -0,0 +1,41 @@
+/*!
+ * @file ST77xxHostAsync.h
+ *
+ * Adafruit_ST77xxAsync with its transfer run on a worker thread, standing in
+ * for the DMA engine of a microcontroller. The pipeline logic (buffer swaps,
+ * fences, completion callbacks) is exactly the library's; only the three
+ * transfer methods are replaced.
+ *
+ * This file is host-only and is not compiled by the Arduino IDE.
+ */
+
+#ifndef _ST77XX_HOST_ASYNC_H_
+#define _ST77XX_HOST_ASYNC_H_
+
+#include <Adafruit_ST77xxAsync.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class ST77xxHostAsync : public Adafruit_ST77xxAsync {
+public:
+  ST77xxHostAsync(Adafruit_ST77xx &tft, uint32_t pixels);
+  ~ST77xxHostAsync(void);
+
+protected:
+  void startTransfer(uint16_t *pixels, uint32_t len);
+  bool transferBusy(void);
+  void waitTransfer(void);
+
+private:
+  void run(void);
+
+  std::mutex lock;
+  std::condition_variable wake, idle;
+  uint16_t *jobPixels = NULL;
+  uint32_t jobLen = 0;
+  bool pending = false, quit = false;
+  std::thread worker; // Last, so it starts after everything it uses
+};
+
+#endif // _ST77XX_HOST_ASYNC_H_
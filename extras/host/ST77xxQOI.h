@@ -0,0 +1,92 @@
+/*!
+ * @file ST77xxQOI.h
+ *
+ * Encoder for the QOI image format (qoiformat.org) read by
+ * Adafruit_ST77xx::drawQOI(). Any QOI encoder will do; this one lets the
+ * host tools and tests make images from PPMs without another dependency.
+ */
+
+#ifndef _ST77XX_QOI_H_
+#define _ST77XX_QOI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace ST77xxQOI {
+
+inline void put32(std::vector<uint8_t> &out, uint32_t v) {
+  for (int s = 24; s >= 0; s -= 8)
+    out.push_back(v >> s);
+}
+
+/*!
+  @brief  Encode an opaque RGB image
+  @param  rgb     Image, 3 bytes per pixel, rows one after the other
+  @param  w       Width in pixels
+  @param  h       Height in pixels
+  @param  to565   Round colors to what the display shows first (lowest bits
+                  replicated from the top ones). The panel shows the same
+                  image, and it compresses better.
+  @return The .qoi file's bytes
+*/
+inline std::vector<uint8_t> encode(const uint8_t *rgb, uint32_t w, uint32_t h,
+                                   bool to565 = true) {
+  std::vector<uint8_t> out = {'q', 'o', 'i', 'f'};
+  put32(out, w);
+  put32(out, h);
+  out.push_back(3); // RGB
+  out.push_back(0); // sRGB with linear alpha
+
+  // Entries start out transparent black, which no opaque pixel matches
+  uint8_t index[64][4] = {}, prev[4] = {0, 0, 0, 255};
+  uint8_t run = 0;
+  size_t count = (size_t)w * h;
+  for (size_t i = 0; i < count; i++) {
+    uint8_t px[4] = {rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2], 255};
+    if (to565) {
+      px[0] = (px[0] & 0xF8) | (px[0] >> 5);
+      px[1] = (px[1] & 0xFC) | (px[1] >> 6);
+      px[2] = (px[2] & 0xF8) | (px[2] >> 5);
+    }
+    if (!memcmp(px, prev, 4)) {
+      if ((++run == 62) || (i + 1 == count)) {
+        out.push_back(0xC0 | (run - 1)); // QOI_OP_RUN
+        run = 0;
+      }
+      continue;
+    }
+    if (run) {
+      out.push_back(0xC0 | (run - 1));
+      run = 0;
+    }
+    uint8_t h6 = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63;
+    if (!memcmp(index[h6], px, 4)) {
+      out.push_back(h6); // QOI_OP_INDEX
+    } else {
+      memcpy(index[h6], px, 4);
+      int8_t vr = px[0] - prev[0], vg = px[1] - prev[1], vb = px[2] - prev[2];
+      int8_t vgr = vr - vg, vgb = vb - vg;
+      if ((vr >= -2) && (vr <= 1) && (vg >= -2) && (vg <= 1) && (vb >= -2) &&
+          (vb <= 1)) {
+        out.push_back(0x40 | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+      } else if ((vgr >= -8) && (vgr <= 7) && (vgb >= -8) && (vgb <= 7) &&
+                 (vg >= -32) && (vg <= 31)) {
+        out.push_back(0x80 | (vg + 32)); // QOI_OP_LUMA
+        out.push_back(((vgr + 8) << 4) | (vgb + 8));
+      } else {
+        out.push_back(0xFE); // QOI_OP_RGB
+        out.insert(out.end(), px, px + 3);
+      }
+    }
+    memcpy(prev, px, 4);
+  }
+  static const uint8_t end[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+  out.insert(out.end(), end, end + 8);
+  return out;
+}
+
+} // namespace ST77xxQOI
+
+#endif // _ST77XX_QOI_H_
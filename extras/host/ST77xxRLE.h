@@ -0,0 +1,79 @@
+/*!
+ * @file ST77xxRLE.h
+ *
+ * Encoder for the run-length format read by Adafruit_ST77xx::drawRLEBitmap().
+ * Each packet starts with a count byte: 0x01-0x7F is a literal of that many
+ * pixels, 0x81-0xFF a run of (count & 0x7F) copies of the one pixel that
+ * follows; 0x00 and 0x80 take a 16-bit count from the next two bytes.
+ * Counts and 5-6-5 pixels are stored most significant byte first.
+ */
+
+#ifndef _ST77XX_RLE_H_
+#define _ST77XX_RLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ST77xxRLE {
+
+/*! Shortest repeat worth a run packet. Two equal pixels cost as much either
+    way, and fewer packets decode faster. */
+static const size_t minRun = 3;
+
+inline void putCount(std::vector<uint8_t> &out, uint8_t flag, size_t n) {
+  if (n < 0x80) {
+    out.push_back(flag | n);
+  } else {
+    out.push_back(flag);
+    out.push_back(n >> 8);
+    out.push_back(n & 0xFF);
+  }
+}
+
+inline void putPixel(std::vector<uint8_t> &out, uint16_t c) {
+  out.push_back(c >> 8);
+  out.push_back(c & 0xFF);
+}
+
+/*!
+  @brief  Encode 5-6-5 pixels, rows one after the other
+  @param  pixels  Image, width x height pixels
+  @param  count   Pixel count
+  @return Encoded stream
+*/
+inline std::vector<uint8_t> encode(const uint16_t *pixels, size_t count) {
+  std::vector<uint8_t> out;
+  size_t i = 0, lit = 0; // Literal pixels pending before i
+  while (i < count) {
+    size_t n = 1;
+    while ((i + n < count) && (pixels[i + n] == pixels[i]) && (n < 0xFFFF))
+      n++;
+    if ((n < minRun) && (lit + n <= 0xFFFF)) {
+      lit += n;
+      i += n;
+      continue;
+    }
+    if (lit) {
+      putCount(out, 0x00, lit);
+      for (size_t j = i - lit; j < i; j++)
+        putPixel(out, pixels[j]);
+      lit = 0;
+    }
+    if (n < minRun)
+      continue; // Literal was full; pixels at i start the next one
+    putCount(out, 0x80, n);
+    putPixel(out, pixels[i]);
+    i += n;
+  }
+  if (lit) {
+    putCount(out, 0x00, lit);
+    for (size_t j = count - lit; j < count; j++)
+      putPixel(out, pixels[j]);
+  }
+  return out;
+}
+
+} // namespace ST77xxRLE
+
+#endif // _ST77XX_RLE_H_
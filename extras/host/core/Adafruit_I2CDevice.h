@@ -0,0 +1,2 @@
+// Adafruit_GFX.h includes the BusIO headers for the OLED classes, which the
+// host build does not compile. Empty stand-ins keep the include happy.
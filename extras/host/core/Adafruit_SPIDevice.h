@@ -0,0 +1 @@
+// See Adafruit_I2CDevice.h in this directory.
@@ -0,0 +1,345 @@
+/*!
+ * @file HostCore.cpp
+ *
+ * Implementation of the stand-in Arduino core for Linux builds: GPIO, SPI,
+ * timing, Print/Stream helpers and Serial. See ST77xxHost.h.
+ */
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "ST77xxHost.h"
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+
+#define HOST_MAX_DEVICES 8
+
+namespace {
+
+struct Device {
+  ST77xxEmulator *emu;
+  int8_t cs, dc, rst, mosi, sclk, miso, te;
+  uint8_t shiftOut, shiftIn, bits; // software SPI shift state
+};
+
+struct Interrupt {
+  void (*isr)(void);
+  int mode;
+};
+
+Device devices[HOST_MAX_DEVICES];
+uint8_t deviceCount = 0;
+uint8_t pinLevel[256];
+// Atomic because ST77xxHostAsync transfers from a worker thread
+std::atomic<uint64_t> clockNs(0);
+
+Interrupt interruptTable[256];
+uint8_t interruptCount = 0;
+std::recursive_mutex interruptLock; // Serializes edge delivery
+
+// Earliest TE edge that has an interrupt attached, in (after, until]
+bool nextInterrupt(uint64_t after, uint64_t until, uint64_t &when,
+                   void (*&isr)(void)) {
+  bool found = false;
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    Device &d = devices[i];
+    if (d.te < 0)
+      continue;
+    Interrupt &irq = interruptTable[(uint8_t)d.te];
+    if (!irq.isr)
+      continue;
+    for (int rising = 0; rising < 2; rising++) {
+      if ((irq.mode == RISING) && !rising)
+        continue;
+      if ((irq.mode == FALLING) && rising)
+        continue;
+      uint64_t t = d.emu->nextTearingEdge(after, rising);
+      if ((t <= until) && (!found || (t < when))) {
+        when = t;
+        isr = irq.isr;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+// Undriven pins read high, as if pulled up
+struct PinInit {
+  PinInit() { memset(pinLevel, HIGH, sizeof(pinLevel)); }
+} pinInit;
+
+} // namespace
+
+namespace ST77xxHost {
+
+void attach(ST77xxEmulator *emu, int8_t cs, int8_t dc, int8_t rst,
+            int8_t mosi, int8_t sclk, int8_t miso) {
+  if (deviceCount >= HOST_MAX_DEVICES)
+    return;
+  Device &d = devices[deviceCount++];
+  d.emu = emu;
+  d.cs = cs;
+  d.dc = dc;
+  d.rst = rst;
+  d.mosi = mosi;
+  d.sclk = sclk;
+  d.miso = miso;
+  d.te = -1;
+  d.shiftOut = d.shiftIn = d.bits = 0;
+  emu->setTimeSource(nanos);
+  emu->setCS(cs < 0 ? false : (pinLevel[(uint8_t)cs] != LOW));
+}
+
+/*!
+    @brief  Route an emulator's TE output to a pin, for digitalRead() and
+            attachInterrupt(). The emulator must already be attached.
+    @param  emu  Controller model
+    @param  te   Pin the TE output is wired to
+*/
+void attachTearing(ST77xxEmulator *emu, int8_t te) {
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    if (devices[i].emu == emu)
+      devices[i].te = te;
+  }
+}
+
+void detachAll(void) { deviceCount = 0; }
+
+/*!
+    @brief  Current virtual time
+    @return Nanoseconds since reset()
+*/
+uint64_t nanos(void) { return clockNs; }
+
+/*!
+    @brief  Move the virtual clock forward
+    @param  ns  Nanoseconds to add
+*/
+void advance(uint64_t ns) {
+  if (!interruptCount) {
+    clockNs += ns;
+    return;
+  }
+  // Step through each TE edge in the interval, running its handler with the
+  // clock set to the edge
+  std::lock_guard<std::recursive_mutex> g(interruptLock);
+  uint64_t until = clockNs + ns, when = 0;
+  void (*isr)(void);
+  while (nextInterrupt(clockNs, until, when, isr)) {
+    clockNs = when;
+    isr();
+  }
+  clockNs = until;
+}
+
+/*!
+    @brief  Zero the clock and pin state, and forget attached devices
+*/
+void reset(void) {
+  clockNs = 0;
+  deviceCount = 0;
+  memset(interruptTable, 0, sizeof(interruptTable));
+  interruptCount = 0;
+  memset(pinLevel, HIGH, sizeof(pinLevel));
+}
+
+} // namespace ST77xxHost
+
+// GPIO ********************************************************************
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  uint8_t old = pinLevel[pin];
+  pinLevel[pin] = val ? HIGH : LOW;
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    Device &d = devices[i];
+    int8_t p = (int8_t)pin;
+    if (p == d.cs) {
+      d.emu->setCS(val != LOW);
+      d.bits = 0;
+    } else if (p == d.dc)
+      d.emu->setDC(val != LOW);
+    else if (p == d.rst)
+      d.emu->setReset(val != LOW);
+    else if ((p == d.sclk) && val && !old && d.emu->selected()) {
+      // Software SPI: sample MOSI on the rising clock edge. The reply byte
+      // is latched at the first edge so MISO can be read bit by bit.
+      if (d.bits == 8)
+        d.bits = 0;
+      if (d.bits == 0)
+        d.shiftIn = d.emu->misoByte();
+      d.shiftOut = (d.shiftOut << 1) | (pinLevel[(uint8_t)d.mosi] != LOW);
+      if (++d.bits == 8)
+        d.emu->transfer(d.shiftOut);
+    }
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    Device &d = devices[i];
+    if (((int8_t)pin == d.miso) && d.emu->selected() && d.bits)
+      return (d.shiftIn >> (8 - d.bits)) & 1; // MSB first
+    if ((int8_t)pin == d.te)
+      return d.emu->tearingLevel(ST77xxHost::nanos()) ? HIGH : LOW;
+  }
+  return pinLevel[pin];
+}
+
+// Timing ******************************************************************
+
+unsigned long millis(void) {
+  return (unsigned long)(ST77xxHost::nanos() / 1000000ULL);
+}
+
+unsigned long micros(void) {
+  return (unsigned long)(ST77xxHost::nanos() / 1000ULL);
+}
+
+void delay(unsigned long ms) { ST77xxHost::advance(ms * 1000000ULL); }
+
+void delayMicroseconds(unsigned int us) {
+  ST77xxHost::advance(us * 1000ULL);
+}
+
+void yield(void) { ST77xxHost::advance(1000); }
+
+// Only emulator TE pins generate edges; see ST77xxHost::attachTearing()
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+  std::lock_guard<std::recursive_mutex> g(interruptLock);
+  Interrupt &irq = interruptTable[interruptNum];
+  if (!irq.isr && userFunc)
+    interruptCount++;
+  irq.isr = userFunc;
+  irq.mode = mode;
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  std::lock_guard<std::recursive_mutex> g(interruptLock);
+  Interrupt &irq = interruptTable[interruptNum];
+  if (irq.isr)
+    interruptCount--;
+  irq.isr = NULL;
+}
+
+void interrupts(void) {}
+
+void noInterrupts(void) {}
+
+// SPI *********************************************************************
+
+SPIClass SPI;
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  _settings = settings;
+  _inTransaction = true;
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  uint8_t miso = 0;
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    if (devices[i].emu->selected())
+      miso |= devices[i].emu->transfer(data);
+  }
+  // Eight clocks at the transaction's SCK rate
+  ST77xxHost::advance(8000000000ULL / (_settings.clock ? _settings.clock : 1));
+  return miso;
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+  uint16_t hi = transfer(data >> 8);
+  return (hi << 8) | transfer(data & 0xFF);
+}
+
+void SPIClass::transfer(void *buf, size_t count) {
+  uint8_t *p = (uint8_t *)buf;
+  while (count--) {
+    *p = transfer(*p);
+    p++;
+  }
+}
+
+// Print / Stream / Serial *************************************************
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--)
+    n += write(*buffer++);
+  return n;
+}
+
+size_t Print::write(const char *str) {
+  return str ? write((const uint8_t *)str, strlen(str)) : 0;
+}
+
+size_t Print::print(const __FlashStringHelper *s) {
+  return write(reinterpret_cast<const char *>(s));
+}
+
+size_t Print::print(const String &s) { return write(s.c_str()); }
+
+size_t Print::print(const char s[]) { return write(s); }
+
+size_t Print::print(char c) { return write((uint8_t)c); }
+
+size_t Print::print(unsigned char n, int base) {
+  return printNumber(n, base);
+}
+
+size_t Print::print(int n, int base) { return print((long)n, base); }
+
+size_t Print::print(unsigned int n, int base) { return printNumber(n, base); }
+
+size_t Print::print(long n, int base) {
+  if ((base == DEC) && (n < 0))
+    return write((uint8_t)'-') + printNumber((unsigned long)-n, base);
+  return printNumber((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) { return printNumber(n, base); }
+
+size_t Print::print(double n, int digits) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+size_t Print::println(void) { return write("\r\n"); }
+
+size_t Print::printNumber(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *s = &buf[sizeof(buf) - 1];
+  *s = 0;
+  if (base < 2)
+    base = 10;
+  do {
+    unsigned long d = n % base;
+    n /= base;
+    *--s = (char)(d < 10 ? ('0' + d) : ('A' + d - 10));
+  } while (n);
+  return write(s);
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length) {
+  size_t n = 0;
+  while (n < length) {
+    int c = read();
+    if (c < 0)
+      break;
+    buffer[n++] = (uint8_t)c;
+  }
+  return n;
+}
+
+HostSerial Serial;
+
+size_t HostSerial::write(uint8_t c) {
+  if (c != '\r')
+    fputc(c, stdout);
+  return 1;
+}
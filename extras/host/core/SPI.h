@@ -0,0 +1,55 @@
+/*!
+ * @file SPI.h
+ *
+ * Host stand-in for the Arduino SPI library. Bytes are delivered to every
+ * attached emulator whose chip select is asserted, and each byte advances
+ * the virtual clock by its time on the wire at the transaction's clock rate.
+ */
+
+#ifndef _ST77XX_HOST_SPI_H_
+#define _ST77XX_HOST_SPI_H_
+
+#include "Arduino.h"
+
+#define SPI_HAS_TRANSACTION 1
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+/// Clock, bit order and mode of a transaction
+class SPISettings {
+public:
+  SPISettings() : clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+      : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock;   ///< SCK frequency in Hz
+  uint8_t bitOrder; ///< MSBFIRST or LSBFIRST
+  uint8_t dataMode; ///< SPI_MODE0..3
+};
+
+/// Hardware SPI peripheral
+class SPIClass {
+public:
+  void begin(void) {}
+  void end(void) {}
+  void beginTransaction(SPISettings settings);
+  void endTransaction(void) { _inTransaction = false; }
+  uint8_t transfer(uint8_t data);
+  uint16_t transfer16(uint16_t data);
+  void transfer(void *buf, size_t count);
+  void setBitOrder(uint8_t order) { _settings.bitOrder = order; }
+  void setDataMode(uint8_t mode) { _settings.dataMode = mode; }
+  void setClockDivider(uint8_t div) { _settings.clock = 16000000 / div; }
+  void usingInterrupt(int interruptNumber) { (void)interruptNumber; }
+  uint32_t clock(void) const { return _settings.clock; }
+
+private:
+  SPISettings _settings;
+  bool _inTransaction = false;
+};
+
+extern SPIClass SPI;
+
+#endif // _ST77XX_HOST_SPI_H_
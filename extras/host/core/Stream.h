@@ -0,0 +1,26 @@
+/*!
+ * @file Stream.h
+ *
+ * Host stand-in for the Arduino Stream class.
+ */
+
+#ifndef _ST77XX_HOST_STREAM_H_
+#define _ST77XX_HOST_STREAM_H_
+
+#include "Print.h"
+
+/// Readable byte source, as implemented by Serial, SD File, etc.
+class Stream : public Print {
+public:
+  virtual int available(void) = 0;
+  virtual int read(void) = 0;
+  virtual int peek(void) = 0;
+
+  virtual size_t readBytes(uint8_t *buffer, size_t length);
+  size_t readBytes(char *buffer, size_t length) {
+    return readBytes((uint8_t *)buffer, length);
+  }
+  void setTimeout(unsigned long timeout) { (void)timeout; }
+};
+
+#endif // _ST77XX_HOST_STREAM_H_
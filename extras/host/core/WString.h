@@ -0,0 +1,28 @@
+/*!
+ * @file WString.h
+ *
+ * Host stand-in for the Arduino String class; only what Adafruit_GFX uses.
+ */
+
+#ifndef _ST77XX_HOST_WSTRING_H_
+#define _ST77XX_HOST_WSTRING_H_
+
+#include <string>
+
+/// Thin wrapper over std::string with the Arduino String spelling
+class String {
+public:
+  String(const char *s = "") : _s(s ? s : "") {}
+  unsigned int length(void) const { return (unsigned int)_s.length(); }
+  const char *c_str(void) const { return _s.c_str(); }
+  char operator[](unsigned int i) const { return _s[i]; }
+  String &operator+=(const String &rhs) {
+    _s += rhs._s;
+    return *this;
+  }
+
+private:
+  std::string _s;
+};
+
+#endif // _ST77XX_HOST_WSTRING_H_
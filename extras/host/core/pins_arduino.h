@@ -0,0 +1 @@
+// Stand-in for the board variant header on host builds; nothing to define.
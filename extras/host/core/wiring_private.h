@@ -0,0 +1 @@
+// Stand-in for the core's private wiring header on host builds.
@@ -0,0 +1,327 @@
+// Load BMP files from disk with Adafruit_ST77xxImageLoader and check them
+// against the same pixels drawn with drawRGBBitmap(): 24 and 32-bit, 16-bit
+// 5-6-5 and 5-5-5, bottom-up and top-down, with row padding and clipped at
+// the screen edges. Then load with the file on an SD card modelled on the
+// display's SPI bus, and check that no read happens while the display is
+// selected. Then time a full-screen load with reads and transfers
+// serialized and overlapped.
+//
+//   st77xx_bmp [storage KB/s]
+//
+// Storage reads cost virtual time at the given rate (default 4000 KB/s).
+// The pipeline's DMA engine is modelled: a transfer's bus time is credit
+// that reads use up before the clock moves on, so overlapped work costs
+// the longer of the two, as it would on a board with DMA.
+
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxImageLoader.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Adafruit_ST77xxAsync with a modelled DMA engine. The transfer is sent at
+// once; with overlap, the bus time it took is credit for CPU work.
+class ModelAsync : public Adafruit_ST77xxAsync {
+public:
+  ModelAsync(Adafruit_ST77xx &tft, uint32_t pixels, bool overlap)
+      : Adafruit_ST77xxAsync(tft, pixels), overlap(overlap) {}
+  // Spend CPU time, overlapping the transfer in flight
+  void cpu(uint64_t ns) {
+    uint64_t c = (ns < credit) ? ns : credit;
+    credit -= c;
+    ST77xxHost::advance(ns - c);
+  }
+
+protected:
+  void startTransfer(uint16_t *pixels, uint32_t len) {
+    uint64_t t0 = ST77xxHost::nanos();
+    display.writePixels(pixels, len);
+    if (overlap)
+      credit = ST77xxHost::nanos() - t0;
+  }
+  bool transferBusy(void) { return credit > 0; }
+  void waitTransfer(void) { credit = 0; }
+
+private:
+  bool overlap;
+  uint64_t credit = 0;
+};
+
+// File read through Stream, as from an SD card, at a given byte rate
+class FileStream : public Stream {
+public:
+  FileStream(const char *path, ModelAsync *m, uint64_t ns)
+      : f(fopen(path, "rb")), model(m), nsPerByte(ns) {}
+  ~FileStream(void) {
+    if (f)
+      fclose(f);
+  }
+  int available(void) { return f && !feof(f); }
+  int read(void) {
+    uint8_t c;
+    return (readBytes(&c, 1) == 1) ? c : -1;
+  }
+  int peek(void) { return -1; }
+  size_t write(uint8_t) { return 0; }
+  size_t readBytes(uint8_t *buf, size_t n) {
+    size_t got = f ? fread(buf, 1, n, f) : 0;
+    model->cpu(got * nsPerByte);
+    bytes += got;
+    return got;
+  }
+  uint64_t bytes = 0;
+
+private:
+  FILE *f;
+  ModelAsync *model;
+  uint64_t nsPerByte;
+};
+
+// File on an SD card sharing the display's SPI bus. Each read selects the
+// card and clocks its bytes over SPI, as a card would: if the display is
+// still selected it takes them in too.
+class SharedBusStream : public FileStream {
+public:
+  SharedBusStream(const char *path, ModelAsync *m, ST77xxEmulator *display)
+      : FileStream(path, m, 0), display(display) {}
+  size_t readBytes(uint8_t *buf, size_t n) {
+    if (display->selected())
+      collisions++;
+    SPI.beginTransaction(SPISettings(25000000, MSBFIRST, SPI_MODE0));
+    digitalWrite(SD_CS, LOW);
+    for (size_t i = 0; i < n; i++)
+      SPI.transfer(0xFF);
+    digitalWrite(SD_CS, HIGH);
+    SPI.endTransaction();
+    return FileStream::readBytes(buf, n);
+  }
+  uint32_t collisions = 0; // Reads with the display selected
+
+private:
+  static const uint8_t SD_CS = 4;
+  ST77xxEmulator *display;
+};
+
+static void put16(std::vector<uint8_t> &v, uint16_t x) {
+  v.push_back(x);
+  v.push_back(x >> 8);
+}
+
+static void put32(std::vector<uint8_t> &v, uint32_t x) {
+  put16(v, x);
+  put16(v, x >> 16);
+}
+
+// Write an image as BMP; expected receives what the display should show
+static bool writeBMP(const char *path, const std::vector<uint8_t> &rgb,
+                     int32_t w, int32_t h, uint16_t bits, bool bitfields,
+                     bool topDown, std::vector<uint16_t> &expected) {
+  uint32_t row = ((uint32_t)w * bits / 8 + 3) & ~3u,
+           offset = 54 + (bitfields ? 12 : 0) + 6; // Gap before the pixels
+  std::vector<uint8_t> v = {'B', 'M'};
+  put32(v, offset + row * h);
+  put32(v, 0);
+  put32(v, offset);
+  put32(v, 40);
+  put32(v, w);
+  put32(v, topDown ? -h : h);
+  put16(v, 1);
+  put16(v, bits);
+  put32(v, bitfields ? 3 : 0);
+  put32(v, row * h);
+  put32(v, 2835);
+  put32(v, 2835);
+  put32(v, 0);
+  put32(v, 0);
+  if (bitfields) {
+    bool is565 = (bits == 16);
+    put32(v, is565 ? 0xF800 : 0xFF0000);
+    put32(v, is565 ? 0x07E0 : 0xFF00);
+    put32(v, is565 ? 0x001F : 0xFF);
+  }
+  v.resize(offset, 0xEE);
+  expected.resize((size_t)w * h);
+  for (int32_t r = 0; r < h; r++) {
+    int32_t y = topDown ? r : h - 1 - r;
+    for (int32_t x = 0; x < w; x++) {
+      const uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+      uint16_t &e = expected[(size_t)y * w + x];
+      if (bits == 16 && bitfields) {
+        e = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+        put16(v, e);
+      } else if (bits == 16) { // 5-5-5; green's low bit copies its top bit
+        uint16_t g = p[1] >> 3;
+        e = ((p[0] & 0xF8) << 8) | (((g << 1) | (g >> 4)) << 5) | (p[2] >> 3);
+        put16(v, ((p[0] >> 3) << 10) | (g << 5) | (p[2] >> 3));
+      } else {
+        e = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+        v.push_back(p[2]);
+        v.push_back(p[1]);
+        v.push_back(p[0]);
+        if (bits == 32)
+          v.push_back(0xFF);
+      }
+    }
+    v.resize(v.size() + row - (uint32_t)w * bits / 8, 0xAA); // Padding
+  }
+  FILE *f = fopen(path, "wb");
+  bool ok = f && (fwrite(v.data(), 1, v.size(), f) == v.size());
+  if (f)
+    fclose(f);
+  return ok;
+}
+
+static void makeImage(std::vector<uint8_t> &rgb, int32_t w, int32_t h) {
+  rgb.resize((size_t)w * h * 3);
+  for (int32_t y = 0; y < h; y++)
+    for (int32_t x = 0; x < w; x++) {
+      uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+      p[0] = x * 255 / w;
+      p[1] = y * 255 / h;
+      p[2] = ((x / 8 + y / 8) & 1) ? 200 : (x ^ y);
+    }
+}
+
+int main(int argc, char **argv) {
+  uint32_t kbps = (argc > 1) ? atoi(argv[1]) : 4000;
+  uint64_t nsPerByte = 1000000000ULL / ((uint64_t)kbps * 1024);
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/st77xx_bmp_%d.bmp", (int)getpid());
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  uint32_t failures = 0;
+  {
+    ModelAsync async(tft, 240 * 16, true);
+    Adafruit_ST77xxImageLoader loader(async, 512, false);
+    if (!async.begin() || !loader.begin())
+      return 2;
+
+    const int32_t w = 201, h = 150;
+    std::vector<uint8_t> rgb, want, got;
+    std::vector<uint16_t> expected;
+    makeImage(rgb, w, h);
+    static const struct {
+      uint16_t bits;
+      bool bitfields, topDown;
+      const char *name;
+    } formats[] = {{24, false, false, "24-bit"},
+                   {24, false, true, "24-bit top-down"},
+                   {32, false, false, "32-bit"},
+                   {32, true, true, "32-bit bitfields top-down"},
+                   {16, true, false, "16-bit 5-6-5"},
+                   {16, false, false, "16-bit 5-5-5"}};
+    static const int16_t places[][2] = {{0, 0},   {20, 100},  {-50, 30},
+                                        {100, -40}, {60, 250}, {-300, 0}};
+    for (auto &fmt : formats) {
+      if (!writeBMP(path, rgb, w, h, fmt.bits, fmt.bitfields, fmt.topDown,
+                    expected))
+        return 2;
+      for (auto &p : places) {
+        tft.fillScreen(ST77XX_BLACK);
+        tft.drawRGBBitmap(p[0], p[1], expected.data(), w, h);
+        emu.render(want);
+        tft.fillScreen(ST77XX_BLACK);
+        FileStream file(path, &async, 0);
+        bool ok = loader.drawBMP(file, p[0], p[1]);
+        async.wait();
+        emu.render(got);
+        uint32_t diff = ST77xxEmulator::diffImages(want, got);
+        if (diff || !ok || (loader.getWidth() != w) ||
+            (loader.getHeight() != h)) {
+          printf("  %s at (%d, %d): %u pixels differ%s\n", fmt.name, p[0],
+                 p[1], diff, ok ? "" : ", drawBMP() failed");
+          failures++;
+        }
+      }
+    }
+
+    // Not a BMP, and a truncated one
+    FILE *f = fopen(path, "r+b");
+    fputc('X', f);
+    fclose(f);
+    FileStream bad(path, &async, 0);
+    if (loader.drawBMP(bad, 0, 0)) {
+      printf("  a file without the BM signature was accepted\n");
+      failures++;
+    }
+    writeBMP(path, rgb, w, h, 24, false, false, expected);
+    FileStream cut(path, &async, 0);
+    if (truncate(path, 5000) || loader.drawBMP(cut, 0, 0)) {
+      printf("  a truncated file was accepted\n");
+      failures++;
+    }
+    async.wait();
+  }
+
+  // An SD card on the display's bus: declared shared, the loader finishes
+  // each band before reading; not declared, the model must catch it
+  {
+    std::vector<uint8_t> rgb, want, got;
+    std::vector<uint16_t> expected;
+    makeImage(rgb, 240, 200);
+    writeBMP(path, rgb, 240, 200, 24, false, false, expected);
+    tft.fillScreen(ST77XX_BLACK);
+    tft.drawRGBBitmap(0, 60, expected.data(), 240, 200);
+    emu.render(want);
+    for (int shared = 1; shared >= 0; shared--) {
+      ModelAsync async(tft, 240 * 16, true);
+      Adafruit_ST77xxImageLoader loader(async, 512, shared);
+      if (!async.begin() || !loader.begin())
+        return 2;
+      tft.fillScreen(ST77XX_BLACK);
+      SharedBusStream file(path, &async, &emu);
+      bool ok = loader.drawBMP(file, 0, 60);
+      async.wait();
+      emu.render(got);
+      uint32_t diff = ST77xxEmulator::diffImages(want, got);
+      printf("SD card on the display's bus, %s: %u reads with the display "
+             "selected, %u pixels differ\n",
+             shared ? "declared shared" : "not declared", file.collisions,
+             diff);
+      if (shared ? (diff || !ok || file.collisions) : !file.collisions) {
+        printf("  %s\n", shared ? "MISMATCH" : "the model missed the clash");
+        failures++;
+      }
+    }
+  }
+
+  // Full-screen 24-bit image: reads and transfers in turn, then overlapped
+  std::vector<uint8_t> rgb;
+  std::vector<uint16_t> expected;
+  makeImage(rgb, 240, 320);
+  writeBMP(path, rgb, 240, 320, 24, false, false, expected);
+  tft.startWrite();
+  uint64_t t0 = ST77xxHost::nanos();
+  tft.setAddrWindow(0, 0, 240, 320);
+  tft.writePixels(expected.data(), 240 * 320);
+  uint64_t writeNs = ST77xxHost::nanos() - t0;
+  tft.endWrite();
+  printf("240x320 24-bit BMP, storage at %u KB/s, 16-row bands:\n", kbps);
+  uint64_t readNs = 0, ns[2];
+  for (int overlap = 0; overlap < 2; overlap++) {
+    ModelAsync async(tft, 240 * 16, overlap);
+    Adafruit_ST77xxImageLoader loader(async, 512, false);
+    if (!async.begin() || !loader.begin())
+      return 2;
+    FileStream file(path, &async, nsPerByte);
+    t0 = ST77xxHost::nanos();
+    loader.drawBMP(file, 0, 0);
+    async.wait();
+    ns[overlap] = ST77xxHost::nanos() - t0;
+    readNs = file.bytes * nsPerByte;
+  }
+  printf("  reading alone %7.1f ms, writing alone %7.1f ms\n", readNs / 1e6,
+         writeNs / 1e6);
+  printf("  serialized    %7.1f ms, overlapped    %7.1f ms (%.2fx)\n",
+         ns[0] / 1e6, ns[1] / 1e6, (double)ns[0] / ns[1]);
+  unlink(path);
+
+  printf("%s\n", failures ? "MISMATCH" : "All formats and placements match");
+  return failures ? 1 : 0;
+}
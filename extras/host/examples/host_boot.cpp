@@ -0,0 +1,124 @@
+// Print where init time goes, per command, for the stock init and for the
+// fast boot path, blocking and non-blocking (poll()), and check each against
+// the datasheet minimums the emulator enforces (reset recovery, SLPOUT/SLPIN
+// spacing). The non-blocking passes also report how much of the init was
+// left free for other work, and run a sleep/wake cycle the same way.
+//
+//   st77xx_boot [st7735|st7789|st7796s] [--no-miso]
+//
+// With --no-miso the display is driven over software SPI with nothing to
+// read status from, so the fast path falls back to fixed minimum timings.
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST7796S.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t totalSendUs, totalWaitUs;
+
+static void printStep(uint8_t cmd, uint32_t sendUs, uint32_t waitUs) {
+  printf("  %-8s 0x%02X  send %6u us  wait %7u us\n",
+         (cmd == ST77XX_NOP) ? "reset" : ST77xxEmulator::commandName(cmd), cmd,
+         sendUs, waitUs);
+  totalSendUs += sendUs;
+  totalWaitUs += waitUs;
+}
+
+int main(int argc, char **argv) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  bool miso = true;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "st7735"))
+      c = ST77xxEmulator::ST7735;
+    else if (!strcmp(argv[i], "st7796s"))
+      c = ST77xxEmulator::ST7796S;
+    else if (!strcmp(argv[i], "--no-miso"))
+      miso = false;
+  }
+
+  static const char *const names[] = {"Stock", "Fast", "Non-blocking",
+                                      "Non-blocking fast"};
+  int failures = 0;
+  uint8_t madctl = 0, colmod = 0;
+  for (int pass = 0; pass < 4; pass++) {
+    bool fast = pass & 1, async = pass & 2;
+    ST77xxHost::reset();
+    ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+    // Hardware SPI reads back; software SPI is wired without MISO
+    if (miso)
+      ST77xxHost::attach(&emu, 10, 8, 9);
+    else
+      ST77xxHost::attach(&emu, 10, 8, 9, 11, 13);
+    Adafruit_ST7735 *st7735 = NULL;
+    Adafruit_ST7789 *st7789 = NULL;
+    Adafruit_ST7796S *st7796s = NULL;
+    Adafruit_ST77xx *tft;
+    if (c == ST77xxEmulator::ST7735)
+      tft = st7735 = miso ? new Adafruit_ST7735(10, 8, 9)
+                          : new Adafruit_ST7735(10, 8, 11, 13, 9);
+    else if (c == ST77xxEmulator::ST7789)
+      tft = st7789 = miso ? new Adafruit_ST7789(10, 8, 9)
+                          : new Adafruit_ST7789(10, 8, 11, 13, 9);
+    else
+      tft = st7796s = miso ? new Adafruit_ST7796S(10, 8, 9)
+                           : new Adafruit_ST7796S(10, 8, 11, 13, 9);
+
+    printf("%s init:\n", names[pass]);
+    totalSendUs = totalWaitUs = 0;
+    tft->setFastBoot(fast);
+    tft->setInitTrace(printStep);
+    uint32_t t0 = micros(), spareMs = 0;
+    if (st7735)
+      async ? st7735->initRAsync(INITR_GREENTAB)
+            : st7735->initR(INITR_GREENTAB);
+    else if (st7789)
+      async ? st7789->initAsync(240, 320) : st7789->init(240, 320);
+    else
+      async ? st7796s->initAsync() : st7796s->init();
+    while (!tft->poll()) {
+      delay(1); // Stands in for the rest of setup()
+      spareMs++;
+    }
+    uint32_t us = micros() - t0;
+    bool on = emu.displayOn();
+    if (!pass) {
+      madctl = emu.madctl();
+      colmod = emu.colmod();
+    }
+    bool same = (emu.madctl() == madctl) && (emu.colmod() == colmod);
+
+    // Going straight back to sleep exercises the deferred SLPOUT->SLPIN
+    // wait, then waking again the settle time after SLPOUT
+    t0 = micros();
+    uint32_t sleepSpareMs = 0;
+    if (async) {
+      tft->enableSleepAsync(true);
+      while (!tft->poll()) {
+        delay(1);
+        sleepSpareMs++;
+      }
+    } else {
+      tft->enableSleep(true);
+    }
+    uint32_t sleepUs = micros() - t0;
+    bool slept = emu.sleeping();
+    async ? (void)tft->enableSleepAsync(false) : tft->enableSleep(false);
+    while (!tft->poll())
+      delay(1);
+    bool woke = !emu.sleeping();
+
+    uint32_t violations = emu.stats().violations;
+    printf("  total %u ms: %u us sending, %u ms waiting, %u ms free for "
+           "other work; display %s%s\n",
+           us / 1000, totalSendUs, totalWaitUs / 1000, spareMs,
+           on ? "on" : "off", same ? "" : "; MADCTL/COLMOD differ");
+    printf("  sleep took %u ms (%u ms free), %s; %u timing violations\n\n",
+           sleepUs / 1000, sleepSpareMs,
+           (slept && woke) ? "woke again" : "sleep/wake failed", violations);
+    failures += violations + !on + !same + !slept + !woke;
+    delete tft;
+  }
+  return failures ? 1 : 0;
+}
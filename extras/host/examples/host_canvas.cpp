@@ -0,0 +1,150 @@
+// Damage tracking in Adafruit_ST77xxCanvas on a 320x480 ST7796S: the merge
+// rule (one window when it costs no more than two), folding the cheapest
+// pair once 8 rectangles are held, and a clock redrawn once a second in
+// each rotation. Every flush is checked against a second display that gets
+// the whole canvas pushed, and its bus bytes against what the damage should
+// cost.
+//
+//   st77xx_canvas
+
+#include <Adafruit_ST7796S.h>
+#include <Adafruit_ST77xxCanvas.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint32_t failures = 0;
+
+struct Area {
+  int16_t x, y, w, h;
+};
+
+// Bus bytes for one window, as the canvas weighs them at 16 bits
+static uint32_t cost(const Area &a) {
+  return ST77XX_WINDOW_COST + 2UL * a.w * a.h;
+}
+
+static Area bounds(const Area &a, const Area &b) {
+  int16_t x0 = (a.x < b.x) ? a.x : b.x, y0 = (a.y < b.y) ? a.y : b.y;
+  int16_t x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+  int16_t y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+  Area r = {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+  return r;
+}
+
+// Flush, then check the glass against a full push and the bus against the
+// windows and pixels expected
+static void flush(const char *what, Adafruit_ST77xxCanvas &canvas,
+                  Adafruit_ST7796S &tft, ST77xxEmulator &emu,
+                  Adafruit_ST7796S &ref, ST77xxEmulator &refEmu,
+                  uint32_t windows, uint32_t pixels) {
+  ST77xxEmulator::Stats e0 = emu.stats();
+  uint32_t sent = canvas.flush(tft);
+  ST77xxEmulator::Stats e = emu.stats().since(e0);
+  ref.drawRGBBitmap(0, 0, canvas.getBuffer(), ref.width(), ref.height());
+
+  std::vector<uint8_t> want, got;
+  refEmu.render(want);
+  emu.render(got);
+  uint32_t diff = ST77xxEmulator::diffImages(want, got);
+  // CASET and RASET the controller already has are skipped, so the bus can
+  // come in under the canvas' count, never over
+  bool ok = !diff && (e.opcodes[ST77XX_RAMWR] == windows) &&
+            (e.pixelBytes == pixels * 2) && (e.busBytes() <= sent) &&
+            (sent == canvas.getFlushBytes());
+  printf("  %-26s %u window%s %6u pixel bytes, %6u bus bytes (%u "
+         "counted), %u saved%s\n",
+         what, e.opcodes[ST77XX_RAMWR],
+         (e.opcodes[ST77XX_RAMWR] == 1) ? ", " : "s,", e.pixelBytes,
+         e.busBytes(), sent, canvas.getFlushSavedBytes(),
+         ok ? "" : "  MISMATCH");
+  if (diff)
+    printf("    %u pixels differ from a full redraw\n", diff);
+  failures += !ok;
+}
+
+int main(void) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7796S;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c)),
+      refEmu(c, ST77xxEmulator::defaultPanel(c));
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  ST77xxHost::attach(&refEmu, 11, 7, 6);
+  Adafruit_ST7796S tft(10, 8, 9), ref(11, 7, 6);
+  tft.init();
+  ref.init();
+  static Adafruit_ST77xxCanvas canvas(tft.width(), tft.height());
+  canvas.fillScreen(ST77XX_BLACK);
+  printf("Full canvas:\n");
+  flush("fillScreen()", canvas, tft, emu, ref, refEmu, 1,
+        (uint32_t)tft.width() * tft.height());
+
+  // Two areas become one window exactly when that costs no more bytes. Two
+  // pixels on a row merge up to 6 pixels apart (11 + 2 * 7 <= 2 * 13)
+  printf("Merge rule:\n");
+  static const struct {
+    const char *what;
+    Area a, b;
+  } pairs[] = {
+      {"pixels 6 apart", {10, 10, 1, 1}, {16, 10, 1, 1}},
+      {"pixels 7 apart", {10, 10, 1, 1}, {17, 10, 1, 1}},
+      {"side by side", {40, 40, 20, 10}, {60, 40, 20, 10}},
+      {"overlapping", {40, 40, 20, 20}, {50, 50, 20, 20}},
+      {"one inside the other", {40, 40, 50, 50}, {60, 60, 10, 10}},
+      {"diagonal, far apart", {0, 0, 30, 30}, {200, 300, 30, 30}},
+      {"thin and offset", {20, 100, 100, 2}, {130, 140, 100, 2}},
+  };
+  char what[64];
+  uint16_t color = 0x1234;
+  for (auto &p : pairs) {
+    Area m = bounds(p.a, p.b);
+    bool one = cost(m) <= cost(p.a) + cost(p.b);
+    canvas.fillRect(p.a.x, p.a.y, p.a.w, p.a.h, color += 0x0821);
+    canvas.fillRect(p.b.x, p.b.y, p.b.w, p.b.h, color += 0x0821);
+    if (canvas.getDirtyCount() != (one ? 1 : 2)) {
+      printf("  %s: %u rectangles, not %u\n", p.what,
+             canvas.getDirtyCount(), one ? 1 : 2);
+      failures++;
+    }
+    uint32_t pixels = one ? (uint32_t)m.w * m.h
+                          : (uint32_t)p.a.w * p.a.h + (uint32_t)p.b.w * p.b.h;
+    flush(p.what, canvas, tft, emu, ref, refEmu, one ? 1 : 2, pixels);
+  }
+
+  // A third area between two held ones merges them all
+  canvas.fillRect(100, 200, 4, 4, ST77XX_RED);
+  canvas.fillRect(112, 200, 4, 4, ST77XX_GREEN);
+  canvas.fillRect(104, 200, 8, 4, ST77XX_BLUE);
+  snprintf(what, sizeof(what), "bridging (%u held)", canvas.getDirtyCount());
+  flush(what, canvas, tft, emu, ref, refEmu, 1, 16 * 4);
+
+  // Eight pixels too far apart to merge fill the list; a ninth, 10 pixels
+  // from one of them, has the two fold into one 11-pixel window
+  printf("At the %u rectangle limit:\n", ST77XX_MAX_DIRTY);
+  for (int16_t i = 0; i < ST77XX_MAX_DIRTY; i++)
+    canvas.drawPixel(20 + i * 35, 20 + i * 50, ST77XX_WHITE);
+  canvas.drawPixel(20 + 3 * 35 + 10, 20 + 3 * 50, ST77XX_YELLOW);
+  snprintf(what, sizeof(what), "9 pixels (%u held)", canvas.getDirtyCount());
+  failures += canvas.getDirtyCount() != ST77XX_MAX_DIRTY;
+  flush(what, canvas, tft, emu, ref, refEmu, ST77XX_MAX_DIRTY,
+        ST77XX_MAX_DIRTY - 1 + 11);
+
+  // A clock ticking in each rotation: only its 8 character cells go out
+  printf("Clock, 8 characters at size 2:\n");
+  for (uint8_t rot = 0; rot < 4; rot++) {
+    canvas.setRotation(rot);
+    canvas.setTextSize(2);
+    canvas.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+    for (int s = 56; s < 58; s++) {
+      char clock[9];
+      snprintf(clock, sizeof(clock), "12:34:%02d", s);
+      canvas.setCursor(30, 40);
+      canvas.print(clock);
+      snprintf(what, sizeof(what), "rotation %u, \"%s\"", rot, clock);
+      flush(what, canvas, tft, emu, ref, refEmu, 1, 8 * 12 * 16);
+    }
+  }
+  canvas.setRotation(0);
+
+  printf("%s\n", failures ? "MISMATCH" : "All flushes match a full redraw");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+// Run a handful of typical draw calls against an emulated controller,
+// print the bus traffic each one generates and save the resulting frames.
+//
+//   st77xx_capture [st7735|st7789|st7796s] [output-prefix] [--trace]
+//
+// Frames are written as <prefix>-NN-<call>.ppm; compare runs with
+// st77xx_framediff. With --trace the full byte/DC/CS capture of the last
+// call is dumped to <prefix>.trace.
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST7796S.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TFT_CS 10
+#define TFT_DC 8
+#define TFT_RST 9
+
+static ST77xxEmulator *emu;
+static Adafruit_ST77xx *tft;
+static const char *prefix = "frame";
+static int frameNumber = 0;
+
+static void report(const char *name, void (*draw)(void)) {
+  ST77xxEmulator::Stats before = emu->stats();
+  uint64_t t0 = ST77xxHost::nanos();
+  draw();
+  uint64_t t1 = ST77xxHost::nanos();
+  ST77xxEmulator::Stats d = emu->stats().since(before);
+
+  printf("%-14s %7u %6u %6u %6u %9u %9u %6u %9.1f\n", name, d.commands,
+         d.opcodes[ST77XX_CASET], d.opcodes[ST77XX_RASET],
+         d.opcodes[ST77XX_RAMWR], d.dataBytes, d.pixelBytes, d.csAssertions,
+         (t1 - t0) / 1000.0);
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s-%02d-%s.ppm", prefix, frameNumber++, name);
+  emu->writePPM(path);
+}
+
+static void drawFill(void) { tft->fillScreen(ST77XX_BLACK); }
+
+static void drawText(void) {
+  tft->setCursor(0, 0);
+  tft->setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+  tft->setTextSize(2);
+  tft->print("Hello, host!");
+}
+
+static void drawLines(void) {
+  for (int16_t x = 0; x < tft->width(); x += 8)
+    tft->drawLine(0, 0, x, tft->height() - 1, ST77XX_YELLOW);
+}
+
+static void drawRects(void) {
+  for (int16_t i = 0; i < 8; i++)
+    tft->fillRect(10 + i * 12, 60 + i * 10, 40, 30, 0x1111 * (i + 1));
+}
+
+static void drawCircles(void) {
+  tft->fillCircle(tft->width() / 2, tft->height() / 2, 40, ST77XX_RED);
+  tft->drawCircle(tft->width() / 2, tft->height() / 2, 50, ST77XX_GREEN);
+}
+
+static void drawPixels(void) {
+  for (int16_t y = 0; y < 32; y++)
+    tft->drawPixel(tft->width() - 10, 100 + y, ST77XX_CYAN);
+}
+
+int main(int argc, char **argv) {
+  const char *chip = (argc > 1) ? argv[1] : "st7789";
+  if (argc > 2)
+    prefix = argv[2];
+  bool trace = (argc > 3) && !strcmp(argv[3], "--trace");
+
+  Adafruit_ST7735 st7735(TFT_CS, TFT_DC, TFT_RST);
+  Adafruit_ST7789 st7789(TFT_CS, TFT_DC, TFT_RST);
+  Adafruit_ST7796S st7796s(TFT_CS, TFT_DC, TFT_RST);
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  if (!strcmp(chip, "st7735"))
+    c = ST77xxEmulator::ST7735;
+  else if (!strcmp(chip, "st7796s"))
+    c = ST77xxEmulator::ST7796S;
+
+  ST77xxEmulator model(c, ST77xxEmulator::defaultPanel(c));
+  emu = &model;
+  ST77xxHost::attach(emu, TFT_CS, TFT_DC, TFT_RST);
+
+  uint64_t t0 = ST77xxHost::nanos();
+  if (c == ST77xxEmulator::ST7735) {
+    st7735.initR(INITR_GREENTAB);
+    tft = &st7735;
+  } else if (c == ST77xxEmulator::ST7796S) {
+    st7796s.init();
+    tft = &st7796s;
+  } else {
+    st7789.init(240, 320);
+    tft = &st7789;
+  }
+  printf("init: %u commands, %.1f ms\n\n", emu->stats().commands,
+         (ST77xxHost::nanos() - t0) / 1e6);
+
+  printf("%-14s %7s %6s %6s %6s %9s %9s %6s %9s\n", "call", "cmds", "CASET",
+         "RASET", "RAMWR", "data", "pixel", "CS", "bus us");
+  report("fillScreen", drawFill);
+  report("text", drawText);
+  report("lines", drawLines);
+  report("fillRect", drawRects);
+  report("circles", drawCircles);
+  if (trace) {
+    emu->setCapture(true);
+    report("pixels", drawPixels);
+    char path[256];
+    snprintf(path, sizeof(path), "%s.trace", prefix);
+    FILE *f = fopen(path, "w");
+    if (f) {
+      emu->writeTrace(f);
+      fclose(f);
+    }
+  } else {
+    report("pixels", drawPixels);
+  }
+  return 0;
+}
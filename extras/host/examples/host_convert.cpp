@@ -0,0 +1,285 @@
+// Benchmark the Adafruit_ST77xxConvert kernels against plain per-pixel
+// loops, converting a frame a line at a time, and check that they agree
+// bit for bit on random input of every length and alignment. Then draw
+// RGB888 and YUV422 images with drawRGB888Bitmap()/drawYUV422Bitmap(),
+// clipped and at each color depth (12 bits also dithered), and compare
+// them with the same pixels converted by the reference loops and drawn
+// with drawRGBBitmap().
+//
+//   st77xx_convert [frames]
+//
+// Build with -DCMAKE_BUILD_TYPE=Release for meaningful timings, and with
+// -DST77XX_HOST_NATIVE=ON to let the compiler use SSSE3 and later.
+
+#include <Adafruit_ST77xxConvert.h>
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#define FRAME_W 320
+#define FRAME_H 240
+
+// Reference conversions, one pixel at a time
+
+static uint16_t refRGB(const uint8_t *p) {
+  return ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+}
+
+static uint8_t refClamp(int32_t v) {
+  v = (v + 32) >> 6;
+  return (v < 0) ? 0 : (v > 255) ? 255 : v;
+}
+
+// BT.601 studio range in 6-bit fixed point, as the library documents it
+static uint16_t refYUV(const uint8_t *pair, uint8_t second) {
+  int32_t c = 74 * (pair[second ? 2 : 0] - 16), d = pair[1] - 128,
+          e = pair[3] - 128;
+  uint8_t r = refClamp(c + 102 * e), g = refClamp(c - 25 * d - 52 * e),
+          b = refClamp(c + 129 * d);
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static const uint8_t bayer[16] = {0, 8,  2, 10, 12, 4,  14, 6,
+                                  3, 11, 1, 9,  15, 7, 13, 5};
+
+static uint16_t refDither(const uint8_t *p, int16_t x, int16_t y) {
+  int t = bayer[((y & 3) << 2) | (x & 3)] * 16 + 8;
+  return (((p[0] * 31 + t) >> 8) << 11) | (((p[1] * 63 + t) >> 8) << 5) |
+         ((p[2] * 31 + t) >> 8);
+}
+
+static uint16_t swapped(uint16_t c) { return (c >> 8) | (c << 8); }
+
+// Kept out of line so each stage is timed as a library call would be, and
+// not vectorized by GCC, so they stand for the per-pixel path
+#if defined(__GNUC__) && !defined(__clang__)
+#define SCALAR __attribute__((noinline, optimize("no-tree-vectorize")))
+#else
+#define SCALAR __attribute__((noinline))
+#endif
+
+SCALAR static void scalarRGB(uint16_t *dst, const uint8_t *src, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = refRGB(src + 3 * i);
+}
+
+SCALAR static void scalarDither(uint16_t *dst, const uint8_t *src, uint32_t n,
+                                int16_t y) {
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = refDither(src + 3 * i, i, y);
+}
+
+SCALAR static void scalarYUV(uint16_t *dst, const uint8_t *src, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = refYUV(src + 2 * (i & ~1u), i & 1);
+}
+
+SCALAR static void scalarSwap(uint16_t *dst, const uint16_t *src, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = swapped(src[i]);
+}
+
+static double seconds(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static volatile uint32_t sink; // Keeps the timed loops from being dropped
+
+// Run one line stage over every row of frames frames, best of three
+// after a warm-up frame; returns Mpixel/s
+template <typename F> static double bench(int frames, F stage) {
+  uint16_t line[FRAME_W];
+  double best = 0;
+  for (int pass = 0; pass < 4; pass++) {
+    int n = pass ? frames : 1;
+    double t0 = seconds();
+    for (int f = 0; f < n; f++)
+      for (int16_t y = 0; y < FRAME_H; y++) {
+        stage(line, y);
+        sink += line[y];
+      }
+    double rate = (double)n * FRAME_W * FRAME_H / (seconds() - t0) / 1e6;
+    if (pass && (rate > best))
+      best = rate;
+  }
+  return best;
+}
+
+int main(int argc, char **argv) {
+  int frames = (argc > 1) ? atoi(argv[1]) : 200;
+  uint32_t failures = 0;
+
+  srand(7);
+  std::vector<uint8_t> rgb(FRAME_W * FRAME_H * 3 + 16),
+      yuv(FRAME_W * FRAME_H * 2 + 16);
+  std::vector<uint16_t> px(FRAME_W * FRAME_H + 16);
+  for (size_t i = 0; i < rgb.size(); i++)
+    rgb[i] = rand();
+  for (size_t i = 0; i < yuv.size(); i++)
+    yuv[i] = rand();
+  for (size_t i = 0; i < px.size(); i++)
+    px[i] = rand();
+
+  // Every length up to a few SIMD blocks, at every source alignment
+  printf("kernels: %s\n", Adafruit_ST77xxConvert::path());
+  uint16_t got[80], want[80];
+  for (uint8_t be = 0; be < 2; be++)
+    for (uint32_t off = 0; off < 8; off++)
+      for (uint32_t n = 0; n <= 70; n++) {
+        const uint8_t *s3 = &rgb[off], *s2 = &yuv[4 * off];
+        uint32_t bad = 0;
+        Adafruit_ST77xxConvert::rgb888(got, s3, n, be);
+        for (uint32_t i = 0; i < n; i++) {
+          uint16_t c = refRGB(s3 + 3 * i);
+          bad += got[i] != (be ? swapped(c) : c);
+        }
+        Adafruit_ST77xxConvert::rgb888Dither(got, s3, n, off, n, be);
+        for (uint32_t i = 0; i < n; i++) {
+          uint16_t c = refDither(s3 + 3 * i, off + i, n);
+          bad += got[i] != (be ? swapped(c) : c);
+        }
+        Adafruit_ST77xxConvert::yuv422(got, s2, n, be);
+        for (uint32_t i = 0; i < n; i++) {
+          uint16_t c = refYUV(s2 + 2 * (i & ~1u), i & 1);
+          bad += got[i] != (be ? swapped(c) : c);
+        }
+        if (!be) {
+          Adafruit_ST77xxConvert::swap16(got, &px[off], n);
+          for (uint32_t i = 0; i < n; i++)
+            bad += got[i] != swapped(px[off + i]);
+          memcpy(want, &px[off], n * 2); // In place
+          Adafruit_ST77xxConvert::swap16(want, want, n);
+          bad += memcmp(got, want, n * 2) != 0;
+        }
+        if (bad)
+          printf("  %u pixels, offset %u%s: %u mismatches\n", n, off,
+                 be ? ", big-endian" : "", bad);
+        failures += bad != 0;
+      }
+  // Every possible YUV value pair of a few lumas
+  for (int u = 0; u < 256; u++)
+    for (int v = 0; v < 256; v++) {
+      uint8_t p[8] = {0, (uint8_t)u, 16, (uint8_t)v,
+                      235, (uint8_t)u, 255, (uint8_t)v};
+      Adafruit_ST77xxConvert::yuv422(got, p, 4);
+      for (int i = 0; i < 4; i++)
+        failures += got[i] != refYUV(p + 4 * (i >> 1), i & 1);
+    }
+
+  printf("%dx%d frames, a line at a time, Mpixel/s:\n", FRAME_W, FRAME_H);
+  printf("  %-22s %9s %9s %7s\n", "", "scalar", "kernel", "speedup");
+  struct {
+    const char *name;
+    double scalar, kernel;
+  } rows[4];
+  rows[0].name = "RGB888 -> 565";
+  rows[0].scalar = bench(frames, [&](uint16_t *l, int16_t y) {
+    scalarRGB(l, &rgb[3 * y * FRAME_W], FRAME_W);
+  });
+  rows[0].kernel = bench(frames, [&](uint16_t *l, int16_t y) {
+    Adafruit_ST77xxConvert::rgb888(l, &rgb[3 * y * FRAME_W], FRAME_W);
+  });
+  rows[1].name = "RGB888 -> 565 dither";
+  rows[1].scalar = bench(frames, [&](uint16_t *l, int16_t y) {
+    scalarDither(l, &rgb[3 * y * FRAME_W], FRAME_W, y);
+  });
+  rows[1].kernel = bench(frames, [&](uint16_t *l, int16_t y) {
+    Adafruit_ST77xxConvert::rgb888Dither(l, &rgb[3 * y * FRAME_W], FRAME_W,
+                                         0, y);
+  });
+  rows[2].name = "YUV422 -> 565";
+  rows[2].scalar = bench(frames, [&](uint16_t *l, int16_t y) {
+    scalarYUV(l, &yuv[2 * y * FRAME_W], FRAME_W);
+  });
+  rows[2].kernel = bench(frames, [&](uint16_t *l, int16_t y) {
+    Adafruit_ST77xxConvert::yuv422(l, &yuv[2 * y * FRAME_W], FRAME_W);
+  });
+  rows[3].name = "byte swap";
+  rows[3].scalar = bench(frames, [&](uint16_t *l, int16_t y) {
+    scalarSwap(l, &px[y * FRAME_W], FRAME_W);
+  });
+  rows[3].kernel = bench(frames, [&](uint16_t *l, int16_t y) {
+    Adafruit_ST77xxConvert::swap16(l, &px[y * FRAME_W], FRAME_W);
+  });
+  for (int i = 0; i < 4; i++)
+    printf("  %-22s %9.1f %9.1f %6.2fx\n", rows[i].name, rows[i].scalar,
+           rows[i].kernel, rows[i].kernel / rows[i].scalar);
+
+  // Blits against the reference conversion drawn as 16-bit pixels
+  ST77xxEmulator::Controller ctl = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(ctl, ST77xxEmulator::defaultPanel(ctl));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+  tft.setRotation(1);
+
+  const int16_t iw = 200, ih = 120;
+  std::vector<uint16_t> ref(iw * ih);
+  std::vector<uint8_t> a, b;
+  const int16_t places[][2] = {{0, 0}, {60, 70}, {-37, 13}, {-38, -50},
+                               {201, 150}, {-1, 200}};
+  const struct {
+    uint8_t bits;
+    bool dither;
+  } depths[] = {{16, false}, {12, false}, {18, false}, {12, true}};
+  for (auto &depth : depths)
+    for (uint8_t kind = 0; kind < 3; kind++) {
+      // Dithered 565 is compared at 16 bits, and where 12-bit pixels are
+      // dithered, which must then be the only dither, as for truncated 565
+      bool once = (kind == 1) && depth.dither;
+      if ((kind == 1) && (depth.bits != 16) && !once)
+        continue;
+      tft.setColorDepth(depth.bits, depth.dither);
+      for (int16_t y = 0; y < ih; y++)
+        for (int16_t x = 0; x < iw; x++) {
+          uint32_t i = y * iw + x;
+          ref[i] = ((kind == 0) || once) ? refRGB(&rgb[3 * i])
+                   : (kind == 1)         ? 0
+                                         : refYUV(&yuv[2 * (i & ~1u)], i & 1);
+        }
+      for (auto &p : places) {
+        if ((kind == 1) && !once) // The pattern follows screen position
+          for (int16_t y = 0; y < ih; y++)
+            for (int16_t x = 0; x < iw; x++)
+              ref[y * iw + x] = refDither(&rgb[3 * (y * iw + x)],
+                                          p[0] + x, p[1] + y);
+        tft.fillScreen(ST77XX_BLACK);
+        tft.drawRGBBitmap(p[0], p[1], ref.data(), iw, ih);
+        emu.render(a);
+        tft.fillScreen(ST77XX_BLACK);
+        if (kind == 2)
+          tft.drawYUV422Bitmap(p[0], p[1], yuv.data(), iw, ih);
+        else
+          tft.drawRGB888Bitmap(p[0], p[1], rgb.data(), iw, ih, kind == 1);
+        emu.render(b);
+        uint32_t diff = ST77xxEmulator::diffImages(a, b);
+        if (diff)
+          printf("  %s at %u bits%s, (%d, %d): %u pixels differ\n",
+                 (kind == 2) ? "YUV422" : kind ? "RGB888 dither" : "RGB888",
+                 depth.bits, depth.dither ? " dithered" : "", p[0], p[1],
+                 diff);
+        failures += diff != 0;
+      }
+    }
+  tft.setColorDepth(16);
+
+  // Bus traffic is the same as for 16-bit pixels (both reuse the window)
+  tft.drawRGBBitmap(0, 0, ref.data(), iw, ih);
+  ST77xxEmulator::Stats s0 = emu.stats();
+  tft.drawRGBBitmap(0, 0, ref.data(), iw, ih);
+  uint32_t rgbBytes = emu.stats().since(s0).busBytes();
+  s0 = emu.stats();
+  tft.drawYUV422Bitmap(0, 0, yuv.data(), iw, ih);
+  uint32_t yuvBytes = emu.stats().since(s0).busBytes();
+  printf("%dx%d YUV422 blit: %u bus bytes, drawRGBBitmap %u\n", iw, ih,
+         yuvBytes, rgbBytes);
+
+  printf("%s\n", failures ? "FAILED" : "all conversions match");
+  return failures ? 1 : 0;
+}
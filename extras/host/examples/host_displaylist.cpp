@@ -0,0 +1,112 @@
+// Draw a layered UI directly and through an Adafruit_ST77xxDisplayList and
+// compare them. Reports the bus bytes and time of each and the list's
+// culling statistics, and checks that the frames match in every rotation,
+// at 12-bit color depth and with a list small enough to overflow.
+//
+//   st77xx_displaylist [frames]
+
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxDisplayList.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint16_t icon[32 * 32];
+
+// A full-screen background, panels covering most of it, a title bar,
+// text, an icon and shapes partly off screen. A template, so
+// drawRGBBitmap() is the drawing target's own.
+template <class GFX> static void drawUI(GFX &g, uint32_t frame) {
+  int16_t w = g.width(), h = g.height();
+  g.fillScreen(ST77XX_BLACK);
+  g.fillRect(0, 0, w, 24, ST77XX_BLUE);
+  g.setTextWrap(false);
+  g.setTextSize(2);
+  g.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+  g.setCursor(6, 4);
+  g.print("Status");
+  for (int16_t i = 0; i < 4; i++) {
+    int16_t y = 30 + i * ((h - 36) / 4);
+    g.fillRect(4, y, w - 8, (h - 36) / 4 - 4, 0x2104);
+    g.fillRect(10, y + 6, (w - 20) * ((frame + i * 17) % 64) / 64, 10,
+               ST77XX_GREEN);
+    g.setTextSize(1);
+    g.setTextColor(ST77XX_WHITE, 0x2104);
+    g.setCursor(10, y + 22);
+    g.print("Channel ");
+    g.print(i + 1);
+  }
+  g.drawRGBBitmap(w - 40, 30 + (frame % 8) * 4, icon, 32, 32);
+  g.fillCircle(w - 10, h - 10, 30, ST77XX_RED);
+  g.fillRect(-20, h / 2, 30, 30, ST77XX_YELLOW);
+  g.fillRect(w + 5, 0, 20, 20, ST77XX_CYAN); // Entirely off screen
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20;
+  for (int i = 0; i < 32 * 32; i++)
+    icon[i] = ((i % 32) ^ (i / 32)) & 8 ? ST77XX_ORANGE : ST77XX_MAGENTA;
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  Adafruit_ST77xxDisplayList list(tft, 512), small(tft, 16);
+  if (!list.begin() || !small.begin()) {
+    fprintf(stderr, "out of memory\n");
+    return 2;
+  }
+
+  // Bus traffic and time of the UI, drawn directly and through the list
+  for (int way = 0; way < 2; way++) {
+    ST77xxEmulator::Stats s0 = emu.stats();
+    uint32_t t0 = micros();
+    for (uint32_t f = 0; f < frames; f++) {
+      if (way) {
+        drawUI(list, f);
+        list.commit();
+      } else {
+        drawUI(tft, f);
+      }
+    }
+    uint32_t us = micros() - t0;
+    ST77xxEmulator::Stats s = emu.stats().since(s0);
+    printf("  %-12s %9u bus bytes, %6u RAMWR, %8.2f ms/frame\n",
+           way ? "display list" : "direct", s.busBytes(),
+           s.opcodes[ST77XX_RAMWR], us / 1000.0 / frames);
+  }
+  printf("Last frame: %u operations, %u culled, %u off screen; %u pixels "
+         "sent, %u painted over; %u bytes sent, %u saved\n",
+         list.getRecorded(), list.getCulled(), list.getClipped(),
+         list.getDrawnPixels(), list.getCulledPixels(), list.getBytes(),
+         list.getSavedBytes());
+
+  // Same frame both ways
+  uint32_t failures = 0;
+  for (int bits = 16; bits >= 12; bits -= 4) {
+    tft.setColorDepth(bits);
+    for (uint8_t rot = 0; rot < 4; rot++) {
+      tft.setRotation(rot);
+      std::vector<uint8_t> want, got;
+      drawUI(tft, rot);
+      emu.render(want);
+      for (int size = 0; size < 2; size++) {
+        Adafruit_ST77xxDisplayList &l = size ? small : list;
+        tft.fillScreen(ST77XX_WHITE);
+        l.commit(); // Pick up the rotation
+        drawUI(l, rot);
+        l.commit();
+        emu.render(got);
+        uint32_t diff = ST77xxEmulator::diffImages(want, got);
+        if (diff)
+          printf("  %d-bit, rotation %u, %s list: %u pixels differ\n", bits,
+                 rot, size ? "small" : "large", diff);
+        failures += diff != 0;
+      }
+    }
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All frames match");
+  return failures ? 1 : 0;
+}
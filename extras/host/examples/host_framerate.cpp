@@ -0,0 +1,81 @@
+// Set the panel refresh rate with setFrameRate() and time the real frame
+// period with Adafruit_ST77xxVSync::measure(): on an ST7789 through its TE
+// pin, and on an ST7735 by polling the scanline. The emulated oscillators
+// run off their typical frequency, as real parts do, so the measured period
+// differs from the nominal one setFrameRate() reports. Checks that the
+// nominal period follows the datasheet formula for the registers sent, that
+// the measured one matches the emulated panel, and reports the GRAM rows
+// driven per second, a proxy for panel drive power.
+//
+//   st77xx_framerate
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxVSync.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TE_PIN 7
+
+static const uint16_t targets[] = {30, 45, 50, 60, 75, 90, 120};
+
+template <class Display>
+static uint32_t sweep(Display &tft, ST77xxEmulator &emu, int8_t te,
+                      int32_t ppm) {
+  emu.setOscillatorError(ppm);
+  Adafruit_ST77xxVSync vsync(tft, te);
+  if (!vsync.begin()) {
+    printf("  no blanking period seen\n");
+    return 1;
+  }
+  printf("  target   nominal   measured      rate   rows/s\n");
+  uint32_t failures = 0;
+  for (unsigned i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+    uint32_t nominal = tft.setFrameRate(targets[i]);
+    uint64_t rows0 = emu.refreshedLines();
+    uint32_t t0 = micros();
+    uint32_t measured = vsync.measure();
+    uint32_t us = micros() - t0;
+    uint64_t rows = emu.refreshedLines() - rows0;
+
+    // The panel as emulated, and as it would run at the typical frequency
+    double actual = emu.framePeriod() / 1000.0;
+    double typical = actual * (1 + ppm * 1e-6);
+    bool ok = (abs((int32_t)nominal - (int32_t)(typical + 0.5)) <= 1) &&
+              (abs((int32_t)measured - (int32_t)(actual + 0.5)) <=
+               (int32_t)(actual / 500));
+    printf("  %3u Hz  %6.2f ms  %6.2f ms  %5.1f Hz  %7u%s\n", targets[i],
+           nominal / 1000.0, measured / 1000.0,
+           measured ? 1e6 / measured : 0.0,
+           (unsigned)(rows * 1000000 / (us ? us : 1)), ok ? "" : "  MISMATCH");
+    failures += !ok;
+  }
+  vsync.end();
+  return failures;
+}
+
+int main(void) {
+  uint32_t failures = 0;
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 st7789(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  ST77xxHost::attachTearing(&emu, TE_PIN);
+  st7789.init(240, 320);
+  printf("ST7789, TE pin, oscillator 2.5%% fast\n");
+  failures += sweep(st7789, emu, TE_PIN, 25000);
+
+  c = ST77xxEmulator::ST7735;
+  ST77xxEmulator emu2(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7735 st7735(10, 8, 9);
+  ST77xxHost::detachAll();
+  ST77xxHost::attach(&emu2, 10, 8, 9);
+  st7735.initR(INITR_BLACKTAB);
+  printf("ST7735, scanline polling, oscillator 4%% slow\n");
+  failures += sweep(st7735, emu2, -1, -40000);
+
+  printf("%s\n", failures ? "MISMATCH" : "All frame periods match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+// Draw a text dashboard with and without an Adafruit_ST77xxGlyphCache and
+// compare them: the frames must match, including text clipped at every
+// screen edge, at each text size and at 12-bit color depth. Reports the bus
+// traffic and time of each, the cache hit rate and its memory use.
+//
+//   st77xx_glyph [frames]
+
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxGlyphCache.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// A few lines of changing numbers, as a sensor dashboard would show
+static void drawDashboard(Adafruit_ST7789 &tft, uint32_t frame) {
+  static const char *const labels[] = {"Temp", "Humid", "Press", "Batt"};
+  char text[32];
+  tft.setTextWrap(false);
+  for (uint8_t i = 0; i < 4; i++) {
+    tft.setCursor(8, 10 + i * 24);
+    tft.setTextSize(2);
+    tft.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+    tft.print(labels[i]);
+    tft.setTextColor(ST77XX_YELLOW, ST77XX_BLACK);
+    snprintf(text, sizeof(text), " %5lu",
+             (unsigned long)((frame * 37 + i * 1013) % 100000));
+    tft.print(text);
+  }
+  tft.setTextSize(1);
+  tft.setTextColor(ST77XX_GREEN, ST77XX_BLACK);
+  tft.setCursor(8, 110);
+  snprintf(text, sizeof(text), "Uptime %lu s\nStatus: OK",
+           (unsigned long)frame);
+  tft.print(text);
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : 100;
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  Adafruit_ST77xxGlyphCache cache(48, 2);
+  if (!cache.begin()) {
+    fprintf(stderr, "out of memory\n");
+    return 2;
+  }
+
+  // Bus traffic and time of the dashboard, drawn the usual way and cached
+  for (int way = 0; way < 2; way++) {
+    tft.setGlyphCache(way ? &cache : NULL);
+    tft.fillScreen(ST77XX_BLACK);
+    ST77xxEmulator::Stats s0 = emu.stats();
+    uint32_t t0 = micros();
+    for (uint32_t f = 0; f < frames; f++)
+      drawDashboard(tft, f);
+    uint32_t us = micros() - t0;
+    ST77xxEmulator::Stats s = emu.stats().since(s0);
+    printf("  %-10s %9u bus bytes, %7u commands, %8.2f ms/frame\n",
+           way ? "cached" : "drawChar", s.busBytes(), s.commands,
+           us / 1000.0 / frames);
+  }
+  printf("Hit rate %u%% (%u hits, %u misses), %u bytes of cache\n",
+         cache.getHitRate(), cache.getHits(), cache.getMisses(),
+         cache.getMemoryUsed());
+
+  // Same frame with and without the cache, wherever the text is clipped
+  static const int16_t places[][2] = {{20, 40}, {-5, 40}, {-40, 40},
+                                      {230, 40}, {20, -3}, {20, 315},
+                                      {-4, -5}, {235, 316}, {300, 0}};
+  static const uint8_t sizes[][2] = {{1, 1}, {2, 2}, {1, 2}, {3, 3}};
+  uint32_t failures = 0;
+  for (int bits = 16; bits >= 12; bits -= 4) {
+    tft.setColorDepth(bits);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      for (size_t i = 0; i < sizeof(places) / sizeof(places[0]); i++) {
+        int16_t x = places[i][0], y = places[i][1];
+        std::vector<uint8_t> want, got;
+        for (int way = 0; way < 2; way++) {
+          tft.setGlyphCache(way ? &cache : NULL);
+          tft.fillScreen(ST77XX_BLACK);
+          tft.setTextSize(sizes[s][0], sizes[s][1]);
+          tft.setTextColor(ST77XX_RED, ST77XX_WHITE);
+          tft.setCursor(x, y);
+          tft.print("Ag\xB1");
+          tft.cp437(true);
+          tft.print("\xB1");
+          tft.cp437(false);
+          emu.render(way ? got : want);
+        }
+        uint32_t diff = ST77xxEmulator::diffImages(want, got);
+        if (diff)
+          printf("  %d-bit, size %ux%u at (%d, %d): %u pixels differ\n", bits,
+                 sizes[s][0], sizes[s][1], x, y, diff);
+        failures += diff != 0;
+      }
+    }
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All placements match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// Three ST7735 displays side by side on one SPI bus, with separate CS pins
+// and a shared DC line. A dashboard spanning all three is drawn on each
+// display directly and through an Adafruit_ST77xxGroup canvas. Reports the
+// chip select assertions, bus bytes and time of both, the group's bus
+// utilization and per-display latency, and checks the frames match, also
+// with a queue small enough to overflow.
+//
+//   st77xx_group [frames]
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST77xxGroup.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PANELS 3
+#define TFT_DC 8
+
+static uint16_t needle[24 * 24];
+
+// The dashboard, in canvas coordinates shifted left by dx so each display
+// can draw its own part of it. A template, so drawRGBBitmap() is the
+// drawing target's own.
+template <class GFX>
+static void drawScene(GFX &g, int16_t dx, uint32_t frame) {
+  g.fillRect(0 - dx, 0, 384, 160, ST77XX_BLACK);
+  g.fillRect(0 - dx, 0, 384, 20, ST77XX_BLUE);
+  g.setTextWrap(false);
+  g.setTextSize(1);
+  g.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+  g.setCursor(150 - dx, 6);
+  g.print("Line 3 - Press 7");
+  for (int16_t i = 0; i < 6; i++) {
+    int16_t x = 8 + i * 63, level = (frame * 7 + i * 29) % 100;
+    g.drawRect(x - dx, 30, 50, 104, ST77XX_WHITE);
+    g.fillRect(x + 2 - dx, 132 - level, 46, level, ST77XX_GREEN);
+  }
+  g.fillCircle(192 - dx, 145, 10, ST77XX_RED);
+  g.drawLine(0 - dx, 159, 383 - dx, 140, ST77XX_YELLOW);
+  g.drawRGBBitmap(116 + (frame % 40) - dx, 70, needle, 24, 24);
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20;
+  for (int i = 0; i < 24 * 24; i++)
+    needle[i] = ((i % 24) == (i / 24)) ? ST77XX_WHITE : 0x4208;
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7735;
+  ST77xxEmulator *emu[PANELS];
+  Adafruit_ST7735 *tft[PANELS];
+  for (int i = 0; i < PANELS; i++) {
+    emu[i] = new ST77xxEmulator(c, ST77xxEmulator::defaultPanel(c));
+    tft[i] = new Adafruit_ST7735(10 + i, TFT_DC, -1);
+    ST77xxHost::attach(emu[i], 10 + i, TFT_DC);
+    tft[i]->initR(INITR_GREENTAB);
+  }
+
+  uint32_t failures = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    Adafruit_ST77xxGroup group(PANELS * 128, 160);
+    for (int i = 0; i < PANELS; i++)
+      group.addPanel(*tft[i], i * 128, 0);
+    if (!group.begin(pass ? 8 : 256)) {
+      fprintf(stderr, "out of memory\n");
+      return 2;
+    }
+    printf("Queue of %u operations:\n", pass ? 8 : 256);
+
+    for (int way = 0; way < 2; way++) {
+      ST77xxEmulator::Stats s0[PANELS];
+      for (int i = 0; i < PANELS; i++)
+        s0[i] = emu[i]->stats();
+      group.resetStats();
+      uint32_t t0 = micros();
+      for (uint32_t f = 0; f < frames; f++) {
+        if (way) {
+          drawScene(group, 0, f);
+          group.flush();
+        } else {
+          for (int i = 0; i < PANELS; i++)
+            drawScene(*tft[i], i * 128, f);
+        }
+      }
+      uint32_t us = micros() - t0;
+      uint32_t cs = 0, bytes = 0;
+      for (int i = 0; i < PANELS; i++) {
+        ST77xxEmulator::Stats s = emu[i]->stats().since(s0[i]);
+        cs += s.csAssertions;
+        bytes += s.busBytes();
+      }
+      printf("  %-7s %7u CS assertions, %8u bus bytes, %7.2f ms/frame\n",
+             way ? "group" : "direct", cs, bytes, us / 1000.0 / frames);
+    }
+    printf("  %u operations in %u transactions, bus %u%% busy\n",
+           group.getOps(), group.getTransactions(), group.getBusUtilization());
+    for (int i = 0; i < PANELS; i++)
+      printf("  display %d: %u bytes, latency %u us (max %u us)\n", i,
+             group.getBytes(i), group.getLatency(i), group.getMaxLatency(i));
+
+    // Same frames both ways
+    std::vector<uint8_t> want[PANELS], got;
+    for (int i = 0; i < PANELS; i++) {
+      drawScene(*tft[i], i * 128, 3);
+      emu[i]->render(want[i]);
+    }
+    for (int i = 0; i < PANELS; i++)
+      tft[i]->fillScreen(ST77XX_MAGENTA);
+    drawScene(group, 0, 3);
+    group.flush();
+    for (int i = 0; i < PANELS; i++) {
+      emu[i]->render(got);
+      uint32_t diff = ST77xxEmulator::diffImages(want[i], got);
+      if (diff)
+        printf("  display %d: %u pixels differ\n", i, diff);
+      failures += diff != 0;
+    }
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All displays match");
+  return failures ? 1 : 0;
+}
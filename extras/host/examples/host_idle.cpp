@@ -0,0 +1,151 @@
+// Automatic idle mode on the virtual clock: setIdleTimeout() and a render
+// loop that calls checkIdle() every millisecond. Checks the IDMON/IDMOFF
+// commands on the bus and when they go out: idle mode once the timeout has
+// passed since the last draw, out of it at the start of the next draw,
+// held off by regular drawing, left alone when entered by hand, and ended
+// when the timeout is turned off.
+//
+//   st77xx_idle
+
+#include <Adafruit_ST7735.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TIMEOUT_MS 1000
+
+struct Command {
+  uint8_t op;
+  uint64_t ns;
+};
+
+static uint32_t failures = 0;
+static size_t seen = 0;
+
+// Commands on the bus since the last call
+static std::vector<Command> commands(ST77xxEmulator &emu) {
+  std::vector<Command> out;
+  const std::vector<ST77xxEmulator::Event> &events = emu.capture();
+  for (; seen < events.size(); seen++)
+    if (events[seen].type == ST77xxEmulator::EVENT_COMMAND) {
+      Command c = {events[seen].value, events[seen].ns};
+      out.push_back(c);
+    }
+  return out;
+}
+
+// The commands of interest, in order
+static std::vector<uint8_t> idleOps(const std::vector<Command> &cmds) {
+  std::vector<uint8_t> ops;
+  for (auto &c : cmds)
+    if ((c.op == ST77XX_IDMON) || (c.op == ST77XX_IDMOFF))
+      ops.push_back(c.op);
+  return ops;
+}
+
+static void check(const char *what, bool ok, const char *detail = "") {
+  printf("  %-44s %s%s\n", what, ok ? "ok" : "FAILED", detail);
+  failures += !ok;
+}
+
+// Call checkIdle() once a millisecond for a while, as loop() would
+static void loopFor(Adafruit_ST7735 &tft, uint32_t ms) {
+  for (uint32_t i = 0; i < ms; i++) {
+    delay(1);
+    tft.checkIdle();
+  }
+}
+
+static void draw(Adafruit_ST7735 &tft, uint16_t color) {
+  tft.fillRect(10, 40, 60, 20, color);
+}
+
+// Loop until IDMON goes out and check it came TIMEOUT_MS after the last
+// draw, to the millisecond
+static void expectIdle(const char *what, Adafruit_ST7735 &tft,
+                       ST77xxEmulator &emu, uint64_t drawnNs) {
+  loopFor(tft, 2 * TIMEOUT_MS);
+  std::vector<Command> cmds = commands(emu);
+  char detail[64] = "";
+  bool ok = (cmds.size() == 1) && (cmds[0].op == ST77XX_IDMON) &&
+            emu.idleMode() && tft.checkIdle();
+  if (!cmds.empty()) {
+    double after = (cmds[0].ns - drawnNs) / 1e6;
+    snprintf(detail, sizeof(detail), " (after %.3f ms)", after);
+    ok = ok && (after >= TIMEOUT_MS) && (after < TIMEOUT_MS + 1);
+  }
+  check(what, ok, detail);
+}
+
+int main(void) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7735;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  Adafruit_ST7735 tft(10, 8, 9);
+  tft.initR(INITR_GREENTAB);
+  tft.fillScreen(ST77XX_BLACK);
+  emu.setCapture(true);
+  printf("Idle timeout %u ms, checkIdle() every ms:\n", TIMEOUT_MS);
+
+  tft.setIdleTimeout(TIMEOUT_MS);
+  draw(tft, ST77XX_BLUE);
+  uint64_t drawn = ST77xxHost::nanos();
+  commands(emu);
+  expectIdle("IDMON once the timeout has passed", tft, emu, drawn);
+
+  loopFor(tft, 2 * TIMEOUT_MS);
+  check("nothing more while idle", commands(emu).empty() && emu.idleMode());
+
+  // The next draw leaves idle mode before anything else goes out
+  draw(tft, ST77XX_RED);
+  drawn = ST77xxHost::nanos();
+  std::vector<Command> cmds = commands(emu);
+  check("IDMOFF first in the next draw",
+        !cmds.empty() && (cmds[0].op == ST77XX_IDMOFF) &&
+            (idleOps(cmds).size() == 1) && !emu.idleMode());
+  expectIdle("IDMON again, timed from that draw", tft, emu, drawn);
+
+  // Drawing more often than the timeout keeps the display out of idle
+  draw(tft, ST77XX_GREEN);
+  for (int i = 0; i < 5; i++) {
+    loopFor(tft, TIMEOUT_MS * 6 / 10);
+    draw(tft, (i & 1) ? ST77XX_GREEN : ST77XX_YELLOW);
+  }
+  cmds = commands(emu);
+  std::vector<uint8_t> ops = idleOps(cmds);
+  check("drawing every 600 ms holds it off",
+        (ops.size() == 1) && (ops[0] == ST77XX_IDMOFF) && !emu.idleMode());
+  drawn = ST77xxHost::nanos();
+  expectIdle("IDMON after the drawing stops", tft, emu, drawn);
+
+  // Idle mode entered by hand is left to the sketch
+  draw(tft, ST77XX_BLUE);
+  tft.enableIdle(true);
+  draw(tft, ST77XX_RED);
+  loopFor(tft, 2 * TIMEOUT_MS);
+  ops = idleOps(commands(emu));
+  check("enableIdle(true) survives drawing",
+        (ops.size() == 2) && (ops[0] == ST77XX_IDMOFF) &&
+            (ops[1] == ST77XX_IDMON) && emu.idleMode());
+  tft.enableIdle(false);
+  ops = idleOps(commands(emu));
+  check("enableIdle(false) ends it", (ops.size() == 1) &&
+                                         (ops[0] == ST77XX_IDMOFF) &&
+                                         !emu.idleMode());
+
+  // Turning the timeout off while idle leaves idle mode at once
+  drawn = ST77xxHost::nanos();
+  expectIdle("IDMON after enableIdle(false)", tft, emu, drawn);
+  tft.setIdleTimeout(0);
+  ops = idleOps(commands(emu));
+  check("setIdleTimeout(0) sends IDMOFF",
+        (ops.size() == 1) && (ops[0] == ST77XX_IDMOFF) && !emu.idleMode());
+  loopFor(tft, 3 * TIMEOUT_MS);
+  check("no timeout, no idle mode",
+        commands(emu).empty() && !emu.idleMode() && !tft.checkIdle());
+
+  printf("%u timing violations\n", emu.stats().violations);
+  failures += emu.stats().violations;
+  printf("%s\n", failures ? "MISMATCH" : "Idle mode follows the timeout");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+// Render through Adafruit_ST77xxIndexedCanvas at 8 and 4 bits per pixel and
+// check every flushed frame against the same scene drawn with 16-bit
+// colors: in all four canvas rotations, flushed partly off screen, after
+// small updates (only the changed rows are sent) and while color cycling
+// the palette. Prints the RAM each canvas takes next to a GFXcanvas16.
+//
+//   st77xx_indexed [frames]
+
+#include <Adafruit_ST77xxIndexedCanvas.h>
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RAMP_FIRST 16 // Palette entries used for the cycling color ramp
+#define RAMP_COUNT 12
+
+// Same scene on any GFX target; colors are palette indices
+static void drawScene(Adafruit_GFX &g, uint16_t colors) {
+  g.fillScreen(1);
+  for (int16_t i = 0; i < RAMP_COUNT; i++) // Concentric rings
+    g.fillCircle(g.width() / 2, g.height() / 2, 110 - i * 9,
+                 (colors > RAMP_FIRST) ? RAMP_FIRST + i : 2 + (i % 12));
+  g.fillRect(10, 10, 61, 33, 14);
+  g.drawRect(9, 9, 63, 35, 15);
+  g.setCursor(14, 22);
+  g.setTextColor(0);
+  g.print("Indexed");
+  for (int16_t x = 0; x < g.width(); x += 7)
+    g.drawFastVLine(x, g.height() - 20, 20, x % colors);
+}
+
+// Expected 16-bit image of an indexed canvas
+static void expand(Adafruit_ST77xxIndexedCanvas &c, GFXcanvas16 &out) {
+  uint8_t r = c.getRotation();
+  c.setRotation(0);
+  for (int16_t y = 0; y < c.height(); y++)
+    for (int16_t x = 0; x < c.width(); x++)
+      out.getBuffer()[y * c.width() + x] =
+          c.getPaletteColor(c.getPixel(x, y));
+  c.setRotation(r);
+}
+
+int main(int argc, char **argv) {
+  int frames = (argc > 1) ? atoi(argv[1]) : 24;
+
+  ST77xxEmulator::Controller ctl = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(ctl, ST77xxEmulator::defaultPanel(ctl));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  const uint16_t w = 240, h = 320;
+  printf("%ux%u canvas: GFXcanvas16 %u bytes\n", w, h, w * h * 2);
+  uint32_t failures = 0;
+  for (uint8_t bits = 8; bits >= 4; bits -= 4) {
+    uint16_t colors = 1 << bits;
+    Adafruit_ST77xxIndexedCanvas canvas(w, h, bits);
+    if (!canvas.begin())
+      return 2;
+    printf("%u-bit: %u bytes (buffer %u, palette %u, line %u)\n", bits,
+           canvas.getStride() * h + colors * 2 + w * 2,
+           canvas.getStride() * h, colors * 2, w * 2);
+    if (bits == 8) { // A red-to-blue ramp to cycle
+      for (int16_t i = 0; i < RAMP_COUNT; i++)
+        canvas.setPaletteColor(RAMP_FIRST + i,
+                               tft.color565(255 - i * 21, 40, i * 21));
+    }
+
+    GFXcanvas16 want(w, h);
+    std::vector<uint8_t> a, b;
+    // Flush at an offset (x, y): compare the display with the expected
+    // image drawn at the same place
+    auto check = [&](const char *what, int16_t x, int16_t y) {
+      expand(canvas, want);
+      tft.fillScreen(ST77XX_BLACK);
+      tft.drawRGBBitmap(x, y, want.getBuffer(), w, h);
+      emu.render(a);
+      tft.fillScreen(ST77XX_BLACK);
+      canvas.markAllDirty();
+      canvas.flush(tft, x, y);
+      emu.render(b);
+      uint32_t diff = ST77xxEmulator::diffImages(a, b);
+      if (diff)
+        printf("  %s at (%d, %d): %u pixels differ\n", what, x, y, diff);
+      failures += diff != 0;
+    };
+
+    for (uint8_t r = 0; r < 4; r++) {
+      canvas.setRotation(r);
+      drawScene(canvas, colors);
+      check("rotation", 0, 0);
+    }
+    canvas.setRotation(0);
+    drawScene(canvas, colors);
+    check("clipped", -37, 51);
+    check("clipped", 91, -200);
+
+    // Small update: only the rows it touched go out
+    tft.fillScreen(ST77XX_BLACK);
+    canvas.markAllDirty();
+    canvas.flush(tft);
+    canvas.fillRect(100, 150, 9, 5, 3);
+    ST77xxEmulator::Stats s0 = emu.stats();
+    uint32_t bytes = canvas.flush(tft);
+    uint32_t sent = emu.stats().since(s0).busBytes();
+    emu.render(b);
+    expand(canvas, want);
+    tft.drawRGBBitmap(0, 0, want.getBuffer(), w, h);
+    emu.render(a);
+    uint32_t diff = ST77xxEmulator::diffImages(a, b);
+    printf("  small update: %u bus bytes (flush() reported %u)%s\n", sent,
+           bytes, diff ? ", MISMATCH" : "");
+    failures += diff != 0;
+
+    // Color cycling: only the palette changes, the whole frame is resent
+    uint32_t cycleBytes = 0;
+    for (int f = 0; f < frames; f++) {
+      canvas.rotatePalette((bits == 8) ? RAMP_FIRST : 2, RAMP_COUNT,
+                           (f & 1) ? -1 : 2);
+      cycleBytes += canvas.flush(tft);
+    }
+    check("cycled", 0, 0);
+    printf("  %d cycled frames: %u bus bytes each\n", frames,
+           frames ? cycleBytes / frames : 0);
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All frames match");
+  return failures ? 1 : 0;
+}
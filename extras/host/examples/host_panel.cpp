@@ -0,0 +1,144 @@
+// Drive each of Adafruit's displays through its runtime class and through
+// the matching compile-time Adafruit_ST77xxPanel type, and check that the
+// two send the same bytes for the same drawing in every rotation and leave
+// the same picture on the glass. Reports the bus bytes and time of init
+// and of drawing for both.
+//
+//   st77xx_panel
+
+#include <Adafruit_ST77xxPanel.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint32_t failures = 0;
+
+// A bit of everything that sets an address window
+static void drawScene(Adafruit_ST77xx &tft) {
+  static uint16_t tile[16 * 12];
+  for (int i = 0; i < 16 * 12; i++)
+    tile[i] = (uint16_t)(i * 0x9E37);
+  int16_t w = tft.width(), h = tft.height();
+  tft.fillScreen(ST77XX_BLUE);
+  tft.fillRect(2, 3, w / 2, h / 3, ST77XX_RED);
+  tft.drawFastHLine(0, h - 1, w, ST77XX_WHITE);
+  tft.drawFastVLine(w - 1, 0, h, ST77XX_YELLOW);
+  tft.drawPixel(0, 0, ST77XX_GREEN);
+  tft.drawRGBBitmap(w - 20, h / 2, tile, 16, 12);
+  tft.fillCircle(w / 2, h / 2, w / 5, ST77XX_MAGENTA);
+}
+
+// Pixels and bus traffic of the scene in every rotation
+struct Run {
+  std::vector<uint8_t> frames[4];
+  std::vector<uint8_t> bytes; // Command and data bytes, DC in the top bit
+  uint32_t initBytes, initUs, drawUs;
+};
+
+static Run capture(Adafruit_ST77xx &tft, ST77xxEmulator &emu,
+                   ST77xxEmulator::Stats s0, uint32_t initUs) {
+  Run run;
+  run.initBytes = emu.stats().since(s0).busBytes();
+  run.initUs = initUs;
+  emu.setCapture(true);
+  emu.clearCapture();
+  uint32_t t0 = micros();
+  for (uint8_t rot = 0; rot < 4; rot++) {
+    tft.setRotation(rot);
+    drawScene(tft);
+    emu.render(run.frames[rot]);
+  }
+  run.drawUs = micros() - t0;
+  emu.setCapture(false);
+  for (size_t i = 0; i < emu.capture().size(); i++) {
+    const ST77xxEmulator::Event &e = emu.capture()[i];
+    if (e.type == ST77xxEmulator::EVENT_COMMAND)
+      run.bytes.push_back(e.value), run.bytes.push_back(0x80);
+    else if (e.type == ST77xxEmulator::EVENT_DATA)
+      run.bytes.push_back(e.value);
+  }
+  return run;
+}
+
+// The runtime class, initialized by init(), against the panel type
+template <class Runtime, class Panel, class Init>
+static void compare(const char *name, ST77xxEmulator::Controller c,
+                    uint16_t w, uint16_t h, Init init) {
+  // Each on its own glass, so neither sees what the other left in GRAM
+  ST77xxEmulator emuA(c, ST77xxEmulator::defaultPanel(c, w, h)),
+      emuB(c, ST77xxEmulator::defaultPanel(c, w, h));
+  ST77xxHost::detachAll();
+  ST77xxHost::attach(&emuA, 10, 8, 9);
+  Runtime a(10, 8, 9);
+  ST77xxEmulator::Stats s0 = emuA.stats();
+  uint32_t t0 = micros();
+  init(a);
+  Run ra = capture(a, emuA, s0, micros() - t0);
+
+  ST77xxHost::detachAll();
+  ST77xxHost::attach(&emuB, 10, 8, 9);
+  Panel b(10, 8, 9);
+  s0 = emuB.stats();
+  t0 = micros();
+  b.init();
+  Run rb = capture(b, emuB, s0, micros() - t0);
+
+  uint32_t diff = 0;
+  for (int rot = 0; rot < 4; rot++)
+    diff += ST77xxEmulator::diffImages(ra.frames[rot], rb.frames[rot]);
+  bool same = ra.bytes == rb.bytes;
+  printf("%-22s init %5u / %5u bytes, %6.1f / %6.1f ms; draw %7u bytes, "
+         "%6.2f / %6.2f ms%s\n",
+         name, ra.initBytes, rb.initBytes, ra.initUs / 1000.0,
+         rb.initUs / 1000.0, (unsigned)rb.bytes.size(), ra.drawUs / 1000.0,
+         rb.drawUs / 1000.0, same ? "" : ", bus traffic differs");
+  if (diff)
+    printf("  %u pixels differ\n", diff);
+  failures += (diff != 0) || !same;
+}
+
+static void st7735(Adafruit_ST7735 &tft, uint8_t tab) { tft.initR(tab); }
+
+int main(void) {
+  printf("%-22s runtime class / panel type\n", "");
+  compare<Adafruit_ST7735, Adafruit_ST7735_GreenTab>(
+      "ST7735 green tab", ST77xxEmulator::ST7735, 128, 160,
+      [](Adafruit_ST7735 &t) { st7735(t, INITR_GREENTAB); });
+  compare<Adafruit_ST7735, Adafruit_ST7735_BlackTab>(
+      "ST7735 black tab", ST77xxEmulator::ST7735, 128, 160,
+      [](Adafruit_ST7735 &t) { st7735(t, INITR_BLACKTAB); });
+  // INITR_REDTAB is INITR_144GREENTAB's code; initR() sets up the red tab
+  // for any code it has no case for
+  compare<Adafruit_ST7735, Adafruit_ST7735_RedTab>(
+      "ST7735 red tab", ST77xxEmulator::ST7735, 128, 160,
+      [](Adafruit_ST7735 &t) { st7735(t, 0x03); });
+  compare<Adafruit_ST7735, Adafruit_ST7735_144GreenTab>(
+      "ST7735 1.44\" green tab", ST77xxEmulator::ST7735, 128, 128,
+      [](Adafruit_ST7735 &t) { st7735(t, INITR_144GREENTAB); });
+  compare<Adafruit_ST7735, Adafruit_ST7735_Mini160x80>(
+      "ST7735 mini 160x80", ST77xxEmulator::ST7735, 80, 160,
+      [](Adafruit_ST7735 &t) { st7735(t, INITR_MINI160x80); });
+  compare<Adafruit_ST7735, Adafruit_ST7735_Mini160x80Plugin>(
+      "ST7735 mini plugin", ST77xxEmulator::ST7735, 80, 160,
+      [](Adafruit_ST7735 &t) { st7735(t, INITR_MINI160x80_PLUGIN); });
+  compare<Adafruit_ST7789, Adafruit_ST7789_240x320>(
+      "ST7789 240x320", ST77xxEmulator::ST7789, 240, 320,
+      [](Adafruit_ST7789 &t) { t.init(240, 320); });
+  compare<Adafruit_ST7789, Adafruit_ST7789_240x280>(
+      "ST7789 240x280", ST77xxEmulator::ST7789, 240, 280,
+      [](Adafruit_ST7789 &t) { t.init(240, 280); });
+  compare<Adafruit_ST7789, Adafruit_ST7789_240x240>(
+      "ST7789 240x240", ST77xxEmulator::ST7789, 240, 240,
+      [](Adafruit_ST7789 &t) { t.init(240, 240); });
+  compare<Adafruit_ST7789, Adafruit_ST7789_170x320>(
+      "ST7789 170x320", ST77xxEmulator::ST7789, 170, 320,
+      [](Adafruit_ST7789 &t) { t.init(170, 320); });
+  compare<Adafruit_ST7789, Adafruit_ST7789_135x240>(
+      "ST7789 135x240", ST77xxEmulator::ST7789, 135, 240,
+      [](Adafruit_ST7789 &t) { t.init(135, 240); });
+  compare<Adafruit_ST7796S, Adafruit_ST7796S_320x480>(
+      "ST7796S 320x480", ST77xxEmulator::ST7796S, 320, 480,
+      [](Adafruit_ST7796S &t) { t.init(); });
+  printf("%s\n", failures ? "MISMATCH" : "All panels match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+// Compare the panel refresh work of normal and partial mode. A full screen
+// is drawn, then only a status band is kept refreshing for a while. The
+// emulator counts the GRAM rows driven with image data, and the frames are
+// checked: the band (and nothing else) stays visible in partial mode, and
+// the whole screen returns unchanged in normal mode.
+//
+//   st77xx_partial [band-lines] [seconds]
+
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Expected view in partial mode: the band's lines, black elsewhere
+static void maskBand(std::vector<uint8_t> &rgb, uint16_t w, uint16_t h,
+                     uint8_t rotation, int16_t top, int16_t lines) {
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      // The viewer sees GRAM rows top to bottom. Band lines run along x in
+      // rotations 1/3, where MV maps x to GRAM rows, and MY (rotations 2/3)
+      // counts them from the bottom.
+      int16_t line = (rotation < 2) ? y : h - 1 - y;
+      if ((line < top) || (line >= top + lines))
+        memset(&rgb[((size_t)y * w + x) * 3], 0, 3);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  int16_t lines = (argc > 1) ? atoi(argv[1]) : 24;
+  uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 10;
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  uint32_t failures = 0;
+  for (uint8_t r = 0; r < 4; r++) {
+    tft.setRotation(r);
+    for (int16_t y = 0; y < tft.height(); y += 8)
+      tft.fillRect(0, y, tft.width(), 8, (y * 0x841) ^ 0xF81F);
+    tft.fillRect(0, 0, (r & 1) ? lines : tft.width(),
+                 (r & 1) ? tft.height() : lines, ST77XX_BLUE);
+    std::vector<uint8_t> full, band, view;
+    emu.render(full);
+
+    uint64_t n0 = emu.refreshedLines();
+    delay(seconds * 1000);
+    uint64_t normal = emu.refreshedLines() - n0;
+
+    ST77xxEmulator::Stats s0 = emu.stats();
+    tft.setPartialArea(0, lines);
+    tft.enablePartialMode(true);
+    uint32_t bytes = emu.stats().since(s0).busBytes();
+    emu.render(view);
+    band = full;
+    maskBand(band, emu.panel().width, emu.panel().height, r, 0, lines);
+    uint32_t diffPartial = ST77xxEmulator::diffImages(band, view);
+
+    n0 = emu.refreshedLines();
+    delay(seconds * 1000);
+    uint64_t partial = emu.refreshedLines() - n0;
+
+    tft.enablePartialMode(false);
+    emu.render(view);
+    uint32_t diffNormal = ST77xxEmulator::diffImages(full, view);
+
+    printf("rotation %u: %llu rows driven in normal mode, %llu in partial "
+           "mode (%.1f%%); %u bytes to switch; %u/%u pixels differ\n",
+           r, (unsigned long long)normal, (unsigned long long)partial,
+           normal ? 100.0 * partial / normal : 0.0, bytes, diffPartial,
+           diffNormal);
+    failures += diffPartial + diffNormal;
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+// Draw a photographic image with drawQOI(), from memory and from a Stream,
+// and compare it with the same pixels drawn by drawRGBBitmap(). Reports the
+// encoded sizes against a raw RGB565 array, the bus traffic and time of
+// both ways, and checks every placement, clipped at each screen edge, at
+// 16 and 12-bit color depth. The Stream is modelled as a file on an SD
+// card sharing the display's bus, so no read may happen while the display
+// is selected. Truncated and invalid data must be rejected.
+//
+//   st77xx_qoi [image.ppm]
+//
+// Without an image, a generated landscape (gradients and grain) is used.
+
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <ST77xxQOI.h>
+#include <math.h>
+#include <stdio.h>
+
+// Stream over a byte array, as a File on an SD card on the display's bus
+// would be: each read selects the card and clocks its bytes over SPI, so
+// a display still selected would take them in too
+class MemoryStream : public Stream {
+public:
+  MemoryStream(const std::vector<uint8_t> &d, ST77xxEmulator *display)
+      : data(d), display(display) {}
+  int available(void) { return data.size() - pos; }
+  int read(void) {
+    uint8_t c;
+    return (readBytes(&c, 1) == 1) ? c : -1;
+  }
+  int peek(void) { return (pos < data.size()) ? data[pos] : -1; }
+  size_t write(uint8_t) { return 0; }
+  size_t readBytes(uint8_t *buf, size_t n) {
+    if (display->selected())
+      collisions++;
+    SPI.beginTransaction(SPISettings(25000000, MSBFIRST, SPI_MODE0));
+    digitalWrite(SD_CS, LOW);
+    size_t got = 0;
+    for (; (got < n) && (pos < data.size()); got++) {
+      SPI.transfer(0xFF);
+      buf[got] = data[pos++];
+    }
+    digitalWrite(SD_CS, HIGH);
+    SPI.endTransaction();
+    return got;
+  }
+  uint32_t collisions = 0; // Reads with the display selected
+
+private:
+  static const uint8_t SD_CS = 4;
+  const std::vector<uint8_t> &data;
+  ST77xxEmulator *display;
+  size_t pos = 0;
+};
+
+static void drawLandscape(std::vector<uint8_t> &rgb, uint16_t w, uint16_t h) {
+  uint32_t seed = 1;
+  rgb.resize((size_t)w * h * 3);
+  for (uint16_t y = 0; y < h; y++)
+    for (uint16_t x = 0; x < w; x++) {
+      float r, g, b;
+      float hill = h * 0.6f + 18 * sinf(x * 0.03f) + 9 * sinf(x * 0.11f);
+      if (y < hill) { // Sky, lighter toward the horizon, and a sun
+        float t = (float)y / hill;
+        r = 60 + 150 * t;
+        g = 110 + 110 * t;
+        b = 200 + 50 * t;
+        float d = hypotf(x - w * 0.7f, y - h * 0.25f);
+        if (d < 40) {
+          float k = (d < 24) ? 1 : (40 - d) / 16;
+          r += (255 - r) * k;
+          g += (240 - g) * k;
+          b += (180 - b) * k;
+        }
+      } else { // Grass, darker toward the bottom
+        float t = (y - hill) / (h - hill);
+        r = 70 - 40 * t;
+        g = 150 - 70 * t;
+        b = 50 - 20 * t;
+      }
+      seed = seed * 1103515245 + 12345; // Film grain
+      float n = (float)((seed >> 16) & 7) - 3.5f;
+      uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+      p[0] = fminf(fmaxf(r + n, 0), 255);
+      p[1] = fminf(fmaxf(g + n, 0), 255);
+      p[2] = fminf(fmaxf(b + n, 0), 255);
+    }
+}
+
+int main(int argc, char **argv) {
+  std::vector<uint8_t> rgb;
+  uint16_t w = 240, h = 320;
+  if (argc > 1) {
+    if (!ST77xxEmulator::readPPM(argv[1], rgb, w, h)) {
+      fprintf(stderr, "could not read %s\n", argv[1]);
+      return 2;
+    }
+  } else {
+    drawLandscape(rgb, w, h);
+  }
+  std::vector<uint16_t> pixels((size_t)w * h);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    const uint8_t *p = &rgb[i * 3];
+    pixels[i] = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+  }
+  std::vector<uint8_t> qoi = ST77xxQOI::encode(rgb.data(), w, h),
+                       full = ST77xxQOI::encode(rgb.data(), w, h, false);
+  printf("%ux%u image: %u bytes as RGB565, QOI %u (%.1fx smaller), "
+         "%u keeping all 24 bits\n",
+         w, h, (unsigned)pixels.size() * 2, (unsigned)qoi.size(),
+         pixels.size() * 2.0 / qoi.size(), (unsigned)full.size());
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  uint32_t failures = 0;
+  uint16_t qw = 0, qh = 0;
+  if (!Adafruit_ST77xx::getQOISize(qoi.data(), &qw, &qh) || (qw != w) ||
+      (qh != h)) {
+    printf("  getQOISize() failed\n");
+    failures++;
+  }
+
+  // Bus traffic and time, fully on screen
+  static const char *const ways[] = {"drawRGBBitmap(RAM)", "drawQOI(memory)",
+                                     "drawQOI(Stream)"};
+  for (int way = 0; way < 3; way++) {
+    tft.fillScreen(ST77XX_BLACK);
+    MemoryStream stream(qoi, &emu);
+    ST77xxEmulator::Stats s0 = emu.stats();
+    uint32_t t0 = micros();
+    if (way == 0)
+      tft.drawRGBBitmap(0, 0, pixels.data(), w, h);
+    else if (way == 1)
+      tft.drawQOI(0, 0, qoi.data(), qoi.size());
+    else
+      tft.drawQOI(0, 0, stream);
+    uint32_t us = micros() - t0;
+    ST77xxEmulator::Stats s = emu.stats().since(s0);
+    printf("  %-20s %7u bus bytes, %5u commands, %6u us\n", ways[way],
+           s.busBytes(), s.commands, us);
+    if (stream.collisions) {
+      printf("  %u reads with the display selected\n", stream.collisions);
+      failures++;
+    }
+  }
+
+  // Same frame as the RAM bitmap, wherever the image is clipped
+  static const int16_t places[][2] = {
+      {0, 0},     {-50, 40},  {100, 40}, {20, -60}, {20, 250},
+      {-70, -90}, {150, 260}, {-300, 0}, {0, 400}};
+  for (int bits = 16; bits >= 12; bits -= 4) {
+    tft.setColorDepth(bits);
+    for (size_t i = 0; i < sizeof(places) / sizeof(places[0]); i++) {
+      int16_t x = places[i][0], y = places[i][1];
+      std::vector<uint8_t> want, got;
+      tft.fillScreen(ST77XX_BLACK);
+      tft.drawRGBBitmap(x, y, pixels.data(), w, h);
+      emu.render(want);
+      for (int way = 0; way < 3; way++) {
+        const std::vector<uint8_t> &data = (way == 1) ? full : qoi;
+        MemoryStream stream(data, &emu);
+        tft.fillScreen(ST77XX_BLACK);
+        bool ok = (way == 2) ? tft.drawQOI(x, y, stream)
+                             : tft.drawQOI(x, y, data.data(), data.size());
+        emu.render(got);
+        uint32_t diff = ST77xxEmulator::diffImages(want, got);
+        if (diff || !ok || stream.collisions)
+          printf("  %d-bit at (%d, %d), %s: %u pixels differ, %u reads with "
+                 "the display selected%s\n",
+                 bits, x, y,
+                 (way == 2)   ? "Stream"
+                 : (way == 1) ? "24-bit"
+                              : "memory",
+                 diff, stream.collisions, ok ? "" : ", returned false");
+        failures += diff || !ok || stream.collisions;
+      }
+    }
+  }
+  tft.setColorDepth(16);
+
+  // Bad data is refused; a truncated image draws what it has
+  std::vector<uint8_t> bad = qoi;
+  bad[0] = 'x';
+  if (tft.drawQOI(0, 0, bad.data(), bad.size()) ||
+      tft.drawQOI(0, 0, qoi.data(), qoi.size() / 2) ||
+      tft.drawQOI(0, 0, qoi.data(), 10)) {
+    printf("  invalid or truncated data was accepted\n");
+    failures++;
+  }
+
+  printf("%s\n", failures ? "MISMATCH" : "All placements match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+// Read pixels back from GRAM over MISO. Checks readRect() against the
+// bitmap drawn, in every rotation, clipped at the screen edges and at 18
+// bits; checks blendRect() against the blend worked out on the host; and
+// saves a screenshot with writeBMP(), comparing it with the emulated glass.
+// Reports the bus bytes and time of each.
+//
+//   st77xx_readback [screenshot.bmp]
+
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Collects what writeBMP() sends, as a File would
+class MemoryPrint : public Print {
+public:
+  size_t write(uint8_t c) {
+    data.push_back(c);
+    return 1;
+  }
+  using Print::write;
+  std::vector<uint8_t> data;
+};
+
+static uint16_t image[64 * 48];
+
+static uint32_t get32(const std::vector<uint8_t> &v, size_t at) {
+  return v[at] | (v[at + 1] << 8) | (v[at + 2] << 16) |
+         ((uint32_t)v[at + 3] << 24);
+}
+
+// Expected 5-6-5 channel of a blend with 5-bit alpha, within one step
+static bool near(uint16_t got, uint16_t bg, uint16_t fg, uint8_t alpha) {
+  static const uint8_t shift[] = {11, 5, 0}, mask[] = {0x1F, 0x3F, 0x1F};
+  uint32_t a = (alpha + 4) >> 3;
+  for (int c = 0; c < 3; c++) {
+    int32_t b = (bg >> shift[c]) & mask[c], f = (fg >> shift[c]) & mask[c];
+    int32_t want = (f * a + b * (32 - a)) / 32;
+    if (abs(want - ((got >> shift[c]) & mask[c])) > 1)
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  for (int i = 0; i < 64 * 48; i++)
+    image[i] = (uint16_t)(i * 2654435761u >> 7);
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  // Rectangles read back as drawn, including parts hanging off screen
+  uint32_t failures = 0;
+  std::vector<uint16_t> got(64 * 48);
+  for (int bits = 16; bits <= 18; bits += 2) {
+    tft.setColorDepth(bits);
+    for (uint8_t rot = 0; rot < 4; rot++) {
+      tft.setRotation(rot);
+      static const int16_t at[][2] = {{10, 20}, {-20, -10}, {200, 290}};
+      for (int p = 0; p < 3; p++) {
+        int16_t x = at[p][0], y = at[p][1];
+        if (rot & 1) {
+          x = at[p][1];
+          y = at[p][0];
+        }
+        tft.fillScreen(ST77XX_BLACK);
+        tft.drawRGBBitmap(x, y, image, 64, 48);
+        std::fill(got.begin(), got.end(), 0x1234);
+        tft.readRect(x, y, 64, 48, got.data());
+        uint32_t diff = 0;
+        for (int16_t j = 0; j < 48; j++)
+          for (int16_t i = 0; i < 64; i++) {
+            bool on = (x + i >= 0) && (x + i < tft.width()) && (y + j >= 0) &&
+                      (y + j < tft.height());
+            diff += got[j * 64 + i] != (on ? image[j * 64 + i] : 0x1234);
+          }
+        int16_t px = (x > 0 ? x : 0) + 1, py = (y > 0 ? y : 0) + 1;
+        if (tft.readPixel(px, py) != image[(py - y) * 64 + px - x])
+          diff++;
+        if (diff)
+          printf("  %d-bit, rotation %u, at %d,%d: %u pixels differ\n", bits,
+                 rot, x, y, diff);
+        failures += diff != 0;
+      }
+    }
+  }
+  tft.setColorDepth(16);
+  tft.setRotation(0);
+
+  // Full screen read, and a translucent overlay on a photo-like background
+  std::vector<uint16_t> screen(240 * 320), before(64 * 48);
+  ST77xxEmulator::Stats s0 = emu.stats();
+  uint32_t t0 = micros();
+  tft.readRect(0, 0, 240, 320, screen.data());
+  uint32_t us = micros() - t0;
+  ST77xxEmulator::Stats s = emu.stats().since(s0);
+  printf("readRect, full screen: %u bytes read, %u bus bytes, %.2f ms\n",
+         s.readBytes, s.busBytes(), us / 1000.0);
+
+  static const uint8_t alphas[] = {0, 3, 64, 128, 200, 255};
+  for (unsigned k = 0; k < sizeof(alphas); k++) {
+    tft.drawRGBBitmap(40, 60, image, 64, 48);
+    tft.readRect(40, 60, 64, 48, before.data());
+    s0 = emu.stats();
+    t0 = micros();
+    tft.blendRect(40, 60, 64, 48, ST77XX_ORANGE, alphas[k]);
+    us = micros() - t0;
+    s = emu.stats().since(s0);
+    tft.readRect(40, 60, 64, 48, got.data());
+    uint32_t diff = 0;
+    for (int i = 0; i < 64 * 48; i++)
+      diff += !near(got[i], before[i], ST77XX_ORANGE, alphas[k]);
+    printf("blendRect 64x48, alpha %3u: %6u bus bytes, %.2f ms\n", alphas[k],
+           s.busBytes(), us / 1000.0);
+    if (diff)
+      printf("  %u pixels off\n", diff);
+    failures += diff != 0;
+  }
+
+  // Screenshot, bottom-up 24-bit rows, against what the glass shows
+  for (int i = 0; i < 12; i++)
+    tft.fillRect(i * 20, i * 26, 60, 40, image[i * 97]);
+  tft.drawRGBBitmap(100, 200, image, 64, 48);
+  MemoryPrint bmp;
+  s0 = emu.stats();
+  t0 = micros();
+  bool ok = tft.writeBMP(bmp);
+  us = micros() - t0;
+  s = emu.stats().since(s0);
+  printf("writeBMP: %u bytes, %u bus bytes, %.2f ms\n",
+         (unsigned)bmp.data.size(), s.busBytes(), us / 1000.0);
+  std::vector<uint8_t> glass;
+  emu.render(glass);
+  uint32_t rowBytes = (240 * 3 + 3) & ~3;
+  uint32_t diff = 0;
+  if (!ok || (bmp.data.size() != 54 + rowBytes * 320) ||
+      (get32(bmp.data, 18) != 240) || (get32(bmp.data, 22) != 320)) {
+    printf("  bad BMP\n");
+    diff = 1;
+  } else {
+    for (uint32_t y = 0; y < 320; y++)
+      for (uint32_t x = 0; x < 240; x++) {
+        const uint8_t *p = &bmp.data[54 + (319 - y) * rowBytes + x * 3];
+        const uint8_t *q = &glass[(y * 240 + x) * 3];
+        diff += (p[2] != q[0]) || (p[1] != q[1]) || (p[0] != q[2]);
+      }
+    if (diff)
+      printf("  %u pixels differ from the glass\n", diff);
+  }
+  failures += diff != 0;
+  if (ok && (argc > 1)) {
+    FILE *f = fopen(argv[1], "wb");
+    if (f) {
+      fwrite(bmp.data.data(), 1, bmp.data.size(), f);
+      fclose(f);
+    }
+  }
+
+  printf("%s\n", failures ? "MISMATCH" : "All reads match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+// Draw flat-color UI art three ways and compare them: drawRGBBitmap() from
+// a flash array (pixel by pixel), drawRGBBitmap() from RAM (one window) and
+// drawRLEBitmap(). Reports the array sizes and the bus traffic of each, and
+// checks that the RLE image matches, also clipped at every screen edge and
+// at 12-bit color depth.
+//
+//   st77xx_rle [image.ppm]
+//
+// Without an image, a generated mock-up of a settings screen is used.
+
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <ST77xxRLE.h>
+#include <stdio.h>
+
+static void drawMockup(GFXcanvas16 &c) {
+  c.fillScreen(0x2104);
+  c.fillRect(0, 0, c.width(), 24, ST77XX_BLUE);
+  c.setCursor(6, 8);
+  c.setTextColor(ST77XX_WHITE);
+  c.print("Settings");
+  for (int16_t i = 0; i < 4; i++) {
+    int16_t y = 34 + i * 34;
+    c.fillRoundRect(8, y, c.width() - 16, 28, 6, 0x4208);
+    c.setCursor(16, y + 10);
+    c.setTextColor(ST77XX_WHITE);
+    c.print(i & 1 ? "Brightness" : "Sleep after");
+    c.fillRoundRect(c.width() - 58, y + 7, 40, 14, 7,
+                    (i & 1) ? ST77XX_GREEN : 0x8410);
+    c.fillCircle((i & 1) ? c.width() - 26 : c.width() - 50, y + 14, 5,
+                 ST77XX_WHITE);
+  }
+}
+
+int main(int argc, char **argv) {
+  std::vector<uint16_t> pixels;
+  uint16_t w = 200, h = 176;
+  if (argc > 1) {
+    std::vector<uint8_t> rgb;
+    if (!ST77xxEmulator::readPPM(argv[1], rgb, w, h)) {
+      fprintf(stderr, "could not read %s\n", argv[1]);
+      return 2;
+    }
+    pixels.resize((size_t)w * h);
+    for (size_t i = 0; i < pixels.size(); i++) {
+      const uint8_t *p = &rgb[i * 3];
+      pixels[i] = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+    }
+  } else {
+    GFXcanvas16 canvas(w, h);
+    drawMockup(canvas);
+    pixels.assign(canvas.getBuffer(), canvas.getBuffer() + (size_t)w * h);
+  }
+  std::vector<uint8_t> rle = ST77xxRLE::encode(pixels.data(), pixels.size());
+  printf("%ux%u image: %u bytes as RGB565, %u RLE-encoded (%.1fx smaller)\n",
+         w, h, (unsigned)pixels.size() * 2, (unsigned)rle.size(),
+         pixels.size() * 2.0 / rle.size());
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  // Bus traffic of each way, fully on screen
+  static const char *const ways[] = {"drawRGBBitmap(flash)",
+                                     "drawRGBBitmap(RAM)", "drawRLEBitmap"};
+  for (int way = 0; way < 3; way++) {
+    tft.fillScreen(ST77XX_BLACK);
+    ST77xxEmulator::Stats s0 = emu.stats();
+    uint32_t t0 = micros();
+    if (way == 0)
+      tft.drawRGBBitmap(20, 40, (const uint16_t *)pixels.data(), w, h);
+    else if (way == 1)
+      tft.drawRGBBitmap(20, 40, pixels.data(), w, h);
+    else
+      tft.drawRLEBitmap(20, 40, rle.data(), w, h);
+    uint32_t us = micros() - t0;
+    ST77xxEmulator::Stats s = emu.stats().since(s0);
+    printf("  %-22s %7u bus bytes, %5u commands, %6u us\n", ways[way],
+           s.busBytes(), s.commands, us);
+  }
+
+  // Same frame as the RAM bitmap, wherever the image is clipped
+  static const int16_t places[][2] = {
+      {20, 40}, {-50, 40}, {100, 40}, {20, -60}, {20, 250},
+      {-70, -90}, {150, 260}, {-300, 0}, {0, 400}};
+  uint32_t failures = 0;
+  for (int bits = 16; bits >= 12; bits -= 4) {
+    tft.setColorDepth(bits);
+    for (size_t i = 0; i < sizeof(places) / sizeof(places[0]); i++) {
+      int16_t x = places[i][0], y = places[i][1];
+      std::vector<uint8_t> want, got;
+      tft.fillScreen(ST77XX_BLACK);
+      tft.drawRGBBitmap(x, y, pixels.data(), w, h);
+      emu.render(want);
+      tft.fillScreen(ST77XX_BLACK);
+      tft.drawRLEBitmap(x, y, rle.data(), w, h);
+      emu.render(got);
+      uint32_t diff = ST77xxEmulator::diffImages(want, got);
+      if (diff)
+        printf("  %d-bit at (%d, %d): %u pixels differ\n", bits, x, y, diff);
+      failures += diff != 0;
+    }
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All placements match");
+  return failures ? 1 : 0;
+}
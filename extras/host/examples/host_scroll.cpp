@@ -0,0 +1,178 @@
+// Hardware scrolling with setScrollMargins(), scrollTo() and scrollLines(),
+// in every rotation of the 128x160 and 80x160 ST7735 and the 240x240
+// ST7789, whose GRAM offsets differ from rotation to rotation. Each
+// scrolled frame is checked against a second display that never scrolls,
+// with the expected picture drawn on it directly, so the TFA/VSA/BFA and
+// start address math is checked through the emulated glass.
+//
+//   st77xx_scroll
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint32_t failures = 0;
+
+// A picture in drawing coordinates, every pixel distinct
+static void pattern(std::vector<uint16_t> &img, int16_t w, int16_t h) {
+  img.resize((size_t)w * h);
+  for (int16_t y = 0; y < h; y++)
+    for (int16_t x = 0; x < w; x++)
+      img[(size_t)y * w + x] = (uint16_t)((x << 8) | y) ^ 0x5A5A;
+}
+
+// Line i along the scroll axis of img, copied to line j of out
+static void copyLine(std::vector<uint16_t> &out,
+                     const std::vector<uint16_t> &img, int16_t w, int16_t h,
+                     bool alongX, int32_t i, int32_t j) {
+  if (alongX)
+    for (int16_t y = 0; y < h; y++)
+      out[(size_t)y * w + j] = img[(size_t)y * w + i];
+  else
+    for (int16_t x = 0; x < w; x++)
+      out[(size_t)j * w + x] = img[(size_t)i * w + x];
+}
+
+// The scrolled display's glass against the reference showing model
+static void check(const char *what, ST77xxEmulator &emu, Adafruit_ST77xx &ref,
+                  ST77xxEmulator &refEmu, const std::vector<uint16_t> &model) {
+  std::vector<uint8_t> want, got;
+  ref.drawRGBBitmap(0, 0, model.data(), ref.width(), ref.height());
+  refEmu.render(want);
+  emu.render(got);
+  uint32_t diff = ST77xxEmulator::diffImages(want, got);
+  if (diff)
+    printf("  %s: %u pixels differ\n", what, diff);
+  failures += diff != 0;
+}
+
+// Scroll in each rotation with a few sets of margins
+static void sweep(const char *name, Adafruit_ST77xx &tft, ST77xxEmulator &emu,
+                  Adafruit_ST77xx &ref, ST77xxEmulator &refEmu) {
+  static const uint16_t margins[][2] = {{0, 0}, {10, 20}, {7, 0}, {0, 13}};
+  uint32_t before = failures, checks = 0;
+  char what[96];
+  for (uint8_t rot = 0; rot < 4; rot++) {
+    // The 80x160's offsets reach different GRAM in each rotation; blank it
+    // all so lines outside this rotation's window scroll in alike on both
+    for (uint8_t r = 0; r < 4; r++) {
+      tft.setRotation(r);
+      ref.setRotation(r);
+      tft.fillScreen(0);
+      ref.fillScreen(0);
+    }
+    tft.setRotation(rot);
+    ref.setRotation(rot);
+    int16_t w = tft.width(), h = tft.height();
+    bool alongX = rot & 1; // The scan axis is x when rows and columns swap
+    int32_t len = alongX ? w : h;
+    std::vector<uint16_t> img, model;
+    pattern(img, w, h);
+    for (auto &m : margins) {
+      int32_t top = m[0], vsa = len - m[0] - m[1];
+      tft.drawRGBBitmap(0, 0, img.data(), w, h);
+      tft.setScrollMargins(m[0], m[1]);
+
+      // Absolute positions: line p shown first in the area
+      static const int32_t steps[] = {0, 1, 5, -1, -17, 33};
+      for (int32_t k : steps) {
+        int32_t off = ((k % vsa) + vsa) % vsa;
+        tft.scrollTo(top + off);
+        model = img;
+        for (int32_t i = 0; i < vsa; i++)
+          copyLine(model, img, w, h, alongX, top + (i + off) % vsa, top + i);
+        snprintf(what, sizeof(what), "%s rotation %u, margins %u/%u, "
+                 "scrollTo(%d)", name, rot, m[0], m[1], (int)(top + off));
+        check(what, emu, ref, refEmu, model);
+        checks++;
+        if (tft.getScrollPosition() != top + off) {
+          printf("  %s: getScrollPosition() is %u\n", what,
+                 tft.getScrollPosition());
+          failures++;
+        }
+      }
+
+      // Relative scrolls that clear the exposed lines, as a log does. The
+      // return is where to draw the new lines: in drawing coordinates,
+      // which scroll with the content
+      tft.scrollTo(top);
+      model = img;
+      int32_t off = 0; // Scroll offset within the area
+      static const int16_t moves[] = {6, 11, -4, 25};
+      for (int16_t n : moves) {
+        std::vector<uint16_t> prev = model;
+        uint16_t color = 0x1000 + n * 37;
+        int16_t first = tft.scrollLines(n, color);
+        int32_t next = ((off + n) % vsa + vsa) % vsa;
+        int32_t want = top + ((n > 0) ? off : next);
+        off = next;
+        int32_t a = (n < vsa) ? n : vsa, b = (-n < vsa) ? -n : vsa;
+        for (int32_t i = 0; i < vsa; i++) {
+          int32_t from = (n > 0) ? i + a : i - b;
+          if ((from >= 0) && (from < vsa))
+            copyLine(model, prev, w, h, alongX, top + from, top + i);
+          else if (alongX)
+            for (int16_t y = 0; y < h; y++)
+              model[(size_t)y * w + top + i] = color;
+          else
+            for (int16_t x = 0; x < w; x++)
+              model[(size_t)(top + i) * w + x] = color;
+        }
+        snprintf(what, sizeof(what), "%s rotation %u, margins %u/%u, "
+                 "scrollLines(%d)", name, rot, m[0], m[1], n);
+        check(what, emu, ref, refEmu, model);
+        checks++;
+        if (first != want) {
+          printf("  %s: returned %d, not %d\n", what, first, (int)want);
+          failures++;
+        }
+      }
+    }
+  }
+  printf("%-18s %3u scrolled frames, %s\n", name, checks,
+         (failures == before) ? "all match" : "MISMATCH");
+}
+
+int main(void) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7735;
+  {
+    ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c, 128, 160)),
+        refEmu(c, ST77xxEmulator::defaultPanel(c, 128, 160));
+    ST77xxHost::attach(&emu, 10, 8, 9);
+    ST77xxHost::attach(&refEmu, 11, 7, 6);
+    Adafruit_ST7735 tft(10, 8, 9), ref(11, 7, 6);
+    tft.initR(INITR_GREENTAB);
+    ref.initR(INITR_GREENTAB);
+    sweep("ST7735 128x160", tft, emu, ref, refEmu);
+    ST77xxHost::detachAll();
+  }
+  {
+    ST77xxEmulator::Panel mini =
+        ST77xxEmulator::Panel::fromOffsets(132, 162, 80, 160, 24, 0, true,
+                                           true, false);
+    ST77xxEmulator emu(c, mini), refEmu(c, mini);
+    ST77xxHost::attach(&emu, 10, 8, 9);
+    ST77xxHost::attach(&refEmu, 11, 7, 6);
+    Adafruit_ST7735 tft(10, 8, 9), ref(11, 7, 6);
+    tft.initR(INITR_MINI160x80);
+    ref.initR(INITR_MINI160x80);
+    sweep("ST7735 80x160", tft, emu, ref, refEmu);
+    ST77xxHost::detachAll();
+  }
+  c = ST77xxEmulator::ST7789;
+  {
+    ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c, 240, 240)),
+        refEmu(c, ST77xxEmulator::defaultPanel(c, 240, 240));
+    ST77xxHost::attach(&emu, 10, 8, 9);
+    ST77xxHost::attach(&refEmu, 11, 7, 6);
+    Adafruit_ST7789 tft(10, 8, 9), ref(11, 7, 6);
+    tft.init(240, 240);
+    ref.init(240, 240);
+    sweep("ST7789 240x240", tft, emu, ref, refEmu);
+    ST77xxHost::detachAll();
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All scrolled frames match");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+// Draw filled circles, rounded rectangles and triangles with the generic
+// Adafruit_GFX code and with the span-based Adafruit_ST77xx overrides.
+// Reports the bus bytes, address window commands and time of each, and
+// checks that the frames match, with shapes clipped at every screen edge,
+// degenerate triangles, and at 12-bit color depth.
+//
+//   st77xx_spans [shapes]
+
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SHAPE_CIRCLE 0
+#define SHAPE_ROUNDRECT 1
+#define SHAPE_TRIANGLE 2
+
+// Triangles the random set seldom makes: flat tops and bottoms, one row,
+// one column, one pixel, a sliver, and corners far off screen
+#define EDGE_TRIANGLES 10
+
+static void edgeTriangle(Adafruit_ST7789 &tft, uint32_t i, bool spans) {
+  int16_t w = tft.width(), h = tft.height();
+  const int16_t c[EDGE_TRIANGLES][6] = {
+      {10, 10, 0, 50, 40, 50},
+      {0, 10, 40, 10, 20, 60},
+      {5, 30, 60, 30, -10, 30},
+      {30, 0, 30, 80, 30, 40},
+      {50, 50, 50, 50, 50, 50},
+      {100, 0, 101, (int16_t)(h - 1), 100, (int16_t)(h - 1)},
+      {20, -100, -50, 20, 100, 30},
+      {20, (int16_t)(h + 5), 0, (int16_t)(h - 10), w, (int16_t)(h + 60)},
+      {-3000, -2000, (int16_t)(w + 3000), (int16_t)(h / 2), (int16_t)(w / 2),
+       (int16_t)(h + 4000)},
+      {-20, -20, -5, -40, -30, -1},
+  };
+  uint16_t color = 0x1234 + i * 0x0841;
+  if (spans)
+    tft.fillTriangle(c[i][0], c[i][1], c[i][2], c[i][3], c[i][4], c[i][5],
+                     color);
+  else
+    tft.Adafruit_GFX::fillTriangle(c[i][0], c[i][1], c[i][2], c[i][3],
+                                   c[i][4], c[i][5], color);
+}
+
+// Shape i of a reproducible set, drawn the generic way or with spans.
+// Corners fall up to 40 pixels off screen, so many shapes are clipped.
+static void drawShape(Adafruit_ST7789 &tft, int shape, uint32_t i,
+                      bool spans) {
+  srand(i * 7919 + shape);
+  int16_t w = tft.width(), h = tft.height();
+  int16_t x = rand() % (w + 80) - 40, y = rand() % (h + 80) - 40;
+  uint16_t color = rand();
+  if (shape == SHAPE_CIRCLE) {
+    int16_t r = rand() % 60;
+    if (spans)
+      tft.fillCircle(x, y, r, color);
+    else
+      tft.Adafruit_GFX::fillCircle(x, y, r, color);
+  } else if (shape == SHAPE_ROUNDRECT) {
+    int16_t rw = 1 + rand() % 120, rh = 1 + rand() % 120, r = rand() % 30;
+    if (spans)
+      tft.fillRoundRect(x, y, rw, rh, r, color);
+    else
+      tft.Adafruit_GFX::fillRoundRect(x, y, rw, rh, r, color);
+  } else {
+    int16_t x1 = rand() % (w + 80) - 40, y1 = rand() % (h + 80) - 40,
+            x2 = rand() % (w + 80) - 40, y2 = rand() % (h + 80) - 40;
+    if (spans)
+      tft.fillTriangle(x, y, x1, y1, x2, y2, color);
+    else
+      tft.Adafruit_GFX::fillTriangle(x, y, x1, y1, x2, y2, color);
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t shapes = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200;
+
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+
+  static const char *const names[] = {"fillCircle", "fillRoundRect",
+                                      "fillTriangle"};
+  uint32_t failures = 0;
+  for (int shape = 0; shape < 3; shape++) {
+    printf("%u x %s:\n", shapes, names[shape]);
+    for (int spans = 0; spans < 2; spans++) {
+      tft.fillScreen(ST77XX_BLACK);
+      ST77xxEmulator::Stats s0 = emu.stats();
+      uint32_t t0 = micros();
+      for (uint32_t i = 0; i < shapes; i++)
+        drawShape(tft, shape, i, spans);
+      uint32_t us = micros() - t0;
+      ST77xxEmulator::Stats s = emu.stats().since(s0);
+      printf("  %-8s %8u bus bytes, %6u CASET, %6u RASET, %6u RAMWR, "
+             "%8.2f ms\n",
+             spans ? "spans" : "GFX", s.busBytes(), s.opcodes[ST77XX_CASET],
+             s.opcodes[ST77XX_RASET], s.opcodes[ST77XX_RAMWR], us / 1000.0);
+    }
+
+    // Same frame both ways, in every rotation and at 12 bits
+    for (int bits = 16; bits >= 12; bits -= 4) {
+      tft.setColorDepth(bits);
+      for (uint8_t rot = 0; rot < 4; rot++) {
+        tft.setRotation(rot);
+        std::vector<uint8_t> want, got;
+        for (int spans = 0; spans < 2; spans++) {
+          tft.fillScreen(ST77XX_BLACK);
+          for (uint32_t i = 0; i < shapes; i++)
+            drawShape(tft, shape, i, spans);
+          emu.render(spans ? got : want);
+        }
+        uint32_t diff = ST77xxEmulator::diffImages(want, got);
+        if (diff)
+          printf("  %d-bit, rotation %u: %u pixels differ\n", bits, rot,
+                 diff);
+        failures += diff != 0;
+      }
+    }
+    tft.setColorDepth(16);
+    tft.setRotation(0);
+  }
+  // Each edge case on its own, so no other shape covers a wrong pixel
+  uint32_t before = failures;
+  for (int bits = 16; bits >= 12; bits -= 4) {
+    tft.setColorDepth(bits);
+    for (uint8_t rot = 0; rot < 4; rot++) {
+      tft.setRotation(rot);
+      for (uint32_t i = 0; i < EDGE_TRIANGLES; i++) {
+        std::vector<uint8_t> want, got;
+        for (int spans = 0; spans < 2; spans++) {
+          tft.fillScreen(ST77XX_BLACK);
+          edgeTriangle(tft, i, spans);
+          emu.render(spans ? got : want);
+        }
+        uint32_t diff = ST77xxEmulator::diffImages(want, got);
+        if (diff)
+          printf("  %d-bit, rotation %u, edge triangle %u: %u pixels "
+                 "differ\n",
+                 bits, rot, i, diff);
+        failures += diff != 0;
+      }
+    }
+  }
+  tft.setColorDepth(16);
+  tft.setRotation(0);
+  printf("%u edge triangles: %s\n", EDGE_TRIANGLES,
+         (failures == before) ? "all match" : "MISMATCH");
+
+  printf("%s\n", failures ? "MISMATCH" : "All frames match");
+  return failures ? 1 : 0;
+}
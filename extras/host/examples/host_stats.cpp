@@ -0,0 +1,134 @@
+// Bus statistics and tracing, with the driver built with ST77XX_STATS.
+// Draws a small dashboard and checks the driver's own counts of commands,
+// opcodes, windows, pixel bytes, transactions and CS edges against what
+// the emulator saw on the bus, and the trace events against the counts.
+// Then draws a status box the right way and pixel by pixel, as a widget
+// that regressed would, to show how the counters give it away. Exits with
+// 2 if the driver was built without ST77XX_STATS.
+//
+//   st77xx_stats
+
+#include <Adafruit_ST7789.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint32_t traced[3], tracedBytes[3];
+
+static void trace(uint8_t event, uint8_t cmd, uint32_t bytes, uint32_t us) {
+  (void)cmd;
+  (void)us;
+  traced[event]++;
+  tracedBytes[event] += bytes;
+}
+
+static void dashboard(Adafruit_ST7789 &tft) {
+  static uint16_t icon[24 * 24];
+  for (int i = 0; i < 24 * 24; i++)
+    icon[i] = ((i % 24) ^ (i / 24)) & 4 ? ST77XX_ORANGE : ST77XX_BLUE;
+  tft.fillScreen(ST77XX_BLACK);
+  tft.fillRect(0, 0, tft.width(), 28, ST77XX_BLUE);
+  tft.setTextSize(2);
+  tft.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+  tft.setCursor(6, 6);
+  tft.print("Bus stats");
+  for (int i = 0; i < 4; i++) {
+    tft.fillRoundRect(8, 40 + i * 60, tft.width() - 16, 50, 6, 0x2104);
+    tft.fillRect(16, 60 + i * 60, (i + 1) * 40, 10, ST77XX_GREEN);
+    tft.drawRGBBitmap(tft.width() - 40, 53 + i * 60, icon, 24, 24);
+  }
+  tft.fillCircle(tft.width() / 2, tft.height() - 20, 12, ST77XX_RED);
+  tft.drawPixel(0, tft.height() - 1, ST77XX_YELLOW);
+}
+
+// Counters of interest, as the driver saw them
+static void report(const char *name, const ST77xxBusStats &s) {
+  printf("%-14s %5u commands, %4u windows (%4u CASET/RASET), %6u pixel "
+         "bytes\n",
+         name, s.commands, s.windows, s.windowCommands, s.pixelBytes);
+  printf("%-14s %5u transactions, %.2f ms; %.2f ms opening windows, %.2f "
+         "ms sending pixels\n",
+         "", s.transactions, s.transactionUs / 1000.0, s.windowUs / 1000.0,
+         s.pixelUs / 1000.0);
+}
+
+int main(void) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+  Adafruit_ST7789 tft(10, 8, 9);
+  ST77xxHost::attach(&emu, 10, 8, 9);
+  tft.init(240, 320);
+  uint32_t failures = 0;
+  static ST77xxBusStats stats;
+  if (!tft.setBusStats(&stats)) {
+    printf("The driver was built without ST77XX_STATS\n");
+    return 2;
+  }
+
+  // The driver's counts against the bus, over init plus a frame at each
+  // color depth
+  ST77xxEmulator::Stats e0 = emu.stats();
+  stats.trace = trace;
+  tft.resetBusStats();
+  for (int bits = 16; bits >= 12; bits -= 2) {
+    tft.setColorDepth(bits);
+    dashboard(tft);
+  }
+  tft.setColorDepth(16);
+  stats.trace = NULL;
+  ST77xxEmulator::Stats e = emu.stats().since(e0);
+  const ST77xxBusStats &s = stats;
+  report("dashboard x3", s);
+
+  uint32_t opcodeDiffs = 0;
+  for (int op = 0; op < ST77XX_STATS_OPCODES; op++) {
+    if (s.opcodes[op])
+      printf("%14s %5u %s\n", "", s.opcodes[op],
+             ST77xxEmulator::commandName(op));
+    opcodeDiffs += s.opcodes[op] != e.opcodes[op];
+  }
+  struct {
+    const char *what;
+    uint32_t driver, bus;
+  } checks[] = {
+      {"commands", s.commands, e.commands},
+      {"CASET/RASET", s.windowCommands,
+       e.opcodes[ST77XX_CASET] + e.opcodes[ST77XX_RASET]},
+      {"RAMWR", s.windows, e.opcodes[ST77XX_RAMWR]},
+      {"pixel bytes", s.pixelBytes, e.pixelBytes},
+      {"transactions", s.transactions, e.csAssertions},
+      {"CS edges", s.csToggles, e.csAssertions * 2},
+      {"traced commands", traced[ST77XX_TRACE_COMMAND], s.commands},
+      {"traced windows", traced[ST77XX_TRACE_WINDOW], s.windows},
+      {"flushed bytes", tracedBytes[ST77XX_TRACE_FLUSH], s.pixelBytes},
+      {"opcodes that differ", opcodeDiffs, 0},
+  };
+  for (unsigned i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+    bool ok = checks[i].driver == checks[i].bus;
+    if (!ok)
+      printf("  %s: driver %u, bus %u\n", checks[i].what, checks[i].driver,
+             checks[i].bus);
+    failures += !ok;
+  }
+
+  // A status box drawn as one fill, and pixel by pixel
+  for (int way = 0; way < 2; way++) {
+    tft.resetBusStats();
+    if (way) {
+      tft.startWrite();
+      for (int16_t y = 100; y < 140; y++)
+        for (int16_t x = 40; x < 200; x++)
+          tft.writePixel(x, y, ST77XX_CYAN);
+      tft.endWrite();
+    } else {
+      tft.fillRect(40, 100, 160, 40, ST77XX_CYAN);
+    }
+    const ST77xxBusStats &b = stats;
+    report(way ? "box, per pixel" : "box, one fill", b);
+    printf("%-14s %.1f pixel bytes per window\n", "",
+           b.windows ? (double)b.pixelBytes / b.windows : 0.0);
+  }
+
+  printf("%s\n", failures ? "MISMATCH" : "All counts match the bus");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+// Banded drawing with Adafruit_ST77xxStrip against the same scene drawn
+// straight to a second display, in every rotation of the 128x160 ST7735
+// and the 240x320 ST7789, with strip heights that do and don't divide the
+// screen. The scene puts lines, rectangles, circles and text across strip
+// edges and off the screen's edges, where clipping to a strip could go
+// wrong. Each frame must also send every pixel exactly once.
+//
+//   st77xx_strip
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxStrip.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint32_t failures = 0;
+static int16_t rows; // Strip height, so the scene can straddle its edges
+
+static void scene(Adafruit_GFX &gfx) {
+  int16_t w = gfx.width(), h = gfx.height();
+  gfx.fillScreen(ST77XX_BLACK);
+  // One pixel either side of each of the first few strip edges
+  for (int16_t e = rows; e < 4 * rows; e += rows) {
+    gfx.drawPixel(e % w, e - 1, ST77XX_WHITE);
+    gfx.drawPixel(e % w + 1, e, ST77XX_YELLOW);
+    gfx.drawFastHLine(0, e, w / 3, ST77XX_CYAN);
+  }
+  gfx.fillRect(4, rows - 3, w / 2, 7, ST77XX_BLUE);
+  gfx.fillRect(w - 20, -5, 30, 2 * rows + 3, ST77XX_MAGENTA); // Off the edges
+  gfx.fillRect(w / 2, h - 6, -15, 10, ST77XX_ORANGE);         // Negative w
+  gfx.drawRect(2, 2, w - 4, h - 4, ST77XX_GREEN);
+  gfx.drawLine(0, 0, w - 1, h - 1, ST77XX_RED);
+  gfx.drawLine(w - 1, 0, 0, h - 1, ST77XX_WHITE);
+  gfx.drawFastVLine(w / 3, -10, h + 20, ST77XX_YELLOW);
+  gfx.fillCircle(w / 2, 2 * rows, rows + 5, ST77XX_RED);
+  gfx.drawCircle(w / 4, h / 2, h / 5, ST77XX_CYAN);
+  gfx.fillCircle(-5, h - 10, 20, ST77XX_GREEN);
+  gfx.setTextSize(3);
+  gfx.setTextColor(ST77XX_WHITE, ST77XX_BLUE);
+  gfx.setCursor(6, 3 * rows - 10);
+  gfx.print("12:34");
+}
+
+static void render(Adafruit_ST77xxStrip &gfx) { scene(gfx); }
+
+static void sweep(const char *name, Adafruit_ST77xx &tft, ST77xxEmulator &emu,
+                  Adafruit_ST77xx &ref, ST77xxEmulator &refEmu,
+                  int16_t stripRows) {
+  Adafruit_ST77xxStrip strip(tft, stripRows);
+  if (!strip.begin()) {
+    printf("%s: no memory for the strip\n", name);
+    failures++;
+    return;
+  }
+  rows = stripRows;
+  for (uint8_t rot = 0; rot < 4; rot++) {
+    tft.setRotation(rot);
+    ref.setRotation(rot);
+    ST77xxEmulator::Stats e0 = emu.stats();
+    uint32_t sent = strip.draw(render, ST77XX_BLACK);
+    ST77xxEmulator::Stats e = emu.stats().since(e0);
+    scene(ref);
+
+    std::vector<uint8_t> want, got;
+    refEmu.render(want);
+    emu.render(got);
+    uint32_t diff = ST77xxEmulator::diffImages(want, got);
+    uint32_t pixels = (uint32_t)tft.width() * tft.height();
+    uint16_t strips = (tft.height() + stripRows - 1) / stripRows;
+    bool ok = !diff && (e.pixelBytes == pixels * 2) &&
+              (e.opcodes[ST77XX_RAMWR] == strips) &&
+              (strip.getStripCount() == strips) && (e.busBytes() <= sent);
+    printf("%-16s %2u-row strips, rotation %u: %2u strips, %6u pixel "
+           "bytes, %6u bus bytes%s\n",
+           name, stripRows, rot, strip.getStripCount(), e.pixelBytes,
+           e.busBytes(), ok ? "" : "  MISMATCH");
+    if (diff)
+      printf("  %u pixels differ from drawing directly\n", diff);
+    failures += !ok;
+  }
+}
+
+int main(void) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7735;
+  {
+    ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c, 128, 160)),
+        refEmu(c, ST77xxEmulator::defaultPanel(c, 128, 160));
+    ST77xxHost::attach(&emu, 10, 8, 9);
+    ST77xxHost::attach(&refEmu, 11, 7, 6);
+    Adafruit_ST7735 tft(10, 8, 9), ref(11, 7, 6);
+    tft.initR(INITR_GREENTAB);
+    ref.initR(INITR_GREENTAB);
+    sweep("ST7735 128x160", tft, emu, ref, refEmu, 16);
+    sweep("ST7735 128x160", tft, emu, ref, refEmu, 7);
+    ST77xxHost::detachAll();
+  }
+  c = ST77xxEmulator::ST7789;
+  {
+    ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c, 240, 320)),
+        refEmu(c, ST77xxEmulator::defaultPanel(c, 240, 320));
+    ST77xxHost::attach(&emu, 10, 8, 9);
+    ST77xxHost::attach(&refEmu, 11, 7, 6);
+    Adafruit_ST7789 tft(10, 8, 9), ref(11, 7, 6);
+    tft.init(240, 320);
+    ref.init(240, 320);
+    sweep("ST7789 240x320", tft, emu, ref, refEmu, 16);
+    sweep("ST7789 240x320", tft, emu, ref, refEmu, 7);
+    ST77xxHost::detachAll();
+  }
+  printf("%s\n", failures ? "MISMATCH" : "All strips match direct drawing");
+  return failures ? 1 : 0;
+}
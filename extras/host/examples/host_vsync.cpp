@@ -0,0 +1,129 @@
+// Tear-free presents with Adafruit_ST77xxVSync on panels that show only a
+// band of the controller's GRAM rows: the 135x240, 240x280 and 240x240
+// ST7789 (rows 40-279, 20-299 and 0-239 of 320) and the 128x160 ST7735
+// (rows 1-160 of 162), through the TE pin and by polling the scanline.
+// Each present fills the screen, with the refresh period set so the flush
+// either fits in one period or takes longer. From the time each row's last
+// pixel byte went out, checks that every visible row first shows the new
+// frame in the same refresh. This runs in rotation 2, the one whose rows
+// are written in scan order; rotation 0 mirrors them (MADCTL MY), so its
+// writes run against the scan and cross it whenever they start.
+//
+//   st77xx_vsync
+
+#include <Adafruit_ST7735.h>
+#include <Adafruit_ST7789.h>
+#include <Adafruit_ST77xxVSync.h>
+#include <ST77xxHost.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TE_PIN 7
+
+static uint32_t failures = 0;
+static Adafruit_ST77xx *display;
+static uint16_t fill;
+
+static void flush(void *arg) {
+  (void)arg;
+  display->fillScreen(fill);
+}
+
+// Whether the refresh that first shows each visible row's new content,
+// from the captured fill, is the same for all of them
+static bool tearFree(ST77xxEmulator &emu, uint16_t w, uint16_t h) {
+  const std::vector<ST77xxEmulator::Event> &events = emu.capture();
+  size_t i = events.size();
+  while (i && !((events[i - 1].type == ST77xxEmulator::EVENT_COMMAND) &&
+                (events[i - 1].value == ST77XX_RAMWR)))
+    i--;
+  const ST77xxEmulator::Panel &p = emu.panel();
+  bool my = emu.madctl() & ST77XX_MADCTL_MY;
+  uint64_t period = emu.framePeriod();
+  uint32_t bytes = 0, first = 0, last = 0;
+  uint16_t row = 0;
+  for (; (i < events.size()) && (row < h); i++) {
+    if (events[i].type != ST77xxEmulator::EVENT_DATA)
+      continue;
+    if (++bytes < (uint32_t)(row + 1) * w * 2)
+      continue;
+    // The row is on the glass from the first scan of it after this byte
+    uint16_t gram = my ? p.y + p.height - 1 - row : p.y + row;
+    uint64_t scan = period * gram / emu.scanLines();
+    uint64_t ns = events[i].ns;
+    uint32_t pass = (uint32_t)((ns - scan) / period + 1);
+    if (!row)
+      first = last = pass;
+    first = (pass < first) ? pass : first;
+    last = (pass > last) ? pass : last;
+    row++;
+  }
+  return (row == h) && (first == last);
+}
+
+template <class Display>
+static void sweep(const char *name, Display &tft, ST77xxEmulator &emu,
+                  int8_t te) {
+  display = &tft;
+  tft.setRotation(2);
+  uint64_t t = ST77xxHost::nanos();
+  tft.fillScreen(ST77XX_BLACK);
+  uint64_t fillNs = ST77xxHost::nanos() - t;
+  // A period half again the flush, then one the flush overruns
+  static const uint16_t ratios[] = {150, 75};
+  for (uint16_t r : ratios) {
+    emu.setFramePeriod(fillNs * r / 100);
+    Adafruit_ST77xxVSync vsync(tft, te);
+    if (!vsync.begin()) {
+      printf("%s: no blanking period seen\n", name);
+      failures++;
+      return;
+    }
+    uint32_t torn = 0;
+    for (int n = 0; n < 6; n++) {
+      fill = (n & 1) ? ST77XX_BLUE : ST77XX_YELLOW;
+      emu.clearCapture();
+      emu.setCapture(true);
+      bool ok = vsync.present(flush, NULL, 500);
+      emu.setCapture(false);
+      // The first present has no flush time to go by yet
+      if (n && (!ok || !tearFree(emu, tft.width(), tft.height())))
+        torn++;
+    }
+    vsync.end();
+    printf("%-16s %-8s flush %3u%% of the period: %s\n", name,
+           (te >= 0) ? "TE pin" : "polling", 10000 / r,
+           torn ? "TORN" : "no tearing");
+    failures += torn;
+  }
+}
+
+int main(void) {
+  ST77xxEmulator::Controller c = ST77xxEmulator::ST7789;
+  static const uint16_t sizes[][2] = {{135, 240}, {240, 280}, {240, 240}};
+  static const int8_t pins[] = {TE_PIN, -1};
+  for (auto &s : sizes) {
+    char name[32];
+    snprintf(name, sizeof(name), "ST7789 %ux%u", s[0], s[1]);
+    for (int8_t te : pins) {
+      ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c, s[0], s[1]));
+      ST77xxHost::attach(&emu, 10, 8, 9);
+      ST77xxHost::attachTearing(&emu, TE_PIN);
+      Adafruit_ST7789 tft(10, 8, 9);
+      tft.init(s[0], s[1]);
+      sweep(name, tft, emu, te);
+      ST77xxHost::detachAll();
+    }
+  }
+  c = ST77xxEmulator::ST7735;
+  {
+    ST77xxEmulator emu(c, ST77xxEmulator::defaultPanel(c));
+    ST77xxHost::attach(&emu, 10, 8, 9);
+    Adafruit_ST7735 tft(10, 8, 9);
+    tft.initR(INITR_GREENTAB);
+    sweep("ST7735 128x160", tft, emu, -1);
+    ST77xxHost::detachAll();
+  }
+  printf("%s\n", failures ? "TORN" : "No present tore");
+  return failures ? 1 : 0;
+}
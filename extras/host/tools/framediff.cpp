@@ -0,0 +1,43 @@
+// Compare two frames rendered by the emulator (binary PPM).
+//
+//   st77xx_framediff expected.ppm actual.ppm [diff.ppm]
+//
+// Exits 0 when the frames match, 1 when they differ, 2 on error. When a
+// third file name is given, differing pixels are written out in red over a
+// dimmed copy of the expected frame.
+
+#include "ST77xxEmulator.h"
+#include <stdio.h>
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s expected.ppm actual.ppm [diff.ppm]\n",
+            argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> a, b, diff;
+  uint16_t aw, ah, bw, bh;
+  if (!ST77xxEmulator::readPPM(argv[1], a, aw, ah) ||
+      !ST77xxEmulator::readPPM(argv[2], b, bw, bh)) {
+    fprintf(stderr, "could not read input frames\n");
+    return 2;
+  }
+  if ((aw != bw) || (ah != bh)) {
+    printf("size mismatch: %ux%u vs %ux%u\n", aw, ah, bw, bh);
+    return 1;
+  }
+
+  uint32_t count = ST77xxEmulator::diffImages(a, b, &diff);
+  printf("%u of %u pixels differ\n", count, (unsigned)aw * ah);
+
+  if ((argc > 3) && count) {
+    FILE *f = fopen(argv[3], "wb");
+    if (f) {
+      fprintf(f, "P6\n%u %u\n255\n", aw, ah);
+      fwrite(diff.data(), 1, diff.size(), f);
+      fclose(f);
+    }
+  }
+  return count ? 1 : 0;
+}
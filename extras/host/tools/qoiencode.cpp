@@ -0,0 +1,84 @@
+// Convert an image (binary PPM) to QOI for Adafruit_ST77xx::drawQOI(),
+// either as a PROGMEM array in a C header on stdout or as a .qoi file to
+// put on an SD card.
+//
+//   st77xx_qoiencode image.ppm [name] > image.h
+//   st77xx_qoiencode image.ppm -o image.qoi
+//
+// Colors are rounded to 5-6-5 first, which changes nothing on the display
+// but makes the file smaller; --full keeps all 24 bits. Convert other
+// formats first, e.g. with ImageMagick: convert photo.jpg photo.ppm
+
+#include "ST77xxEmulator.h"
+#include "ST77xxQOI.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+int main(int argc, char **argv) {
+  const char *in = NULL, *out = NULL, *given = NULL;
+  bool to565 = true;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--full"))
+      to565 = false;
+    else if (!strcmp(argv[i], "-o") && (i + 1 < argc))
+      out = argv[++i];
+    else if (!in)
+      in = argv[i];
+    else
+      given = argv[i];
+  }
+  if (!in) {
+    fprintf(stderr,
+            "usage: %s image.ppm [--full] [name] > image.h\n"
+            "       %s image.ppm [--full] -o image.qoi\n",
+            argv[0], argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> rgb;
+  uint16_t w, h;
+  if (!ST77xxEmulator::readPPM(in, rgb, w, h)) {
+    fprintf(stderr, "could not read %s\n", in);
+    return 2;
+  }
+  std::vector<uint8_t> qoi = ST77xxQOI::encode(rgb.data(), w, h, to565);
+  fprintf(stderr, "%ux%u: %u bytes, %.1fx smaller than RGB565\n", w, h,
+          (unsigned)qoi.size(), w * h * 2.0 / qoi.size());
+
+  if (out) {
+    FILE *f = fopen(out, "wb");
+    if (!f || (fwrite(qoi.data(), 1, qoi.size(), f) != qoi.size())) {
+      fprintf(stderr, "could not write %s\n", out);
+      return 2;
+    }
+    fclose(f);
+    return 0;
+  }
+
+  // Array name: given, or the file name up to the extension
+  std::string name = given ? given : in;
+  if (!given) {
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos)
+      name = name.substr(slash + 1);
+    name = name.substr(0, name.find('.'));
+  }
+  for (size_t i = 0; i < name.size(); i++)
+    if (!isalnum((unsigned char)name[i]))
+      name[i] = '_';
+  if (name.empty() || isdigit((unsigned char)name[0]))
+    name = "image_" + name;
+
+  printf("// %s: %ux%u, %u bytes as QOI (%u as RGB565)\n", in, w, h,
+         (unsigned)qoi.size(), w * h * 2);
+  printf("// Draw with tft.drawQOI(x, y, %s, sizeof(%s));\n\n", name.c_str(),
+         name.c_str());
+  printf("const uint8_t %s[] PROGMEM = {", name.c_str());
+  for (size_t i = 0; i < qoi.size(); i++)
+    printf("%s0x%02X%s", (i % 12) ? " " : "\n    ", qoi[i],
+           (i + 1 < qoi.size()) ? "," : "");
+  printf("};\n");
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Convert an image (binary PPM) to a run-length encoded array for
+// Adafruit_ST77xx::drawRLEBitmap(), written as a C header on stdout.
+//
+//   st77xx_rleencode image.ppm [name] > image.h
+//
+// Colors are reduced to 5-6-5. Flat-color UI art typically shrinks 5-20x
+// compared with a raw RGB565 array. Convert other formats first, e.g. with
+// ImageMagick: convert icon.png icon.ppm
+
+#include "ST77xxEmulator.h"
+#include "ST77xxRLE.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s image.ppm [name] > image.h\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> rgb;
+  uint16_t w, h;
+  if (!ST77xxEmulator::readPPM(argv[1], rgb, w, h)) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 2;
+  }
+
+  // Array name: given, or the file name up to the extension
+  std::string name = (argc > 2) ? argv[2] : argv[1];
+  if (argc < 3) {
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos)
+      name = name.substr(slash + 1);
+    name = name.substr(0, name.find('.'));
+  }
+  for (size_t i = 0; i < name.size(); i++)
+    if (!isalnum((unsigned char)name[i]))
+      name[i] = '_';
+  if (name.empty() || isdigit((unsigned char)name[0]))
+    name = "image_" + name;
+  std::string upper = name;
+  for (size_t i = 0; i < upper.size(); i++)
+    upper[i] = toupper((unsigned char)upper[i]);
+
+  std::vector<uint16_t> pixels((size_t)w * h);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    const uint8_t *p = &rgb[i * 3];
+    pixels[i] = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+  }
+  std::vector<uint8_t> rle = ST77xxRLE::encode(pixels.data(), pixels.size());
+
+  printf("// %s: %ux%u, %u bytes run-length encoded (%u as RGB565)\n",
+         argv[1], w, h, (unsigned)rle.size(), (unsigned)pixels.size() * 2);
+  printf("// Draw with tft.drawRLEBitmap(x, y, %s, %s_WIDTH, %s_HEIGHT);\n\n",
+         name.c_str(), upper.c_str(), upper.c_str());
+  printf("#define %s_WIDTH %u\n", upper.c_str(), w);
+  printf("#define %s_HEIGHT %u\n\n", upper.c_str(), h);
+  printf("const uint8_t %s[] PROGMEM = {", name.c_str());
+  for (size_t i = 0; i < rle.size(); i++)
+    printf("%s0x%02X%s", (i % 12) ? " " : "\n    ", rle[i],
+           (i + 1 < rle.size()) ? "," : "");
+  printf("};\n");
+
+  fprintf(stderr, "%ux%u: %u bytes, %.1fx smaller than RGB565\n", w, h,
+          (unsigned)rle.size(), pixels.size() * 2.0 / rle.size());
+  return 0;
+}